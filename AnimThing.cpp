@@ -260,7 +260,7 @@ void CAnimThing::Render(void)
       m_sPriority = position.z;
 		
 		// Layer should be based on info we get from attribute map.
-      m_sLayer = CRealm::GetLayerViaAttrib(realm()->GetLayer(int16_t(position.x), int16_t(position.z)));
+      m_sLayer = CRealm::GetLayerViaAttrib(realm()->GetLayer(int32_t(position.x), int32_t(position.z)));
 
 		// Copy the color info and the alpha channel to the Alpha Sprite
       m_pImage		= &(paa->m_imColor);
@@ -293,6 +293,19 @@ CGameSettings::CGameSettings(void)
 	m_sPlayAmbientSounds			= TRUE;
 										
 	m_sDisplayInfo					= FALSE;
+
+	m_sLOSCache						= FALSE;
+
+	m_sNavNetVisibility			= FALSE;
+	m_sFlowFields					= FALSE;
+	m_sThinkBudget					= 0;
+	m_sCrowdAvoidance				= FALSE;
+	m_sSmoothRoutes				= FALSE;
+	m_sSceneCulling				= FALSE;
+	m_sRenderThreads				= 0;
+	m_sImpostorCacheMB			= 0;
+	m_sImpostorMaxAge				= 0;
+	m_sBackgroundCache			= FALSE;
 										
 	m_sCanTakeSnapShots			= FALSE;
 										
@@ -307,6 +320,9 @@ CGameSettings::CGameSettings(void)
 	m_sEditorViewWidth			= 640;
 	m_sEditorViewHeight			= 480;
 
+	m_sFrameRate					= RSP_FRAME_PACING_DISPLAY;
+	m_sPresentPipeline			= 0;
+
 	m_sGripZoneRadius				= 75;
 
 	m_eCurSoundQuality			= SampleMaster::SQ_22050_8;
@@ -523,6 +539,8 @@ int16_t CGameSettings::LoadPrefs(
 	pPrefs->GetVal("Video", "GameFilmScale", m_dGameFilmScale, &m_dGameFilmScale);
 	pPrefs->GetVal("Video", "EditorViewWidth", m_sEditorViewWidth, &m_sEditorViewWidth);
 	pPrefs->GetVal("Video", "EditorViewHeight", m_sEditorViewHeight, &m_sEditorViewHeight);
+	pPrefs->GetVal("Video", "FrameRate", m_sFrameRate, &m_sFrameRate);
+	pPrefs->GetVal("Video", "PresentPipeline", m_sPresentPipeline, &m_sPresentPipeline);
 
 	pPrefs->GetVal("Features", "AlphaBlend", m_sAlphaBlend, &m_sAlphaBlend);
 	pPrefs->GetVal("Features", "XRayEffect", m_sXRayEffect, &m_sXRayEffect);
@@ -530,6 +548,17 @@ int16_t CGameSettings::LoadPrefs(
 	pPrefs->GetVal("Features", "ParticleEffects", m_sParticleEffects, &m_sParticleEffects);
 	pPrefs->GetVal("Features", "VolumeDistance", m_sVolumeDistance, &m_sVolumeDistance);
 	pPrefs->GetVal("Features", "PlayAmbientSounds", m_sPlayAmbientSounds, &m_sPlayAmbientSounds);
+	pPrefs->GetVal("Features", "LOSCache", m_sLOSCache, &m_sLOSCache);
+	pPrefs->GetVal("Features", "NavNetVisibility", m_sNavNetVisibility, &m_sNavNetVisibility);
+	pPrefs->GetVal("Features", "FlowFields", m_sFlowFields, &m_sFlowFields);
+	pPrefs->GetVal("Features", "ThinkBudget", m_sThinkBudget, &m_sThinkBudget);
+	pPrefs->GetVal("Features", "CrowdAvoidance", m_sCrowdAvoidance, &m_sCrowdAvoidance);
+	pPrefs->GetVal("Features", "SmoothRoutes", m_sSmoothRoutes, &m_sSmoothRoutes);
+	pPrefs->GetVal("Features", "SceneCulling", m_sSceneCulling, &m_sSceneCulling);
+	pPrefs->GetVal("Features", "RenderThreads", m_sRenderThreads, &m_sRenderThreads);
+	pPrefs->GetVal("Features", "ImpostorCacheMB", m_sImpostorCacheMB, &m_sImpostorCacheMB);
+	pPrefs->GetVal("Features", "ImpostorMaxAge", m_sImpostorMaxAge, &m_sImpostorMaxAge);
+	pPrefs->GetVal("Features", "BackgroundCache", m_sBackgroundCache, &m_sBackgroundCache);
 
 	pPrefs->GetVal("Debug", "DisplayInfo", m_sDisplayInfo, &m_sDisplayInfo);
 	pPrefs->GetVal("Debug", "IfLog", m_szSynchLogFile, m_szSynchLogFile);
@@ -599,6 +628,8 @@ int16_t CGameSettings::SavePrefs(
 	pPrefs->SetVal("Video", "GameFilmScale", m_dGameFilmScale);
 	pPrefs->SetVal("Video", "EditorViewWidth", m_sEditorViewWidth);
 	pPrefs->SetVal("Video", "EditorViewHeight", m_sEditorViewHeight);
+	pPrefs->SetVal("Video", "FrameRate", m_sFrameRate);
+	pPrefs->SetVal("Video", "PresentPipeline", m_sPresentPipeline);
 
 	pPrefs->SetVal("Features", "AlphaBlend", m_sAlphaBlend);
 	pPrefs->SetVal("Features", "XRayEffect", m_sXRayEffect);
@@ -606,6 +637,17 @@ int16_t CGameSettings::SavePrefs(
 	pPrefs->SetVal("Features", "ParticleEffects", m_sParticleEffects);
 	pPrefs->SetVal("Features", "VolumeDistance", m_sVolumeDistance);
 	pPrefs->SetVal("Features", "PlayAmbientSounds", m_sPlayAmbientSounds);
+	pPrefs->SetVal("Features", "LOSCache", m_sLOSCache);
+	pPrefs->SetVal("Features", "NavNetVisibility", m_sNavNetVisibility);
+	pPrefs->SetVal("Features", "FlowFields", m_sFlowFields);
+	pPrefs->SetVal("Features", "ThinkBudget", m_sThinkBudget);
+	pPrefs->SetVal("Features", "CrowdAvoidance", m_sCrowdAvoidance);
+	pPrefs->SetVal("Features", "SmoothRoutes", m_sSmoothRoutes);
+	pPrefs->SetVal("Features", "SceneCulling", m_sSceneCulling);
+	pPrefs->SetVal("Features", "RenderThreads", m_sRenderThreads);
+	pPrefs->SetVal("Features", "ImpostorCacheMB", m_sImpostorCacheMB);
+	pPrefs->SetVal("Features", "ImpostorMaxAge", m_sImpostorMaxAge);
+	pPrefs->SetVal("Features", "BackgroundCache", m_sBackgroundCache);
 
 	pPrefs->SetVal("Debug", "DisplayInfo", m_sDisplayInfo);
 
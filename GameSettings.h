@@ -199,6 +199,19 @@ class CGameSettings : CSettings
 		int16_t		m_sPlayAmbientSounds;					// TRUE, if we should play ambient sounds.
 																
 		int16_t		m_sDisplayInfo;							// TRUE, to show display info.
+
+		int16_t		m_sLOSCache;								// TRUE, to share IsPathClear() results within a frame.
+
+		int16_t		m_sNavNetVisibility;						// TRUE, to bake which bouys each area can see at load.
+		int16_t		m_sFlowFields;								// TRUE, to let hunting enemies follow flow fields toward the dude.
+		int16_t		m_sThinkBudget;							// Microseconds per update for enemy thinking, or 0 for no limit.
+		int16_t		m_sCrowdAvoidance;						// TRUE, to let moving characters steer around each other.
+		int16_t		m_sSmoothRoutes;							// TRUE, to skip bouys that can be walked straight past.
+		int16_t		m_sSceneCulling;							// TRUE, to skip drawing sprites that are off the view.
+		int16_t		m_sRenderThreads;							// Threads to rasterize 3D sprites on (0 or 1 for just the main one).
+		int16_t		m_sImpostorCacheMB;						// Megabytes of pre-rendered 3D sprite trees to keep (0 for none).
+		int16_t		m_sImpostorMaxAge;						// Renders an unused impostor is kept for (0 for no limit).
+		int16_t		m_sBackgroundCache;						// TRUE, to keep the hood's layers drawn and redraw only what scrolls in.
 																
 		int16_t		m_sCanTakeSnapShots;						// TRUE, to be able to take snap shots.
 																
@@ -215,6 +228,11 @@ class CGameSettings : CSettings
 		int16_t		m_sEditorViewWidth;						// Initial display size for editor.
 		int16_t		m_sEditorViewHeight;						// Initial display size for editor.
 
+		int16_t		m_sFrameRate;								// Frames per second to present at, 0 for uncapped,
+																	// or -1 for the display's refresh rate.
+		int16_t		m_sPresentPipeline;						// 1, to convert frames for the screen on another thread
+																	// (a frame later), 0 to do it on the game's.
+
 		int16_t		m_sGripZoneRadius;						// Radius of non scroll area to be specified to grip.
 
 		SampleMaster::SoundQuality	m_eCurSoundQuality;	// Current sound quality.
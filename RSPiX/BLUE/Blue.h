@@ -476,6 +476,36 @@ extern void rspKeyRepeat(bool bEnable);
 
 extern void rspPresentFrame(void);
 
+// Targets for rspSetFramePacing() besides a frame rate in Hz.
+#define RSP_FRAME_PACING_UNCAPPED	0		// Present frames as soon as they are done
+#define RSP_FRAME_PACING_DISPLAY		-1		// Present frames at the display's refresh rate
+
+// Holds frames back so rspPresentFrame() presents them evenly at the target.
+extern void rspSetFramePacing(
+	int16_t sHz);									// In:  Frames per second or RSP_FRAME_PACING_*
+
+// Times between presented frames, over about the last thousand frames.
+typedef struct
+	{
+	uint32_t	ulFrames;							// Frames measured
+	uint32_t	ulMissed;							// Frames more than half a frame late (0 if uncapped)
+	uint32_t	ulTargetUS;							// Target frame time (0 if uncapped)
+	uint32_t	ulP50US;								// Median frame time
+	uint32_t	ulP95US;								// 95th percentile frame time
+	uint32_t	ulP99US;								// 99th percentile frame time
+	uint32_t	ulMaxUS;								// Longest frame time
+	uint32_t	ulLatencyUS;						// Mean time from rspPresentFrame() to the screen
+	} RFrameTimes;
+
+extern int16_t rspGetFrameTimes(				// Returns 0 if successfull, non-zero otherwise
+	RFrameTimes* pft);							// Out: Frame times
+
+// With a depth of 1, rspPresentFrame() hands the frame to another thread to
+// convert and shows it on the next call, so the game goes on meanwhile at
+// the cost of a frame of latency.  0 does it all in rspPresentFrame().
+extern void rspSetPresentPipeline(
+	int16_t sDepth);								// In:  Frames in flight (0 or 1)
+
 extern void rspUpdateDisplayRects(void);
 
 extern void rspUpdateDisplay(void);
@@ -459,6 +459,23 @@ extern void rspPresentFrame(void)
   display::blit_to_screen(display::framebuffer, display::current_mode_info->XResolution * display::current_mode_info->YResolution);
 }
 
+// Frame pacing and the present pipeline are only done by the SDL2 display.
+extern void rspSetFramePacing(int16_t sHz)
+{
+  UNUSED(sHz);
+}
+
+extern int16_t rspGetFrameTimes(RFrameTimes* pft)
+{
+  UNUSED(pft);
+  return FAILURE;
+}
+
+extern void rspSetPresentPipeline(int16_t sDepth)
+{
+  UNUSED(sDepth);
+}
+
 extern void rspUpdateDisplay(void)
 {
 }
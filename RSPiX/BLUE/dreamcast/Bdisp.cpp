@@ -327,6 +327,23 @@ extern void rspPresentFrame(void)
   pvr_scene_finish();
 }
 
+// Frame pacing and the present pipeline are only done by the SDL2 display.
+extern void rspSetFramePacing(int16_t sHz)
+{
+  UNUSED(sHz);
+}
+
+extern int16_t rspGetFrameTimes(RFrameTimes* pft)
+{
+  UNUSED(pft);
+  return FAILURE;
+}
+
+extern void rspSetPresentPipeline(int16_t sDepth)
+{
+  UNUSED(sDepth);
+}
+
 extern void rspUpdateDisplay(void)
 {
   ASSERT(pvr_txr_load_dma(display::framebuffer, display::texture, display::width * display::height, TRUE, NULL, NULL) == SUCCESS);
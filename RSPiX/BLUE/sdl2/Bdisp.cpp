@@ -35,11 +35,26 @@
 #include <SDL2/SDL.h>
 
 // C++ ///////////////////////////////////////////////////////////////////////
+#include <algorithm>
 #include <cctype>
 #include <cstddef>
+#include <vector>
 #include <newpix/sharedarray.h>
 #include <newpix/paltypes.h>
 
+// Palette expansion does 8 or 16 pixels at a time where the CPU has the
+// vectors for it.  Define BDISP_NO_SIMD to always use the plain loop.
+#if !defined(BDISP_NO_SIMD) && defined(__AVX2__)
+  #include <immintrin.h>
+  #define BDISP_AVX2
+#elif !defined(BDISP_NO_SIMD) && (defined(__SSE2__) || defined(_M_X64))
+  #include <emmintrin.h>
+  #define BDISP_SSE2
+#elif !defined(BDISP_NO_SIMD) && defined(__aarch64__)
+  #include <arm_neon.h>
+  #define BDISP_NEON
+#endif
+
 extern SDL_Window *sdlWindow;
 static const char *sdlAppName;
 static SDL_Renderer *sdlRenderer;
@@ -48,8 +63,53 @@ static int RequestedWidth = 0;
 static int RequestedHeight = 0;
 static int FramebufferWidth = 0;
 static int FramebufferHeight = 0;
-static shared_arr<color32_t> TexturePointer;
 static shared_arr<uint8_t> PalettedTexturePointer;
+static shared_arr<uint8_t> PresentedTexturePointer;	// Paletted frame as last presented.
+
+// Rows presented when they differ less than this many rows apart are
+// uploaded as one band.
+#define DIRTY_BAND_GAP	8
+
+namespace dirty
+{
+  static bool bAll = true;           // Present the whole frame next time.
+  static int x1 = 0, y1 = 0;         // Union of the rects reported since the
+  static int x2 = 0, y2 = 0;         // last present (end exclusive).
+}
+
+// Frames are held back until their deadline on the performance counter.
+// SDL_Delay() can oversleep by a millisecond or more, so the wait sleeps
+// until FRAME_SPIN_US before the deadline and spins the rest.
+#define FRAME_SPIN_US       2000
+
+// The times between presents are counted in FRAME_BUCKETS buckets of
+// FRAME_BUCKET_US each (the last one holding anything longer), over the last
+// FRAME_WINDOW frames and since startup.
+#define FRAME_BUCKET_US     250
+#define FRAME_BUCKETS       400
+#define FRAME_WINDOW        1024
+
+namespace pacer
+{
+  static int16_t sHz = RSP_FRAME_PACING_DISPLAY;  // Requested target.
+  static int RefreshHz = 60;                 // Display's refresh rate.
+  static bool bVsync = false;                // Presenting waits for the refresh.
+  static uint64_t Frequency = 1;             // Performance counter ticks per second.
+  static uint64_t Period = 0;                // Ticks to hold each frame for (0 = none).
+  static uint64_t Budget = 0;                // Ticks a frame may take (0 = no limit).
+  static uint64_t Deadline = 0;              // When the next frame is due (0 = now).
+  static uint64_t LastPresent = 0;           // When the last frame was presented.
+  static uint32_t Window[FRAME_WINDOW];      // Microseconds each frame in the window took.
+  static bool WindowMissed[FRAME_WINDOW];    // Whether each frame in the window missed.
+  static uint32_t Latency[FRAME_WINDOW];     // Microseconds from handing each frame over to presenting it.
+  static uint64_t LatencySum = 0;
+  static uint32_t WindowCounts[FRAME_BUCKETS];
+  static uint32_t TotalCounts[FRAME_BUCKETS];
+  static uint32_t Frames = 0;                // Frames measured since startup.
+  static uint32_t Missed = 0;                // Frames in the window that missed.
+  static uint32_t TotalMissed = 0;
+  static uint32_t TotalMaxUS = 0;
+}
 
 typedef struct		// Stores information on usable video modes.
 	{
@@ -72,6 +132,44 @@ namespace palette
   static color32_t* buffer = reinterpret_cast<color32_t*>(aligned_memory::buffer);
   static color32_t* map    = reinterpret_cast<color32_t*>(aligned_memory::map);
   static int8_t locks[size];	// TRUE, if an indexed entry is locked. FALSE, if not.
+  static color32_t presented[size];	// The colors the texture was last expanded with.
+#if defined(BDISP_NEON)
+  static uint8_t planes[4][size];	// presented, one channel per plane, for vqtbl4q.
+#endif
+}
+
+// What must be presented of a frame besides what changed.
+typedef struct
+  {
+  bool bAll;                         // The whole frame.
+  int x1, y1;                        // Union of the rects reported since the
+  int x2, y2;                        // last present (end exclusive).
+  } DirtyArea;
+
+// With a pipeline depth of 1, rspPresentFrame() hands a copy of the frame
+// to a presentation thread, which compares and expands it into 32-bit
+// pixels while the game goes on.  The next rspPresentFrame() uploads and
+// presents those (SDL's rendering stays on the thread that made the
+// renderer).  Two jobs take turns being staged and being uploaded.
+namespace pipeline
+{
+  typedef struct
+    {
+    shared_arr<uint8_t> Frame;       // Copy of the frame handed over.
+    color32_t Palette[palette::size];  // Palette it was drawn for.
+    DirtyArea Area;                  // What must be presented regardless.
+    shared_arr<uint8_t> Staged;      // 32-bit pixels of the bands (at their place in the frame).
+    std::vector<SDL_Rect> Bands;     // Bands staged.
+    int lFrameBytes;                 // Size Frame was allocated for.
+    uint64_t ulHandedAt;             // When it was handed to rspPresentFrame().
+    } Job;
+
+  static int16_t sDepth = 0;         // Frames in flight.
+  static SDL_Thread* pThread = nullptr;
+  static SDL_sem* psemWork = nullptr;   // Posted when a job is handed over (or to quit).
+  static SDL_sem* psemDone = nullptr;   // Posted when the job is staged.
+  static Job Jobs[2];
+  static Job* pjobStaging = nullptr;    // Job with the thread (nullptr = none).
 }
 
 extern bool mouse_grabbed;
@@ -85,6 +183,7 @@ extern bool mouse_grabbed;
 
 
 int16_t CompareModes(video_mode_t* pvm1, video_mode_t* pvm2);
+static pipeline::Job* FinishStaging(void);
 
 extern void Disp_Init(void)	// Returns nothing.
 {
@@ -515,6 +614,9 @@ extern int16_t rspSetVideoMode(	// Returns 0 if successfull, non-zero otherwise
 	{
 		TRACE("rspSetVideoMode(%i, %i, %i, %i, %i, %i, %i)\n", sDeviceDepth, sDeviceWidth, sDeviceHeight, sWidth, sHeight, sPages, sPixelDoubling);
         ASSERT(sDeviceDepth == 8);
+
+        // Whatever the presentation thread has was for the old texture.
+        FinishStaging();
         //ASSERT(sDeviceWidth == 0);
         //ASSERT(sDeviceHeight == 0);
         //ASSERT(sWidth == 640);
@@ -622,16 +724,67 @@ extern int16_t rspSetVideoMode(	// Returns 0 if successfull, non-zero otherwise
             exit(1);
         }
 
-        TexturePointer.allocate(FramebufferWidth * FramebufferHeight);
         PalettedTexturePointer.allocate(FramebufferWidth * FramebufferHeight);
-        SDL_memset(TexturePointer, '\0', FramebufferWidth * FramebufferHeight * sizeof (color32_t));
+        PresentedTexturePointer.allocate(FramebufferWidth * FramebufferHeight);
         SDL_memset(PalettedTexturePointer, '\0', FramebufferWidth * FramebufferHeight * sizeof (uint8_t));
-        SDL_UpdateTexture(sdlTexture, nullptr, TexturePointer, FramebufferWidth * 4);
+        SDL_memset(PresentedTexturePointer, '\0', FramebufferWidth * FramebufferHeight * sizeof (uint8_t));
+        dirty::bAll = true;  // the new texture's contents are undefined.
+
+        SDL_DisplayMode mode;
+        if (SDL_GetWindowDisplayMode(sdlWindow, &mode) == SUCCESS && mode.refresh_rate > 0)
+            pacer::RefreshHz = mode.refresh_rate;
+        SDL_RendererInfo info;
+        pacer::bVsync = (SDL_GetRendererInfo(sdlRenderer, &info) == SUCCESS) &&
+                        (info.flags & SDL_RENDERER_PRESENTVSYNC);
+        rspSetFramePacing(pacer::sHz);
 
       SDL_ShowCursor(0);
       return SUCCESS;
 	}
 
+// Sum up frame times from a histogram.
+static void FrameTimesFromCounts(
+  const uint32_t* pCounts,          // In:  Frames per bucket
+  uint32_t lFrames,                 // In:  Total of pCounts
+  RFrameTimes* pft)                 // Out: Percentiles (the upper edge of their bucket)
+{
+  const uint32_t aRank[3] = { (lFrames * 50 + 99) / 100, (lFrames * 95 + 99) / 100, (lFrames * 99 + 99) / 100 };
+  uint32_t* aResult[3] = { &pft->ulP50US, &pft->ulP95US, &pft->ulP99US };
+  uint32_t lSum = 0;
+  int p = 0;
+  for (int i = 0; i < FRAME_BUCKETS && p < 3; i++)
+  {
+    lSum += pCounts[i];
+    for (; p < 3 && lSum >= aRank[p] && lSum > 0; p++)
+      *aResult[p] = (i + 1) * FRAME_BUCKET_US;
+  }
+}
+
+// Report frame times since startup to the debug output.
+static void DumpFrameTimes(void)
+{
+  const uint32_t lFrames = pacer::Frames;
+  if (lFrames == 0)
+    return;
+
+  // Not TRACE, so release builds report it too.  The whole histogram only
+  // goes out with -frametimes.
+  RFrameTimes ft;
+  SDL_zero(ft);
+  FrameTimesFromCounts(pacer::TotalCounts, lFrames, &ft);
+  rspTrace("Frame times over %u frames: p50 %u us, p95 %u us, p99 %u us, max %u us, %u missed (target %u us)\n",
+           lFrames, ft.ulP50US, ft.ulP95US, ft.ulP99US, pacer::TotalMaxUS, pacer::TotalMissed,
+           uint32_t(pacer::Budget * 1000000 / pacer::Frequency));
+  if (!rspCommandLine("frametimes"))
+    return;
+
+  for (int i = 0; i < FRAME_BUCKETS; i++)
+  {
+    if (pacer::TotalCounts[i])
+      rspTrace("  %5u us%s: %u\n", (i + 1) * FRAME_BUCKET_US, (i == FRAME_BUCKETS - 1) ? "+" : "", pacer::TotalCounts[i]);
+  }
+}
+
 //////////////////////////////////////////////////////////////////////////////
 //
 // Puts you in a state of not having display access.  After this function is
@@ -643,6 +796,8 @@ extern int16_t rspSetVideoMode(	// Returns 0 if successfull, non-zero otherwise
 extern void rspKillVideoMode(void)
 	{
     /* no-op ... SDL_Quit() will catch this. */
+    rspSetPresentPipeline(0);
+    DumpFrameTimes();
 	}
 
 //////////////////////////////////////////////////////////////////////////////
@@ -667,9 +822,365 @@ extern void rspKillVideoBuffer(void)
 //
 //////////////////////////////////////////////////////////////////////////////
 
+// Add a rect to the area that must be presented next frame.
+static void MarkDirty(int sX, int sY, int sWidth, int sHeight)
+{
+  const int x1 = std::max(sX, 0);
+  const int y1 = std::max(sY, 0);
+  const int x2 = std::min(sX + sWidth, FramebufferWidth);
+  const int y2 = std::min(sY + sHeight, FramebufferHeight);
+  if (x1 >= x2 || y1 >= y2)
+    return;
+
+  if (dirty::x1 >= dirty::x2)
+  {
+    dirty::x1 = x1; dirty::y1 = y1;
+    dirty::x2 = x2; dirty::y2 = y2;
+  }
+  else
+  {
+    dirty::x1 = std::min(dirty::x1, x1); dirty::y1 = std::min(dirty::y1, y1);
+    dirty::x2 = std::max(dirty::x2, x2); dirty::y2 = std::max(dirty::y2, y2);
+  }
+}
+
+// Find the first and last pixels that differ between two rows.
+static bool RowExtent(              // Returns false if the rows are the same.
+  const uint8_t* pNew,              // In:  Row to present
+  const uint8_t* pOld,              // In:  Row as last presented
+  int sWidth,                       // In:  Pixels per row
+  int* psX1,                        // Out: First different pixel
+  int* psX2)                        // Out: One past the last different pixel
+{
+  if (SDL_memcmp(pNew, pOld, sWidth) == 0)
+    return false;
+
+  uint64_t a, b;
+  int x1 = 0;
+  for (; x1 + 8 <= sWidth; x1 += 8)
+  {
+    SDL_memcpy(&a, pNew + x1, 8);
+    SDL_memcpy(&b, pOld + x1, 8);
+    if (a != b)
+      break;
+  }
+  while (pNew[x1] == pOld[x1])
+    x1++;
+
+  int x2 = sWidth;
+  for (; x2 - 8 >= x1; x2 -= 8)
+  {
+    SDL_memcpy(&a, pNew + x2 - 8, 8);
+    SDL_memcpy(&b, pOld + x2 - 8, 8);
+    if (a != b)
+      break;
+  }
+  while (pNew[x2 - 1] == pOld[x2 - 1])
+    x2--;
+
+  *psX1 = x1;
+  *psX2 = x2;
+  return true;
+}
+
+// Expand a span of paletted pixels through palette::presented.  SSE2 has no
+// gather, so it does the lookups itself and stores 4 pixels at a time; NEON
+// looks each channel up in its 256 byte plane with table shuffles and
+// interleaves them on the store.
+static void ExpandSpan(
+  uint32_t* pDst,                   // Out: 32-bit pixels
+  const uint8_t* pSrc,              // In:  Paletted pixels
+  int sCount)                       // In:  Number of pixels
+{
+  static_assert(sizeof(color32_t) == sizeof (uint32_t), "broken compiler!");
+  const uint32_t* pLut = reinterpret_cast<const uint32_t*>(palette::presented);
+  int x = 0;
+
+#if defined(BDISP_AVX2)
+  for (; x + 8 <= sCount; x += 8)
+  {
+    const __m256i idx = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(pSrc + x)));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(pDst + x),
+                        _mm256_i32gather_epi32(reinterpret_cast<const int*>(pLut), idx, 4));
+  }
+#elif defined(BDISP_SSE2)
+  for (; x + 8 <= sCount; x += 8)
+  {
+    uint64_t q;
+    SDL_memcpy(&q, pSrc + x, 8);
+    const __m128i lo = _mm_setr_epi32(pLut[q & 0xFF], pLut[(q >> 8) & 0xFF],
+                                      pLut[(q >> 16) & 0xFF], pLut[(q >> 24) & 0xFF]);
+    const __m128i hi = _mm_setr_epi32(pLut[(q >> 32) & 0xFF], pLut[(q >> 40) & 0xFF],
+                                      pLut[(q >> 48) & 0xFF], pLut[q >> 56]);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(pDst + x), lo);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(pDst + x + 4), hi);
+  }
+#elif defined(BDISP_NEON)
+  // vqtbl4q looks up 64 entries; indices past them leave vqtbx4q's
+  // destination alone, so four quarters of a plane chain together.
+  uint8x16x4_t tbl[4][4];
+  for (int c = 0; c < 4; c++)
+    for (int q = 0; q < 4; q++)
+      for (int r = 0; r < 4; r++)
+        tbl[c][q].val[r] = vld1q_u8(palette::planes[c] + q * 64 + r * 16);
+
+  const uint8x16_t v64 = vdupq_n_u8(64);
+  for (; x + 16 <= sCount; x += 16)
+  {
+    const uint8x16_t idx0 = vld1q_u8(pSrc + x);
+    const uint8x16_t idx1 = vsubq_u8(idx0, v64);
+    const uint8x16_t idx2 = vsubq_u8(idx1, v64);
+    const uint8x16_t idx3 = vsubq_u8(idx2, v64);
+    uint8x16x4_t out;
+    for (int c = 0; c < 4; c++)
+    {
+      uint8x16_t v = vqtbl4q_u8(tbl[c][0], idx0);
+      v = vqtbx4q_u8(v, tbl[c][1], idx1);
+      v = vqtbx4q_u8(v, tbl[c][2], idx2);
+      out.val[c] = vqtbx4q_u8(v, tbl[c][3], idx3);
+    }
+    vst4q_u8(reinterpret_cast<uint8_t*>(pDst + x), out);
+  }
+#endif
+
+  for (; x < sCount; x++)
+    pDst[x] = pLut[pSrc[x]];
+}
+
+// Expand a band of a frame into 32-bit pixels and remember what was
+// presented there.
+static void ExpandBand(
+  const uint8_t* pFrame,            // In:  Frame to present
+  const SDL_Rect& rect,             // In:  Band to expand
+  uint8_t* pDst,                    // Out: 32-bit pixels of the band
+  int pitch)                        // In:  Bytes per row of pDst
+{
+  const uint8_t* pSrc = pFrame + rect.y * FramebufferWidth + rect.x;
+  uint8_t* pOld = PresentedTexturePointer + rect.y * FramebufferWidth + rect.x;
+  for (int y = 0; y < rect.h; y++)
+  {
+    ExpandSpan(reinterpret_cast<uint32_t*>(pDst), pSrc, rect.w);
+    SDL_memcpy(pOld, pSrc, rect.w);
+    pSrc += FramebufferWidth;
+    pOld += FramebufferWidth;
+    pDst += pitch;
+  }
+}
+
+// Expand a band of a frame straight into the texture.
+static bool PresentBand(            // Returns false if the texture could not be locked.
+  const uint8_t* pFrame,            // In:  Frame to present
+  const SDL_Rect& rect)             // In:  Band to present
+{
+  void* pvPixels;
+  int pitch;
+  if (SDL_LockTexture(sdlTexture, &rect, &pvPixels, &pitch) != 0)
+  {
+    TRACE("SDL_LockTexture failed: %s\n", SDL_GetError());
+    return false;
+  }
+
+  ExpandBand(pFrame, rect, static_cast<uint8_t*>(pvPixels), pitch);
+  SDL_UnlockTexture(sdlTexture);
+  return true;
+}
+
+// Make a palette the one frames are expanded with.
+static bool UsePalette(             // Returns true if the palette changed.
+  const color32_t* pPalette)        // In:  Palette of the frame to present
+{
+  if (SDL_memcmp(palette::presented, pPalette, sizeof (palette::presented)) == 0)
+    return false;
+
+  SDL_memcpy(palette::presented, pPalette, sizeof (palette::presented));
+#if defined(BDISP_NEON)
+  for (int i = 0; i < palette::size; i++)
+  {
+    palette::planes[0][i] = palette::presented[i].blue;
+    palette::planes[1][i] = palette::presented[i].green;
+    palette::planes[2][i] = palette::presented[i].red;
+    palette::planes[3][i] = palette::presented[i].alpha;
+  }
+#endif
+  return true;
+}
+
+// Present the parts of a frame that changed since the last one, a band at
+// a time.  Most drawing goes straight into the buffer without reporting a
+// rect, so the frame is compared with what was last presented to find the
+// rows that changed.  Changed rows close together go as one band covering
+// all of their changed pixels.
+static bool PresentChanges(         // Returns false if any band did not make it.
+  const uint8_t* pFrame,            // In:  Frame to present
+  const DirtyArea& area,            // In:  What must be presented regardless
+  bool (*pfnBand)(const uint8_t* pFrame, const SDL_Rect& rect))  // In:  Presents a band
+{
+  const int w = FramebufferWidth;
+  const uint8_t* pNew = pFrame;
+  const uint8_t* pOld = PresentedTexturePointer;
+  bool bPresented = true;
+  int bandX1 = 0, bandY1 = -1, bandX2 = 0, bandY2 = 0;
+  for (int y = 0; y < FramebufferHeight; y++, pNew += w, pOld += w)
+  {
+    int x1 = 0, x2 = w;
+    if (!area.bAll)
+    {
+      const bool bChanged = RowExtent(pNew, pOld, w, &x1, &x2);
+      if (y >= area.y1 && y < area.y2)
+      {
+        x1 = bChanged ? std::min(x1, area.x1) : area.x1;
+        x2 = bChanged ? std::max(x2, area.x2) : area.x2;
+      }
+      else if (!bChanged)
+        continue;
+    }
+
+    if (bandY1 >= 0 && y - bandY2 < DIRTY_BAND_GAP)
+    {
+      bandX1 = std::min(bandX1, x1);
+      bandX2 = std::max(bandX2, x2);
+    }
+    else
+    {
+      if (bandY1 >= 0)
+      {
+        const SDL_Rect rect = { bandX1, bandY1, bandX2 - bandX1, bandY2 - bandY1 };
+        bPresented &= pfnBand(pFrame, rect);
+      }
+      bandX1 = x1;
+      bandX2 = x2;
+      bandY1 = y;
+    }
+    bandY2 = y + 1;
+  }
+  if (bandY1 >= 0)
+  {
+    const SDL_Rect rect = { bandX1, bandY1, bandX2 - bandX1, bandY2 - bandY1 };
+    bPresented &= pfnBand(pFrame, rect);
+  }
+  return bPresented;
+}
+
+// Expand a band into the frame being staged on the presentation thread.
+static bool StageBand(              // Returns true.
+  const uint8_t* pFrame,            // In:  Frame to present
+  const SDL_Rect& rect)             // In:  Band to stage
+{
+  pipeline::Job* pjob = pipeline::pjobStaging;
+  const int pitch = FramebufferWidth * int(sizeof (uint32_t));
+  ExpandBand(pFrame, rect, pjob->Staged + rect.y * pitch + rect.x * int(sizeof (uint32_t)), pitch);
+  pjob->Bands.push_back(rect);
+  return true;
+}
+
+// The presentation thread: expands each frame it is handed into the job's
+// staged pixels, for the next rspPresentFrame() to upload.
+static int PresentThread(void* pvUnused)
+{
+  UNUSED(pvUnused);
+  for (;;)
+  {
+    SDL_SemWait(pipeline::psemWork);
+    pipeline::Job* pjob = pipeline::pjobStaging;
+    if (pjob == nullptr)
+      break;  // told to quit.
+
+    DirtyArea area = pjob->Area;
+    if (UsePalette(pjob->Palette))
+      area.bAll = true;
+    pjob->Bands.clear();
+    PresentChanges(pjob->Frame, area, StageBand);
+    SDL_SemPost(pipeline::psemDone);
+  }
+  return 0;
+}
+
+// Upload a job's staged bands into the texture.
+static bool UploadStaged(           // Returns false if any band did not make it.
+  const pipeline::Job* pjob)        // In:  Job the thread is done with
+{
+  const int lStagedPitch = FramebufferWidth * int(sizeof (uint32_t));
+  bool bUploaded = true;
+  for (const SDL_Rect& rect : pjob->Bands)
+  {
+    void* pvPixels;
+    int pitch;
+    if (SDL_LockTexture(sdlTexture, &rect, &pvPixels, &pitch) != 0)
+    {
+      TRACE("SDL_LockTexture failed: %s\n", SDL_GetError());
+      bUploaded = false;
+      continue;
+    }
+
+    const uint8_t* pSrc = pjob->Staged + rect.y * lStagedPitch + rect.x * int(sizeof (uint32_t));
+    uint8_t* pDst = static_cast<uint8_t*>(pvPixels);
+    for (int y = 0; y < rect.h; y++, pSrc += lStagedPitch, pDst += pitch)
+      SDL_memcpy(pDst, pSrc, rect.w * sizeof (uint32_t));
+    SDL_UnlockTexture(sdlTexture);
+  }
+  return bUploaded;
+}
+
+// Wait for the frame the thread has, if any.
+static pipeline::Job* FinishStaging(void)  // Returns the job it was in or nullptr.
+{
+  pipeline::Job* pjob = pipeline::pjobStaging;
+  if (pjob != nullptr)
+  {
+    SDL_SemWait(pipeline::psemDone);
+    pipeline::pjobStaging = nullptr;
+  }
+  return pjob;
+}
+
+extern void rspSetPresentPipeline(
+  int16_t sDepth)                   // In:  Frames in flight (0 or 1)
+{
+  sDepth = std::min<int16_t>(std::max<int16_t>(sDepth, 0), 1);
+  if (sDepth == pipeline::sDepth)
+    return;
+
+  if (sDepth == 0)
+  {
+    // Put up what the thread was working on so the texture keeps up with
+    // what it was compared to.
+    const pipeline::Job* pjob = FinishStaging();
+    if (pjob != nullptr && sdlTexture != nullptr && !UploadStaged(pjob))
+      dirty::bAll = true;
+
+    SDL_SemPost(pipeline::psemWork);  // pjobStaging is nullptr: quit.
+    SDL_WaitThread(pipeline::pThread, nullptr);
+    SDL_DestroySemaphore(pipeline::psemWork);
+    SDL_DestroySemaphore(pipeline::psemDone);
+    pipeline::pThread = nullptr;
+    pipeline::psemWork = pipeline::psemDone = nullptr;
+  }
+  else
+  {
+    pipeline::psemWork = SDL_CreateSemaphore(0);
+    pipeline::psemDone = SDL_CreateSemaphore(0);
+    pipeline::pThread = SDL_CreateThread(PresentThread, "Present", nullptr);
+    if (!pipeline::psemWork || !pipeline::psemDone || !pipeline::pThread)
+    {
+      TRACE("rspSetPresentPipeline(): Couldn't start the presentation thread: %s\n", SDL_GetError());
+      if (pipeline::pThread)
+      {
+        SDL_SemPost(pipeline::psemWork);
+        SDL_WaitThread(pipeline::pThread, nullptr);
+      }
+      SDL_DestroySemaphore(pipeline::psemWork);
+      SDL_DestroySemaphore(pipeline::psemDone);
+      pipeline::pThread = nullptr;
+      pipeline::psemWork = pipeline::psemDone = nullptr;
+      return;
+    }
+  }
+  pipeline::sDepth = sDepth;
+}
+
 extern void rspUpdateDisplayRects(void)
 {
-    // no-op, just blast it all to the GPU.
+    // no-op, rspPresentFrame() uploads the dirty rects.
 }
 
 extern void rspCacheDirtyRect(
@@ -678,56 +1189,168 @@ extern void rspCacheDirtyRect(
 	int16_t sWidth,				// Width of area to update
 	int16_t sHeight)				// Height of area to update
 {
-  UNUSED(sX,sY,sWidth,sHeight);
+  MarkDirty(sX, sY, sWidth, sHeight);
+}
+
+// Hold the frame back until it is due.
+static void FrameWait(void)
+{
+  if (pacer::Period == 0)
+    return;
+
+  uint64_t now = SDL_GetPerformanceCounter();
+  if (pacer::Deadline == 0 || now > pacer::Deadline + pacer::Period)
+    pacer::Deadline = now;  // first frame, or too far behind to catch up.
+
+  const uint64_t spin = pacer::Frequency * FRAME_SPIN_US / 1000000;
+  while (now + spin < pacer::Deadline)
+  {
+    SDL_Delay(uint32_t((pacer::Deadline - spin - now) * 1000 / pacer::Frequency));
+    now = SDL_GetPerformanceCounter();
+  }
+  while (now < pacer::Deadline)
+    now = SDL_GetPerformanceCounter();
+
+  pacer::Deadline += pacer::Period;
+}
+
+// Count the time since the last present and since the frame was handed
+// over.
+static void FrameRecord(
+  uint64_t ulHandedAt)              // In:  When the frame was handed to rspPresentFrame()
+{
+  const uint64_t now = SDL_GetPerformanceCounter();
+  if (pacer::LastPresent)
+  {
+    const uint64_t ticks = now - pacer::LastPresent;
+    const uint32_t us = uint32_t(std::min<uint64_t>(ticks * 1000000 / pacer::Frequency, UINT32_MAX));
+    const int bucket = int(std::min<uint32_t>(us / FRAME_BUCKET_US, FRAME_BUCKETS - 1));
+    const bool bMissed = pacer::Budget && ticks > pacer::Budget + pacer::Budget / 2;
+
+    const uint32_t latency = uint32_t(std::min<uint64_t>((now - ulHandedAt) * 1000000 / pacer::Frequency, UINT32_MAX));
+
+    const uint32_t slot = pacer::Frames % FRAME_WINDOW;
+    if (pacer::Frames >= FRAME_WINDOW)
+    {
+      pacer::WindowCounts[std::min<uint32_t>(pacer::Window[slot] / FRAME_BUCKET_US, FRAME_BUCKETS - 1)]--;
+      pacer::Missed -= pacer::WindowMissed[slot];
+      pacer::LatencySum -= pacer::Latency[slot];
+    }
+    pacer::Window[slot] = us;
+    pacer::Latency[slot] = latency;
+    pacer::LatencySum += latency;
+    pacer::WindowMissed[slot] = bMissed;
+    pacer::WindowCounts[bucket]++;
+    pacer::TotalCounts[bucket]++;
+    pacer::Missed += bMissed;
+    pacer::TotalMissed += bMissed;
+    pacer::TotalMaxUS = std::max(pacer::TotalMaxUS, us);
+    pacer::Frames++;
+  }
+  pacer::LastPresent = now;
+}
+
+extern void rspSetFramePacing(
+  int16_t sHz)                      // In:  Frames per second or RSP_FRAME_PACING_*
+{
+  pacer::sHz = sHz;
+  pacer::Frequency = SDL_GetPerformanceFrequency();
+
+  int lTargetHz = (sHz == RSP_FRAME_PACING_DISPLAY) ? pacer::RefreshHz : std::max<int>(sHz, 0);
+  pacer::Budget = lTargetHz ? pacer::Frequency / lTargetHz : 0;
+  // With vsync presenting already waits for the refresh.
+  pacer::Period = (sHz == RSP_FRAME_PACING_DISPLAY && pacer::bVsync) ? 0 : pacer::Budget;
+  pacer::Deadline = 0;
+  pacer::LastPresent = 0;  // don't count the time spent changing.
+}
+
+extern int16_t rspGetFrameTimes(    // Returns 0 if successfull, non-zero otherwise
+  RFrameTimes* pft)                 // Out: Frame times
+{
+  const uint32_t lFrames = std::min<uint32_t>(pacer::Frames, FRAME_WINDOW);
+  SDL_zerop(pft);
+  if (lFrames == 0)
+    return FAILURE;
+
+  pft->ulFrames = lFrames;
+  pft->ulMissed = pacer::Missed;
+  pft->ulTargetUS = uint32_t(pacer::Budget * 1000000 / pacer::Frequency);
+  FrameTimesFromCounts(pacer::WindowCounts, lFrames, pft);
+  pft->ulMaxUS = *std::max_element(pacer::Window, pacer::Window + lFrames);
+  pft->ulLatencyUS = uint32_t(pacer::LatencySum / lFrames);
+  return SUCCESS;
+}
+
+// Put the texture on the screen when the frame is due.
+static void ShowTexture(
+  uint64_t ulHandedAt)              // In:  When the frame was handed to rspPresentFrame()
+{
+  SDL_RenderClear(sdlRenderer);
+  SDL_RenderCopy(sdlRenderer, sdlTexture, nullptr, nullptr);
+  FrameWait();
+  SDL_RenderPresent(sdlRenderer);  // off to the screen with you.
+  FrameRecord(ulHandedAt);
 }
 
 extern void rspPresentFrame(void)
 {
     if (!sdlWindow) return;
 
-    // !!! FIXME: I imagine this is not fast. Maybe keep the dirty rect code at least?
-    static_assert(sizeof(color32_t) == sizeof (uint32_t), "broken compiler!");
-    const uint8_t *src = PalettedTexturePointer;
-    color32_t *dst = TexturePointer;
-    for (int y = 0; y < FramebufferHeight; y++)
+    const uint64_t now = SDL_GetPerformanceCounter();
+    if (pipeline::sDepth == 0)
     {
-        for (int x = 0; x < FramebufferWidth; x++, src++, dst++)
-            *dst = palette::buffer[*src];
-        }
+        // A new palette changes every pixel.
+        if (UsePalette(palette::buffer))
+            dirty::bAll = true;
 
-    SDL_UpdateTexture(sdlTexture, nullptr, TexturePointer, FramebufferWidth * 4);
-    SDL_RenderClear(sdlRenderer);
-    SDL_RenderCopy(sdlRenderer, sdlTexture, nullptr, nullptr);
-    SDL_RenderPresent(sdlRenderer);  // off to the screen with you.
+        const DirtyArea area = { dirty::bAll, dirty::x1, dirty::y1, dirty::x2, dirty::y2 };
+        const bool bPresented = PresentChanges(PalettedTexturePointer, area, PresentBand);
 
-    static uint32_t lastframeticks = 0;
-    const uint32_t now = SDL_GetTicks();
+        // Try the whole frame again if any of it did not make it.
+        dirty::bAll = !bPresented;
+        dirty::x1 = dirty::y1 = dirty::x2 = dirty::y2 = 0;
 
-    if ((lastframeticks) && (lastframeticks <= now))
-    {
-        const uint32_t elapsed = (now - lastframeticks);
-        if (elapsed <= 5)  // going WAY too fast, maybe OpenGL (and/or no vsync)?
-            SDL_Delay(16 - elapsed);  // try to get closer to 60fps.
+        ShowTexture(now);
+        return;
     }
 
-    lastframeticks = now;
+    // Take the last frame back from the thread, and hand it this one (with
+    // the job the last one wasn't in) before putting the last one up.
+    pipeline::Job* pjobLast = FinishStaging();
+    pipeline::Job* pjob = &pipeline::Jobs[(pjobLast == &pipeline::Jobs[0]) ? 1 : 0];
 
-    #if 0
-    static uint32_t ticks = 0;
-    static uint32_t frames = 0;
-    frames++;
-    if ((now - ticks) > 5000)
+    const int lFrameBytes = FramebufferWidth * FramebufferHeight;
+    const int lStagedBytes = FramebufferWidth * FramebufferHeight * int(sizeof (uint32_t));
+    if (pjob->lFrameBytes != lFrameBytes)
+    {
+        pjob->Frame.allocate(lFrameBytes);
+        pjob->Staged.allocate(lStagedBytes);
+        pjob->lFrameBytes = lFrameBytes;
+    }
+    SDL_memcpy(pjob->Frame, PalettedTexturePointer, lFrameBytes);
+    SDL_memcpy(pjob->Palette, palette::buffer, sizeof (pjob->Palette));
+    pjob->Area.bAll = dirty::bAll;
+    pjob->Area.x1 = dirty::x1; pjob->Area.y1 = dirty::y1;
+    pjob->Area.x2 = dirty::x2; pjob->Area.y2 = dirty::y2;
+    pjob->ulHandedAt = now;
+    dirty::bAll = false;
+    dirty::x1 = dirty::y1 = dirty::x2 = dirty::y2 = 0;
+
+    pipeline::pjobStaging = pjob;
+    SDL_SemPost(pipeline::psemWork);
+
+    if (pjobLast != nullptr)
     {
-        if (ticks > 0)
-            TRACE("fps: %f\n", (((double) frames) / ((double) (now - ticks))) * 1000.0);
-        ticks = now;
-        frames = 0;
+        // Anything that did not make it goes with the frame after this one.
+        if (!UploadStaged(pjobLast))
+            dirty::bAll = true;
+        ShowTexture(pjobLast->ulHandedAt);
     }
-    #endif
 }
 
 extern void rspUpdateDisplay(void)
 {
+  // no-op, rspPresentFrame() finds what changed on its own.
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -742,7 +1365,7 @@ extern void rspUpdateDisplay(
 	int16_t sWidth,				// Width of area to update
 	int16_t sHeight)				// Height of area to update
 {
-  UNUSED(sX,sY,sWidth,sHeight);
+  MarkDirty(sX, sY, sWidth, sHeight);
 }
 
 ///////////////////////////////////////////////////////////////////////////////
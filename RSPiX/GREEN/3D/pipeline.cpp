@@ -18,6 +18,14 @@
 #include <BLUE/System.h>
 #include "pipeline.h"
 
+#if defined(__SSE__) || defined(_M_X64)
+	#include <xmmintrin.h>
+	#define PIPELINE_SSE
+#elif defined(__ARM_NEON__) || defined(__ARM_NEON)
+	#include <arm_neon.h>
+	#define PIPELINE_NEON
+#endif
+
 ///////////////////////////////////////////////////////////////
 // This is the highest level considered actually part of the 3d engine.
 // It is the highest level control -> it decides how 3d pts map to 2d.
@@ -31,20 +39,18 @@
 ///////////////////////////////////////////////////////////////
 
 
-uint32_t RPipeLine::ms_lNumPts = 0;
-uint32_t	RPipeLine::ms_lNumPipes = 0;
-
-Vector3D*  RPipeLine::ms_pPts = nullptr;
-
 RPipeLine::RPipeLine()
 {
-  ms_lNumPipes++; // Track for deletion purposes!
+  m_lNumPts = 0;
+  m_pPts = nullptr;
 
   m_pimClipBuf = nullptr;
   m_pimShadowBuf = nullptr;
   m_pZB = nullptr;
   m_sUseBoundingRect = FALSE;
   m_dShadowScale = 1.0;
+  m_sClipDirtyX1 = m_sClipDirtyY1 = 0;
+  m_sClipDirtyX2 = m_sClipDirtyY2 = 0;
 }
 
 // assume the clip rect is identical situation to zBUF:
@@ -68,21 +74,24 @@ int16_t RPipeLine::Create(size_t lNum,int16_t sW)
 			m_pimClipBuf = new RImage;
 			// clear it when appropriate:
 			m_pimClipBuf->CreateImage(sW,sW,RImage::BMP8);
+			m_sClipDirtyX1 = m_sClipDirtyY1 = 0;
+			m_sClipDirtyX2 = m_sClipDirtyY2 = sW;
 			}
 		}
 
 	//----------
 	if (!lNum) return SUCCESS;
 	
-	if ((ms_pPts != nullptr) && (lNum > ms_lNumPts))
+	if ((m_pPts != nullptr) && (lNum > m_lNumPts))
 		{
-       delete ms_pPts;
-		ms_pPts = nullptr;
+      delete [] m_pPts;
+		m_pPts = nullptr;
 		}
 
-	if (ms_pPts == nullptr)
+	if (m_pPts == nullptr)
 		{
-      ms_pPts = new Vector3D[lNum];
+      m_pPts = new Vector3D[lNum];
+		m_lNumPts = lNum;
 		}
 
 	return SUCCESS;
@@ -155,13 +164,7 @@ void RPipeLine::Destroy()
 RPipeLine::~RPipeLine()
 	{
 	Destroy();
-	ms_lNumPipes--; // prepare for full death:
-	if (!ms_lNumPipes)	// free ms_pPts
-		{
-		if (ms_pPts) free(ms_pPts);
-		ms_lNumPts = 0;
-		ms_pPts = nullptr;
-		}
+	delete [] m_pPts;
 	}
 
 void RPipeLine::Transform(RSop* pPts,RTransform& tObj)
@@ -174,11 +177,116 @@ void RPipeLine::Transform(RSop* pPts,RTransform& tObj)
 	// trasnform each pt by two transforms separately!
    tFull.PreMulBy(m_tScreen);
 
-   for (size_t i = 0; i < pPts->points.size(); i++)
+	TransformPoints(pPts,tFull);
+	// Note that you can now use RP3d directly with the renderers! 
+	}
+
+// Each point is a row of 4 floats, so the transformed point is the sum of
+// the matrix columns scaled by x, y, z and w.  The sums are done in the
+// same order as RTransform::TransformInto(), so results match it.
+void RPipeLine::TransformPoints(RSop* pPts,const RTransform& tFull)
+	{
+	size_t lNum = pPts->points.size();
+	ASSERT(lNum <= m_lNumPts);
+	const Vector3D* pSrc = pPts->points.get();
+	const real_t* M = tFull.matdata;
+
+	if (lNum == 0)
+		{
+		m_v3Min = Vector3D(0.0,0.0,0.0);
+		m_v3Max = Vector3D(0.0,0.0,0.0);
+		return;
+		}
+
+#if defined(PIPELINE_SSE)
+	// Columns, with 0 for the w lane, which is set to 1 afterward:
+	__m128 vCol0 = _mm_setr_ps(M[rowcol(0, 0)],M[rowcol(1, 0)],M[rowcol(2, 0)],0.0f);
+	__m128 vCol1 = _mm_setr_ps(M[rowcol(0, 1)],M[rowcol(1, 1)],M[rowcol(2, 1)],0.0f);
+	__m128 vCol2 = _mm_setr_ps(M[rowcol(0, 2)],M[rowcol(1, 2)],M[rowcol(2, 2)],0.0f);
+	__m128 vCol3 = _mm_setr_ps(M[rowcol(0, 3)],M[rowcol(1, 3)],M[rowcol(2, 3)],0.0f);
+	__m128 vW = _mm_setr_ps(0.0f,0.0f,0.0f,1.0f);
+	__m128 vMin = _mm_set1_ps(HUGE_VALF);
+	__m128 vMax = _mm_set1_ps(-HUGE_VALF);
+
+	for (size_t i = 0; i < lNum; i++)
+		{
+		__m128 vSrc = _mm_loadu_ps(reinterpret_cast<const float*>(pSrc + i));
+		__m128 vDst = _mm_mul_ps(vCol0,_mm_shuffle_ps(vSrc,vSrc,_MM_SHUFFLE(0,0,0,0)));
+		vDst = _mm_add_ps(vDst,_mm_mul_ps(vCol1,_mm_shuffle_ps(vSrc,vSrc,_MM_SHUFFLE(1,1,1,1))));
+		vDst = _mm_add_ps(vDst,_mm_mul_ps(vCol2,_mm_shuffle_ps(vSrc,vSrc,_MM_SHUFFLE(2,2,2,2))));
+		vDst = _mm_add_ps(vDst,_mm_mul_ps(vCol3,_mm_shuffle_ps(vSrc,vSrc,_MM_SHUFFLE(3,3,3,3))));
+		vDst = _mm_add_ps(vDst,vW);
+		_mm_storeu_ps(reinterpret_cast<float*>(m_pPts + i),vDst);
+		vMin = _mm_min_ps(vMin,vDst);
+		vMax = _mm_max_ps(vMax,vDst);
+		}
+
+	float afMin[4], afMax[4];
+	_mm_storeu_ps(afMin,vMin);
+	_mm_storeu_ps(afMax,vMax);
+	m_v3Min = Vector3D(afMin[0],afMin[1],afMin[2]);
+	m_v3Max = Vector3D(afMax[0],afMax[1],afMax[2]);
+#elif defined(PIPELINE_NEON)
+	static const float afW[4] = { 0.0f, 0.0f, 0.0f, 1.0f };
+	float afCol[4][4];
+	for (int16_t c = 0; c < 4; c++)
+		{
+		afCol[c][0] = M[rowcol(0, c)];
+		afCol[c][1] = M[rowcol(1, c)];
+		afCol[c][2] = M[rowcol(2, c)];
+		afCol[c][3] = 0.0f;
+		}
+	float32x4_t vCol0 = vld1q_f32(afCol[0]);
+	float32x4_t vCol1 = vld1q_f32(afCol[1]);
+	float32x4_t vCol2 = vld1q_f32(afCol[2]);
+	float32x4_t vCol3 = vld1q_f32(afCol[3]);
+	float32x4_t vW = vld1q_f32(afW);
+	float32x4_t vMin = vdupq_n_f32(HUGE_VALF);
+	float32x4_t vMax = vdupq_n_f32(-HUGE_VALF);
+
+	for (size_t i = 0; i < lNum; i++)
+		{
+		float32x4_t vSrc = vld1q_f32(reinterpret_cast<const float*>(pSrc + i));
+		// Separate multiply and add (not vmla) to round as the scalar code does.
+		float32x4_t vDst = vmulq_f32(vCol0,vdupq_n_f32(vgetq_lane_f32(vSrc,0)));
+		vDst = vaddq_f32(vDst,vmulq_f32(vCol1,vdupq_n_f32(vgetq_lane_f32(vSrc,1))));
+		vDst = vaddq_f32(vDst,vmulq_f32(vCol2,vdupq_n_f32(vgetq_lane_f32(vSrc,2))));
+		vDst = vaddq_f32(vDst,vmulq_f32(vCol3,vdupq_n_f32(vgetq_lane_f32(vSrc,3))));
+		vDst = vaddq_f32(vDst,vW);
+		vst1q_f32(reinterpret_cast<float*>(m_pPts + i),vDst);
+		vMin = vminq_f32(vMin,vDst);
+		vMax = vmaxq_f32(vMax,vDst);
+		}
+
+	float afMin[4], afMax[4];
+	vst1q_f32(afMin,vMin);
+	vst1q_f32(afMax,vMax);
+	m_v3Min = Vector3D(afMin[0],afMin[1],afMin[2]);
+	m_v3Max = Vector3D(afMax[0],afMax[1],afMax[2]);
+#else
+	m_v3Min = Vector3D(HUGE_VALF,HUGE_VALF,HUGE_VALF);
+	m_v3Max = Vector3D(-HUGE_VALF,-HUGE_VALF,-HUGE_VALF);
+	for (size_t i = 0; i < lNum; i++)
+		{
+		tFull.TransformInto(pSrc[i],m_pPts[i]);
+		m_v3Min = Vector3D(MIN(m_v3Min.x(),m_pPts[i].x()),MIN(m_v3Min.y(),m_pPts[i].y()),MIN(m_v3Min.z(),m_pPts[i].z()));
+		m_v3Max = Vector3D(MAX(m_v3Max.x(),m_pPts[i].x()),MAX(m_v3Max.y(),m_pPts[i].y()),MAX(m_v3Max.z(),m_pPts[i].z()));
+		}
+#endif
+
+#if defined(_DEBUG) && (defined(PIPELINE_SSE) || defined(PIPELINE_NEON))
+	// Check the vector path against the scalar one:
+	for (size_t i = 0; i < lNum; i++)
 		{
-      tFull.TransformInto(pPts->points[i],ms_pPts[i]);
-		// Note that you can now use RP3d directly with the renderers! 
+		Vector3D v3Check;
+		tFull.TransformInto(pSrc[i],v3Check);
+		real_t fTolerance = 1.0e-4f * (1.0f + std::fabs(v3Check.x()) + std::fabs(v3Check.y()) + std::fabs(v3Check.z()));
+		ASSERT(std::fabs(v3Check.x() - m_pPts[i].x()) <= fTolerance);
+		ASSERT(std::fabs(v3Check.y() - m_pPts[i].y()) <= fTolerance);
+		ASSERT(std::fabs(v3Check.z() - m_pPts[i].z()) <= fTolerance);
+		ASSERT(m_pPts[i].w() == 1.0f);
 		}
+#endif
 	}
 
 // Need to create a slightly more complex pipe:
@@ -231,12 +339,8 @@ void RPipeLine::TransformShadow(RSop* pPts,RTransform& tObj,
 	// This is hard coded to the postal coordinate system
    tFull.Translate(0.0,m_pimShadowBuf->m_sHeight-m_tScreen.matdata[rowcol(1, 3)],0.0);
 
-   for (size_t i = 0; i < pPts->points.size(); i++)
-		{
-      tFull.TransformInto(pPts->points[i],ms_pPts[i]);
-		// Note that you can now use RP3d directly with the renderers! 
-		}
-
+	TransformPoints(pPts,tFull);
+	// Note that you can now use RP3d directly with the renderers! 
 	}
 
 // returns 0 if pts are ClockWise! (Hidden)
@@ -255,7 +359,7 @@ int16_t RPipeLine::NotCulled(Vector3D *p1,Vector3D *p2,Vector3D *p3)
 	}
 
 // Currently (sDstX,sDstY) allgns with the upper left half of the z-buffer
-// Uses the static transformed point buffer.
+// Uses the transformed point buffer.
 //
 void RPipeLine::Render(RImage* pimDst,int16_t sDstX,int16_t sDstY,
 		RMesh* pMesh,uint8_t ucColor) // wire!
@@ -270,22 +374,29 @@ void RPipeLine::Render(RImage* pimDst,int16_t sDstX,int16_t sDstY,
       v2 = psVertex[i][1];
       v3 = psVertex[i][2];
 
-		if (NotCulled(ms_pPts+v1,ms_pPts+v2,ms_pPts+v3))
+		if (NotCulled(m_pPts+v1,m_pPts+v2,m_pPts+v3))
 			{
 			// Render the sucker!
 			DrawTri_wire(pimDst,sDstX,sDstY,
-				ms_pPts+v1,ms_pPts+v2,ms_pPts+v3,ucColor);
+				m_pPts+v1,m_pPts+v2,m_pPts+v3,ucColor);
 			}
 		else
 			{
 			lNumHidden++; // cull debug
 			}
 		}
+
+	if (pimDst == m_pimClipBuf) // wires aren't bounded, so do it all
+		{
+		m_sClipDirtyX1 = m_sClipDirtyY1 = 0;
+		m_sClipDirtyX2 = m_pimClipBuf->m_sWidth;
+		m_sClipDirtyY2 = m_pimClipBuf->m_sHeight;
+		}
 	//TRACE("Number culled was %i\n",lNumHidden);
 	}
 
 // Currently (sDstX,sDstY) allgns with the upper left half of the z-buffer
-// Uses the static transformed point buffer.
+// Uses the transformed point buffer.
 //
 void RPipeLine::RenderShadow(RImage* pimDst,RMesh* pMesh,uint8_t ucColor)
    {
@@ -298,18 +409,18 @@ void RPipeLine::RenderShadow(RImage* pimDst,RMesh* pMesh,uint8_t ucColor)
      v2 = psVertex[i][1];
      v3 = psVertex[i][2];
 
-		if (NotCulled(ms_pPts+v1,ms_pPts+v2,ms_pPts+v3))
+		if (NotCulled(m_pPts+v1,m_pPts+v2,m_pPts+v3))
 			{
 			// Render the sucker!
 			DrawTri(pimDst->m_pData,pimDst->m_lPitch,
-				ms_pPts+v1,ms_pPts+v2,ms_pPts+v3,ucColor);
+				m_pPts+v1,m_pPts+v2,m_pPts+v3,ucColor);
 			}
 		}
 	}
 
 // YOU clear the z-buffer before this if you so desire!!!
 // Currently (sDstX,sDstY) allgns with the upper left half of the z-buffer
-// Uses the static transformed point buffer.
+// Uses the transformed point buffer.
 //
 void RPipeLine::Render(RImage* pimDst,int16_t sDstX,int16_t sDstY,
 		RMesh* pMesh,RZBuffer* pZB,RTexture* pTexColors,
@@ -329,16 +440,18 @@ void RPipeLine::Render(RImage* pimDst,int16_t sDstX,int16_t sDstY,
      v2 = psVertex[i][1];
      v3 = psVertex[i][2];
 
-		if (1)//NotCulled(ms_pPts+v1,ms_pPts+v2,ms_pPts+v3))
+		if (1)//NotCulled(m_pPts+v1,m_pPts+v2,m_pPts+v3))
 			{
 			// Render the sucker!
 			DrawTri_ZColorFog(pDst,lDstP,
-				ms_pPts+v1,ms_pPts+v2,ms_pPts+v3,pZB,
+				m_pPts+v1,m_pPts+v2,m_pPts+v3,pZB,
 				pAlpha->m_pAlphas[*pColor] + sFogOffset,
 				sOffsetX,		// In: 2D offset for pZB.
 				sOffsetY);	 	// In: 2D offset for pZB.
 			}
 		}
+
+	MarkRendered(pimDst,sDstX,sDstY,pZB,sOffsetX,sOffsetY);
 	}
 
 // YOU clear the z-buffer before this if you so desire!!!
@@ -362,16 +475,59 @@ void RPipeLine::Render(RImage* pimDst,int16_t sDstX,int16_t sDstY,
      v2 = psVertex[i][1];
      v3 = psVertex[i][2];
 
-		if (NotCulled(ms_pPts+v1,ms_pPts+v2,ms_pPts+v3))
+		if (NotCulled(m_pPts+v1,m_pPts+v2,m_pPts+v3))
 			{
 			// Render the sucker!
 			DrawTri_ZColor(pDst,lDstP,
-				ms_pPts+v1,ms_pPts+v2,ms_pPts+v3,pZB,
+				m_pPts+v1,m_pPts+v2,m_pPts+v3,pZB,
 				*pColor,
 				sOffsetX,		// In: 2D offset for pZB.
 				sOffsetY);	 	// In: 2D offset for pZB.
 			}
 		}
+
+	MarkRendered(pimDst,sDstX,sDstY,pZB,sOffsetX,sOffsetY);
+	}
+
+// Triangles stay within the bounds of their points, give or take the
+// fixed point rounding, so pad the transformed bounds a little and note
+// them in the z-buffer (and clip buffer) for the next clear.
+//
+void RPipeLine::MarkRendered(RImage* pimDst,int16_t sDstX,int16_t sDstY,
+		RZBuffer* pZB,int16_t sOffsetX,int16_t sOffsetY)
+	{
+	const real_t fLimit = 16384.0;
+	int16_t sX1 = int16_t(std::floor(MAX(-fLimit,MIN(fLimit,m_v3Min.x())))) - 2;
+	int16_t sY1 = int16_t(std::floor(MAX(-fLimit,MIN(fLimit,m_v3Min.y())))) - 2;
+	int16_t sX2 = int16_t(std::ceil(MAX(-fLimit,MIN(fLimit,m_v3Max.x())))) + 3;
+	int16_t sY2 = int16_t(std::ceil(MAX(-fLimit,MIN(fLimit,m_v3Max.y())))) + 3;
+
+	pZB->MarkDirty(sX1 + sOffsetX,sY1 + sOffsetY,sX2 - sX1,sY2 - sY1);
+
+	if (pimDst == m_pimClipBuf)
+		{
+		int16_t sClipX1 = MAX(int16_t(sX1 + sOffsetX + sDstX),int16_t(0));
+		int16_t sClipY1 = MAX(int16_t(sY1 + sOffsetY + sDstY),int16_t(0));
+		int16_t sClipX2 = MIN(int16_t(sX2 + sOffsetX + sDstX),m_pimClipBuf->m_sWidth);
+		int16_t sClipY2 = MIN(int16_t(sY2 + sOffsetY + sDstY),m_pimClipBuf->m_sHeight);
+		if (sClipX1 < sClipX2 && sClipY1 < sClipY2)
+			{
+			if (m_sClipDirtyX1 >= m_sClipDirtyX2) // nothing dirty yet
+				{
+				m_sClipDirtyX1 = sClipX1;
+				m_sClipDirtyY1 = sClipY1;
+				m_sClipDirtyX2 = sClipX2;
+				m_sClipDirtyY2 = sClipY2;
+				}
+			else
+				{
+				m_sClipDirtyX1 = MIN(m_sClipDirtyX1,sClipX1);
+				m_sClipDirtyY1 = MIN(m_sClipDirtyY1,sClipY1);
+				m_sClipDirtyX2 = MAX(m_sClipDirtyX2,sClipX2);
+				m_sClipDirtyY2 = MAX(m_sClipDirtyY2,sClipY2);
+				}
+			}
+		}
 	}
 
 // THIS IS HACKED!  WILL NOT WORK WITH DISTORTED GUYS!
@@ -410,9 +566,12 @@ void RPipeLine::BoundingSphereToScreen(Vector3D& ptCenter, Vector3D& ptRadius,
 void RPipeLine::ClearClipBuffer()
 	{
 	if (m_pimClipBuf == nullptr) return;
+	if (m_sClipDirtyX1 >= m_sClipDirtyX2) return; // untouched since last time
 
-   rspRect(static_cast<uint32_t>(0),m_pimClipBuf,0,0,
-		m_pimClipBuf->m_sWidth,m_pimClipBuf->m_sHeight);
+   rspRect(static_cast<uint32_t>(0),m_pimClipBuf,m_sClipDirtyX1,m_sClipDirtyY1,
+		m_sClipDirtyX2 - m_sClipDirtyX1,m_sClipDirtyY2 - m_sClipDirtyY1);
+	m_sClipDirtyX1 = m_sClipDirtyY1 = 0;
+	m_sClipDirtyX2 = m_sClipDirtyY2 = 0;
 	}
 
 void RPipeLine::ClearShadowBuffer()
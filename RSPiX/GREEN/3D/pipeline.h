@@ -59,6 +59,9 @@ public:
 	void Transform(RSop* pPts,RTransform& tObj);
 	void TransformShadow(RSop* pPts,RTransform& tObj,
 		int16_t sHeight = 0,int16_t *psOffX = nullptr,int16_t *psOffY = nullptr);
+	// Transform all of pPts into m_pPts by the full transform, four lanes
+	// at a time where the CPU can, and note their bounds:
+	void TransformPoints(RSop* pPts,const RTransform& tFull);
 
 	// Do NOT use a z-buffer.  Return offset to current position to
 	// draw the image m_pimShadowBuf
@@ -91,6 +94,7 @@ public:
 		}
 
 	// Strictly for convenience:
+	// (The clip buffer is only cleared where rendered since the last time.)
 	//
 	void ClearClipBuffer();
 	void ClearShadowBuffer();
@@ -145,12 +149,24 @@ public:
 	int16_t m_sUseBoundingRect;
 
 	//-------------------------------------
-	// static storage:
-
-	// Transformation buffer:
-   static uint32_t ms_lNumPts;
-	static Vector3D* ms_pPts;
-   static uint32_t	ms_lNumPipes; // used to free ms_pPts
+	// Transformation buffer (one per pipe, so separate
+	// pipes can be used from separate threads):
+   size_t m_lNumPts;
+	Vector3D* m_pPts;
+	// Screen space bounds of the last points transformed (w unused):
+	Vector3D m_v3Min;
+	Vector3D m_v3Max;
+	// Area of m_pimClipBuf rendered to since it was last cleared
+	// (end exclusive):
+	int16_t m_sClipDirtyX1;
+	int16_t m_sClipDirtyY1;
+	int16_t m_sClipDirtyX2;
+	int16_t m_sClipDirtyY2;
+
+protected:
+	// Note what a Render() of the last transformed points may have written:
+	void MarkRendered(RImage* pimDst,int16_t sDstX,int16_t sDstY,
+		RZBuffer* pZB,int16_t sOffsetX,int16_t sOffsetY);
 	};
 
 //================================================== 
@@ -26,6 +26,51 @@ struct RRenderPt32 // For internal use
 
 #define UINT16_HALF ((UINT16_MAX + 1) >> 1)
 
+// Z test and draw one fogged span, x1 to x2 inclusive.  lZ is the
+// RFixedS32 z at x1 and lZInc its step per pixel.
+static inline void DrawSpan_ZFog(uint8_t* pDst,
+                                 int16_t* pBufZ,
+                                 int16_t x1,
+                                 int16_t x2,
+                                 int32_t lZ,
+                                 int32_t lZInc,
+                                 uint8_t* pFog)
+{
+  RFixedS32 fz;
+  fz.val = lZ;
+  for (int16_t x = x1; x <= x2; ++x)
+  {
+    if (fz.mod > pBufZ[x] )
+    {
+      pDst[x] = pFog[fz.upper];
+      pBufZ[x] = fz.mod;    // set Z-buffer!
+    }
+    fz.val += lZInc;
+  }
+}
+
+// Z test and draw one flat colored span, x1 to x2 inclusive.
+static inline void DrawSpan_ZColor(uint8_t* pDst,
+                                   int16_t* pBufZ,
+                                   int16_t x1,
+                                   int16_t x2,
+                                   int32_t lZ,
+                                   int32_t lZInc,
+                                   uint8_t ucColor)
+{
+  RFixedS32 fz;
+  fz.val = lZ;
+  for (int16_t x = x1; x <= x2; ++x)
+  {
+    if (fz.mod > pBufZ[x] )
+    {
+      pDst[x] = ucColor;
+      pBufZ[x] = fz.mod;    // set Z-buffer!
+    }
+    fz.val += lZInc;
+  }
+}
+
 // Fog should be offset such that the first index occurs
 // at the minimum z-point of the full3d object being
 // rendered.
@@ -65,6 +110,9 @@ void DrawTri_ZColorFog(uint8_t* pDstOffset,
   pt1.x.frac =
   pt2.x.frac =
   pt3.x.frac = UINT16_HALF; // offset each by 1/2
+  pt1.z.frac =
+  pt2.z.frac =
+  pt3.z.frac = 0; // (was left to whatever was on the stack)
 
   /*
    // Catch the special case of a single pixel
@@ -212,7 +260,7 @@ void DrawTri_ZColorFog(uint8_t* pDstOffset,
   int32_t lZP = pZB->m_lP; // in words!!!
 
   // Draw the upper triangle! (Assuming fx2inc < fx3inc.....)
-  int16_t x,y;
+  int16_t y;
   RFixedS32 fz,fzinc; // for tracing across each scan line:
   int16_t xdel;
 
@@ -278,20 +326,12 @@ void DrawTri_ZColorFog(uint8_t* pDstOffset,
       xdel = x2.mod - x1.mod;
       //if (hzdel) hzinc.val = (z3.val - z2.val) / hzdel;
       // ***************8 flipped the inc value:!
-      if (xdel)
+      if (xdel > 0)
         fzinc.val = int32_t(z2.mod - z1.mod) * RInitNum::OneOver[xdel];
       //if (hzdel) Mul(hzinc,z3.val - z2.val,CInitNum::OneOver[hzdel]);
 
       // Assume 2 to 3:
-      for (x = x1.mod; x<= x2.mod; ++x)
-      {
-        if (fz.mod > pBufZ[x] )
-        {
-          pDst[x] = pFog[fz.upper];// pFog[fz.upper]; // offset for fog
-          pBufZ[x] = fz.mod;    // set Z-buffer!
-        }
-        fz.val += fzinc.val;
-      }
+      DrawSpan_ZFog(pDst,pBufZ,x1.mod,x2.mod,fz.val,fzinc.val,pFog);
     }
 
     return;
@@ -318,19 +358,11 @@ void DrawTri_ZColorFog(uint8_t* pDstOffset,
       fz.mod += sBaseZ; // This is for coloring but it effects true z as well!
       xdel = x3.mod - x2.mod;
       //if (hzdel) hzinc.val = (z3.val - z2.val) / hzdel;
-      if (xdel)
+      if (xdel > 0)
         fzinc.val = uint32_t(z3.mod - z2.mod) * RInitNum::OneOver[xdel];
       //if (hzdel) Mul(hzinc,z3.val - z2.val,CInitNum::OneOver[hzdel]);
       // Assume 2 to 3:
-      for (x = x2.mod; x<= x3.mod; ++x)
-      {
-        if (fz.mod > pBufZ[x] )
-        {
-          pDst[x] = pFog[fz.upper];// pFog[fz.upper];
-          pBufZ[x] = fz.mod;// set Z-buffer!
-        }
-        fz.val += fzinc.val;
-      }
+      DrawSpan_ZFog(pDst,pBufZ,x2.mod,x3.mod,fz.val,fzinc.val,pFog);
     }
 
     //===================================================================
@@ -360,20 +392,12 @@ void DrawTri_ZColorFog(uint8_t* pDstOffset,
         fz.mod += sBaseZ;
         xdel = x3.mod - x2.mod;
         //if (hzdel) hzinc.val = (z3.val - z2.val) / hzdel;
-        if (xdel)
+        if (xdel > 0)
           fzinc.val = int32_t(z3.mod - z2.mod) * RInitNum::OneOver[xdel];
         //if (hzdel) Mul(hzinc,z3.val - z2.val,CInitNum::OneOver[hzdel]);
 
         // Assume 2 to 3:
-        for (x = x2.mod; x<= x3.mod; ++x)
-        {
-          if (fz.mod > pBufZ[x] )
-          {
-            pDst[x] = pFog[fz.upper];// pFog[fz.upper];
-            pBufZ[x] = fz.mod;// set Z-buffer!
-          }
-          fz.val += fzinc.val;
-        }
+        DrawSpan_ZFog(pDst,pBufZ,x2.mod,x3.mod,fz.val,fzinc.val,pFog);
       }
     }
   }
@@ -400,20 +424,12 @@ void DrawTri_ZColorFog(uint8_t* pDstOffset,
 
       xdel = x2.mod - x3.mod; //+ x to z
       //if (hzdel) hzinc.val = (z2.val - z3.val) / hzdel;
-      if (xdel)
+      if (xdel > 0)
         fzinc.val = int32_t(z2.mod - z3.mod) * RInitNum::OneOver[xdel];
       //if (hzdel) Mul(hzinc,z2.val - z3.val,CInitNum::OneOver[hzdel]);
 
       // Assume 2 to 3:
-      for (x = x3.mod; x<= x2.mod; ++x)
-      {
-        if (fz.mod > pBufZ[x] )
-        {
-          pDst[x] = pFog[fz.upper];// pFog[fz.upper];
-          pBufZ[x] = fz.mod;// set Z-buffer!
-        }
-        fz.val += fzinc.val;
-      }
+      DrawSpan_ZFog(pDst,pBufZ,x3.mod,x2.mod,fz.val,fzinc.val,pFog);
     }
 
     //===================================================================
@@ -443,20 +459,12 @@ void DrawTri_ZColorFog(uint8_t* pDstOffset,
         fz.mod += sBaseZ;
         xdel = x2.mod - x3.mod;
         //if (hzdel) hzinc.val = (z2.val - z3.val) / hzdel;
-        if (xdel)
+        if (xdel > 0)
           fzinc.val = uint32_t(z2.mod - z3.mod) * RInitNum::OneOver[xdel];
         // Full accuracy fxMul!
         //if (hzdel) Mul(hzinc,z2.val - z3.val,CInitNum::OneOver[hzdel]);
         // Assume 2 to 3:
-        for (x = x3.mod; x<= x2.mod; ++x)
-        {
-          if (fz.mod > pBufZ[x] )
-          {
-            pDst[x] = pFog[fz.upper];// pFog[fz.upper];
-            pBufZ[x] = fz.mod;// set Z-buffer!
-          }
-          fz.val += fzinc.val;
-        }
+        DrawSpan_ZFog(pDst,pBufZ,x3.mod,x2.mod,fz.val,fzinc.val,pFog);
       }
     }
   }
@@ -522,6 +530,9 @@ void DrawTri_ZColor(uint8_t* pDstOffset,
   pt1.x.frac =
   pt2.x.frac =
   pt3.x.frac = UINT16_HALF; // offset each by 1/2
+  pt1.z.frac =
+  pt2.z.frac =
+  pt3.z.frac = 0; // (was left to whatever was on the stack)
 
   // sort the triangles and choose which mirror case to render.
 
@@ -583,7 +594,7 @@ void DrawTri_ZColor(uint8_t* pDstOffset,
   int32_t lZP = pZB->m_lP; // in words!!!
 
   // Draw the upper triangle! (Assuming fx2inc < fx3inc.....)
-  int16_t x,y;
+  int16_t y;
   RFixedS32 fz,fzinc; // for tracing across each scan line:
   int16_t xdel;
 
@@ -649,20 +660,12 @@ void DrawTri_ZColor(uint8_t* pDstOffset,
       xdel = x2.mod - x1.mod;
       //if (hzdel) hzinc.val = (z3.val - z2.val) / hzdel;
       // ***************8 flipped the inc value:!
-      if (xdel)
+      if (xdel > 0)
         fzinc.val = int32_t(z2.mod - z1.mod) * RInitNum::OneOver[xdel];
       //if (hzdel) Mul(hzinc,z3.val - z2.val,CInitNum::OneOver[hzdel]);
 
       // Assume 2 to 3:
-      for (x = x1.mod; x<= x2.mod; ++x)
-      {
-        if (fz.mod > pBufZ[x] )
-        {
-          pDst[x] = ucFlatColor;// pFog[fz.upper]; // offset for fog
-          pBufZ[x] = fz.mod;    // set Z-buffer!
-        }
-        fz.val += fzinc.val;
-      }
+      DrawSpan_ZColor(pDst,pBufZ,x1.mod,x2.mod,fz.val,fzinc.val,ucFlatColor);
     }
 
     return;
@@ -689,19 +692,11 @@ void DrawTri_ZColor(uint8_t* pDstOffset,
       fz.mod += sBaseZ; // This is for coloring but it effects true z as well!
       xdel = x3.mod - x2.mod;
       //if (hzdel) hzinc.val = (z3.val - z2.val) / hzdel;
-      if (xdel)
+      if (xdel > 0)
         fzinc.val = uint32_t(z3.mod - z2.mod) * RInitNum::OneOver[xdel];
       //if (hzdel) Mul(hzinc,z3.val - z2.val,CInitNum::OneOver[hzdel]);
       // Assume 2 to 3:
-      for (x = x2.mod; x<= x3.mod; ++x)
-      {
-        if (fz.mod > pBufZ[x] )
-        {
-          pDst[x] = ucFlatColor;// pFog[fz.upper];
-          pBufZ[x] = fz.mod;// set Z-buffer!
-        }
-        fz.val += fzinc.val;
-      }
+      DrawSpan_ZColor(pDst,pBufZ,x2.mod,x3.mod,fz.val,fzinc.val,ucFlatColor);
     }
 
     //===================================================================
@@ -731,20 +726,12 @@ void DrawTri_ZColor(uint8_t* pDstOffset,
         fz.mod += sBaseZ;
         xdel = x3.mod - x2.mod;
         //if (hzdel) hzinc.val = (z3.val - z2.val) / hzdel;
-        if (xdel)
+        if (xdel > 0)
           fzinc.val = int32_t(z3.mod - z2.mod) * RInitNum::OneOver[xdel];
         //if (hzdel) Mul(hzinc,z3.val - z2.val,CInitNum::OneOver[hzdel]);
 
         // Assume 2 to 3:
-        for (x = x2.mod; x<= x3.mod; ++x)
-        {
-          if (fz.mod > pBufZ[x] )
-          {
-            pDst[x] = ucFlatColor;// pFog[fz.upper];
-            pBufZ[x] = fz.mod;// set Z-buffer!
-          }
-          fz.val += fzinc.val;
-        }
+        DrawSpan_ZColor(pDst,pBufZ,x2.mod,x3.mod,fz.val,fzinc.val,ucFlatColor);
       }
     }
   }
@@ -772,20 +759,12 @@ void DrawTri_ZColor(uint8_t* pDstOffset,
 
       xdel = x2.mod - x3.mod; //+ x to z
       //if (hzdel) hzinc.val = (z2.val - z3.val) / hzdel;
-      if (xdel)
+      if (xdel > 0)
         fzinc.val = int32_t(z2.mod - z3.mod) * RInitNum::OneOver[xdel];
       //if (hzdel) Mul(hzinc,z2.val - z3.val,CInitNum::OneOver[hzdel]);
 
       // Assume 2 to 3:
-      for (x = x3.mod; x<= x2.mod; ++x)
-      {
-        if (fz.mod > pBufZ[x] )
-        {
-          pDst[x] = ucFlatColor;// pFog[fz.upper];
-          pBufZ[x] = fz.mod;// set Z-buffer!
-        }
-        fz.val += fzinc.val;
-      }
+      DrawSpan_ZColor(pDst,pBufZ,x3.mod,x2.mod,fz.val,fzinc.val,ucFlatColor);
     }
 
     //===================================================================
@@ -816,20 +795,12 @@ void DrawTri_ZColor(uint8_t* pDstOffset,
         fz.mod += sBaseZ;
         xdel = x2.mod - x3.mod;
         //if (hzdel) hzinc.val = (z2.val - z3.val) / hzdel;
-        if (xdel)
+        if (xdel > 0)
           fzinc.val = uint32_t(z2.mod - z3.mod) * RInitNum::OneOver[xdel];
         // Full accuracy fxMul!
         //if (hzdel) Mul(hzinc,z2.val - z3.val,CInitNum::OneOver[hzdel]);
         // Assume 2 to 3:
-        for (x = x3.mod; x<= x2.mod; ++x)
-        {
-          if (fz.mod > pBufZ[x] )
-          {
-            pDst[x] = ucFlatColor;// pFog[fz.upper];
-            pBufZ[x] = fz.mod;// set Z-buffer!
-          }
-          fz.val += fzinc.val;
-        }
+        DrawSpan_ZColor(pDst,pBufZ,x3.mod,x2.mod,fz.val,fzinc.val,ucFlatColor);
       }
     }
   }
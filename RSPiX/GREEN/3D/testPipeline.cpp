@@ -0,0 +1,200 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2016 RWS Inc, All Rights Reserved
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of version 2 of the GNU General Public License as published by
+// the Free Software Foundation
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+//
+// testPipeline.cpp
+//
+// Not part of the game.  Transforms the same random sops by the same random
+// transforms with RPipeLine::TransformPoints() (the vector path, as it is
+// built) and with the plain RTransform::TransformInto() loop it replaces,
+// checks that the points and bounds agree, and times both.  Built and run
+// by the check target of Makefile.gravis:
+//
+//		make -f Makefile.gravis check
+//
+// or by hand, as ./testPipeline [points per sop].  It exits non-zero if the
+// results differ by more than rounding.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include "pipeline.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+// Only the points are transformed (no z-buffer, clip or shadow images, no
+// rendering); these keep images, the blitter and BLUE out of the link.
+RImage::RImage()
+	{
+	}
+
+RImage::~RImage()
+	{
+	}
+
+int16_t RImage::CreateImage(int16_t, int16_t, Type, int32_t, int16_t)
+	{
+	return FAILURE;
+	}
+
+int16_t rspRect(uint32_t, RImage*, int16_t, int16_t, int16_t, int16_t, RRect*)
+	{
+	return FAILURE;
+	}
+
+void rspLine(uint8_t, RImage*, int16_t, int16_t, int16_t, int16_t, const RRect*)
+	{
+	}
+
+channel_t rspMatchColorRGB(channel_t, channel_t, channel_t, uint16_t, uint16_t,
+	channel_t*, channel_t*, channel_t*, std::ptrdiff_t)
+	{
+	return 0;
+	}
+
+void rspTrace(const char* szFrmt, ...)
+	{
+	va_list varp;
+	va_start(varp,szFrmt);
+	vfprintf(stderr,szFrmt,varp);
+	va_end(varp);
+	}
+
+#define TEST_SOPS			64			// Sops (and transforms) per pass
+#define TEST_PASSES		200		// Timed passes (best is kept)
+
+// The loop TransformPoints() runs where there are no vector units.
+static void TransformPlain(
+	const Vector3D* pSrc,					// In:  Points
+	size_t lNum,								// In:  Number of points
+	const RTransform& tFull,				// In:  Transform
+	Vector3D* pDst,							// Out: Transformed points
+	Vector3D& v3Min,							// Out: Their bounds
+	Vector3D& v3Max)
+	{
+	v3Min = Vector3D(HUGE_VALF,HUGE_VALF,HUGE_VALF);
+	v3Max = Vector3D(-HUGE_VALF,-HUGE_VALF,-HUGE_VALF);
+	for (size_t i = 0; i < lNum; i++)
+		{
+		tFull.TransformInto(pSrc[i],pDst[i]);
+		v3Min = Vector3D(MIN(v3Min.x(),pDst[i].x()),MIN(v3Min.y(),pDst[i].y()),MIN(v3Min.z(),pDst[i].z()));
+		v3Max = Vector3D(MAX(v3Max.x(),pDst[i].x()),MAX(v3Max.y(),pDst[i].y()),MAX(v3Max.z(),pDst[i].z()));
+		}
+	}
+
+// True if a is b give or take float rounding (the same test the _DEBUG check
+// in TransformPoints() makes).
+static bool Close(const Vector3D& a,const Vector3D& b)
+	{
+	real_t fTolerance = 1.0e-4f * (1.0f + std::fabs(b.x()) + std::fabs(b.y()) + std::fabs(b.z()));
+	return std::fabs(a.x() - b.x()) <= fTolerance
+		&& std::fabs(a.y() - b.y()) <= fTolerance
+		&& std::fabs(a.z() - b.z()) <= fTolerance;
+	}
+
+int main(int argc,char** argv)
+	{
+	uint32_t ulNumPts = (argc > 1) ? uint32_t(atoi(argv[1])) : 300;
+	ulNumPts = std::max(1u,std::min(ulNumPts,65535u));
+
+	// Build each sop the way one is read from a file: a count and then
+	// the points.
+	std::mt19937 rng(5678);
+	std::uniform_real_distribution<float> fCoord(-50.0f,50.0f);
+	std::uniform_real_distribution<float> fScale(0.5f,4.0f);
+	std::uniform_int_distribution<int16_t> sAngle(0,359);
+	std::vector<RSop> asop(TEST_SOPS);
+	std::vector<RTransform> atrans(TEST_SOPS);
+	std::vector<std::vector<uint8_t>> aau8Files(TEST_SOPS);
+	for (int16_t s = 0; s < TEST_SOPS; s++)
+		{
+		std::vector<uint8_t>& au8File = aau8Files[s];
+		au8File.resize(sizeof(uint32_t) + ulNumPts * sizeof(Vector3D));
+		memcpy(au8File.data(),&ulNumPts,sizeof(uint32_t));
+		Vector3D* pv3 = reinterpret_cast<Vector3D*>(au8File.data() + sizeof(uint32_t));
+		for (uint32_t l = 0; l < ulNumPts; l++)
+			pv3[l] = Vector3D(fCoord(rng),fCoord(rng),fCoord(rng),1.0f);
+		asop[s].setData(au8File.data(),uint32_t(au8File.size()));
+		asop[s].load();
+
+		// Like a realm object: rotate, scale, place, then view and screen.
+		RTransform& trans = atrans[s];
+		trans.makeIdentity();
+		trans.Ry(sAngle(rng));
+		trans.Rz(sAngle(rng));
+		trans.Scale(fScale(rng),fScale(rng),fScale(rng));
+		trans.Translate(fCoord(rng),fCoord(rng),fCoord(rng));
+		trans.Rx(sAngle(rng));
+		trans.Translate(320.0f,240.0f,128.0f);
+		}
+
+	RPipeLine pipe;
+	if (pipe.Create(ulNumPts) != SUCCESS)
+		{
+		fprintf(stderr,"Couldn't create the pipeline.\n");
+		return EXIT_FAILURE;
+		}
+	std::vector<Vector3D> av3Plain(ulNumPts);
+	Vector3D v3PlainMin,v3PlainMax;
+	const Vector3D* apv3Src[TEST_SOPS];
+	for (int16_t s = 0; s < TEST_SOPS; s++)
+		apv3Src[s] = reinterpret_cast<const Vector3D*>(aau8Files[s].data() + sizeof(uint32_t));
+
+	// Check every sop:
+	int32_t lFailures = 0;
+	for (int16_t s = 0; s < TEST_SOPS; s++)
+		{
+		TransformPlain(apv3Src[s],ulNumPts,atrans[s],av3Plain.data(),v3PlainMin,v3PlainMax);
+		pipe.TransformPoints(&asop[s],atrans[s]);
+		for (uint32_t l = 0; l < ulNumPts; l++)
+			{
+			if (!Close(pipe.m_pPts[l],av3Plain[l]) || pipe.m_pPts[l].w() != 1.0f)
+				lFailures++;
+			}
+		if (!Close(pipe.m_v3Min,v3PlainMin) || !Close(pipe.m_v3Max,v3PlainMax))
+			lFailures++;
+		}
+
+	// And time them:
+	double dPlain = 1e30, dVector = 1e30;
+	for (int16_t sPass = 0; sPass < TEST_PASSES; sPass++)
+		{
+		auto start = std::chrono::steady_clock::now();
+		for (int16_t s = 0; s < TEST_SOPS; s++)
+			TransformPlain(apv3Src[s],ulNumPts,atrans[s],av3Plain.data(),v3PlainMin,v3PlainMax);
+		auto mid = std::chrono::steady_clock::now();
+		for (int16_t s = 0; s < TEST_SOPS; s++)
+			pipe.TransformPoints(&asop[s],atrans[s]);
+		auto end = std::chrono::steady_clock::now();
+
+		dPlain = std::min(dPlain,std::chrono::duration<double,std::micro>(mid - start).count());
+		dVector = std::min(dVector,std::chrono::duration<double,std::micro>(end - mid).count());
+		}
+
+	printf("%-18s plain %9.1f us  vector %9.1f us  x%.2f  %s\n",
+		"TransformPoints",dPlain,dVector,dPlain / dVector,
+		lFailures ? "DIFFERENT" : "same");
+
+	pipe.Destroy();
+	return lFailures ? EXIT_FAILURE : EXIT_SUCCESS;
+	}
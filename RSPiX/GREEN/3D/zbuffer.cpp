@@ -19,6 +19,7 @@
 #include <ORANGE/QuickMath/FixedPoint.h>
 #include "zbuffer.h"
 
+#include <algorithm>
 #include <cstdlib>
 
 
@@ -28,6 +29,9 @@ void	RZBuffer::Init()
 	m_sW = m_sH = 0;
 	m_lP = 0;
 	m_pBuf = nullptr;
+	m_sDirtyX1 = m_sDirtyY1 = 0;
+	m_sDirtyX2 = m_sDirtyY2 = 0;
+	m_sClearVal = ZB_MIN_Z;
 	}
 
 RZBuffer::RZBuffer()
@@ -56,6 +60,7 @@ int16_t RZBuffer::Create(int16_t sW,int16_t sH)
    size_t lSize = m_lP * m_sH * sizeof(int16_t);
 	m_pBuf = (int16_t*) malloc(lSize);
 	// you then may clear it, buddy!
+	MarkAllDirty();
 
 	return SUCCESS;
 	}
@@ -79,9 +84,56 @@ int16_t RZBuffer::Destroy()
 	return SUCCESS;
 	}
 
+//----------------------------------------------
+void RZBuffer::MarkDirty(int16_t sX,int16_t sY,int16_t sW,int16_t sH)
+	{
+	int16_t sX2 = MIN(int16_t(sX + sW),m_sW);
+	int16_t sY2 = MIN(int16_t(sY + sH),m_sH);
+	sX = MAX(sX,int16_t(0));
+	sY = MAX(sY,int16_t(0));
+	if (sX >= sX2 || sY >= sY2) return;
+
+	if (m_sDirtyX1 >= m_sDirtyX2) // nothing dirty yet
+		{
+		m_sDirtyX1 = sX;
+		m_sDirtyY1 = sY;
+		m_sDirtyX2 = sX2;
+		m_sDirtyY2 = sY2;
+		}
+	else
+		{
+		m_sDirtyX1 = MIN(m_sDirtyX1,sX);
+		m_sDirtyY1 = MIN(m_sDirtyY1,sY);
+		m_sDirtyX2 = MAX(m_sDirtyX2,sX2);
+		m_sDirtyY2 = MAX(m_sDirtyY2,sY2);
+		}
+	}
+
 //----------------------------------------------
 void RZBuffer::Clear(int16_t sVal)
 	{
+	// A different value means every word changes:
+	if (sVal != m_sClearVal)
+		{
+		MarkAllDirty();
+		m_sClearVal = sVal;
+		}
+
+	if (m_sDirtyX1 >= m_sDirtyX2) return; // untouched since last time
+
+	// Partial clears go by rows:
+	if (m_sDirtyX1 > 0 || m_sDirtyX2 < m_sW || m_sDirtyY1 > 0 || m_sDirtyY2 < m_sH)
+		{
+		int16_t* pRow = m_pBuf + m_lP * m_sDirtyY1 + m_sDirtyX1;
+		for (int16_t y = m_sDirtyY1; y < m_sDirtyY2; y++,pRow += m_lP)
+			std::fill(pRow,pRow + (m_sDirtyX2 - m_sDirtyX1),sVal);
+
+		m_sDirtyX1 = m_sDirtyY1 = m_sDirtyX2 = m_sDirtyY2 = 0;
+		return;
+		}
+
+	m_sDirtyX1 = m_sDirtyY1 = m_sDirtyX2 = m_sDirtyY2 = 0;
+
 	// Do by 64-bit longs
 	// 1) Create the 64-bit long
 	union
@@ -36,6 +36,13 @@ public:
 	int16_t m_sH;
 	int32_t m_lP; // pitch in WORDS! (Not a real pitch!)
 	int16_t* m_pBuf; // for now, don't have great need for alignment!
+	// Area that may have been written since the last Clear() (end exclusive).
+	// Whoever writes to m_pBuf must report it with MarkDirty():
+	int16_t m_sDirtyX1;
+	int16_t m_sDirtyY1;
+	int16_t m_sDirtyX2;
+	int16_t m_sDirtyY2;
+	int16_t m_sClearVal; // value of the last Clear()
 	//----------------------------------------------
 	void	Init();
 	RZBuffer();
@@ -44,7 +51,11 @@ public:
 	~RZBuffer();
 	int16_t Destroy();
 	//----------------------------------------------
+	// Only clears the dirty area, unless the value changed:
 	void Clear(int16_t sVal = ZB_MIN_Z);
+	// Note an area as written (clipped to the buffer):
+	void MarkDirty(int16_t sX,int16_t sY,int16_t sW,int16_t sH);
+	void MarkAllDirty() { MarkDirty(0,0,m_sW,m_sH); }
 	//----------------------------------------------
    int16_t* GetZPtr(int16_t sX,int16_t sY) { return (m_pBuf + sX + m_lP*sY); }
 #ifdef UNUSED_FUNCTIONS
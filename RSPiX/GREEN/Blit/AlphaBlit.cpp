@@ -34,6 +34,151 @@
 #include <GREEN/Blit/Blit.h>
 #include <ORANGE/color/colormatch.h>
 
+#include <cstring>
+
+// The masked alpha blits look at 16 mask bytes at a time where the CPU has
+// the vectors for it, to skip transparent runs and copy opaque ones.  Define
+// ALPHABLIT_NO_SIMD to always go a pixel at a time.
+#if !defined(ALPHABLIT_NO_SIMD) && (defined(__SSE2__) || defined(_M_X64))
+	#include <emmintrin.h>
+	#define ALPHABLIT_SSE2
+#elif !defined(ALPHABLIT_NO_SIMD) && defined(__aarch64__)
+	#include <arm_neon.h>
+	#define ALPHABLIT_NEON
+#endif
+
+#if defined(ALPHABLIT_SSE2) || defined(ALPHABLIT_NEON)
+// After this many 16 pixel runs in a row with mixed mask levels, a row gives
+// up on runs and does the rest of itself a pixel at a time, so noisy masks
+// don't pay for the checks.
+#define ALPHABLIT_MAX_MIXED_RUNS	4
+
+// Bit n set for each of the 16 bytes that is at least ucMin.
+inline uint32_t AlphaAtLeast16(const uint8_t* pBytes,uint8_t ucMin)
+	{
+#if defined(ALPHABLIT_SSE2)
+	__m128i	bytes	= _mm_loadu_si128((const __m128i*)pBytes);
+	return uint32_t(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_max_epu8(bytes, _mm_set1_epi8(char(ucMin))), bytes)));
+#else
+	static const uint8_t aucBits[16] = { 1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128 };
+	uint8x16_t	atleast	= vandq_u8(vcgeq_u8(vld1q_u8(pBytes), vdupq_n_u8(ucMin)), vld1q_u8(aucBits));
+	return uint32_t(vaddv_u8(vget_low_u8(atleast))) | (uint32_t(vaddv_u8(vget_high_u8(atleast))) << 8);
+#endif
+	}
+
+// true if all 16 mask bytes are the same.
+inline bool AlphaSame16(const uint8_t* pMask)
+	{
+#if defined(ALPHABLIT_SSE2)
+	__m128i	mask	= _mm_loadu_si128((const __m128i*)pMask);
+	return _mm_movemask_epi8(_mm_cmpeq_epi8(mask, _mm_set1_epi8(char(pMask[0])))) == 0xFFFF;
+#else
+	return vminvq_u8(vceqq_u8(vld1q_u8(pMask), vdupq_n_u8(pMask[0]))) == 0xFF;
+#endif
+	}
+#endif
+
+// Alpha blend pixels [i, sEnd) of one row a pixel at a time, as the masked
+// alpha blits below always used to.
+template <bool bDim,bool bSkipZero>
+inline void AlphaBlitPixels(
+	uint8_t* pDst,					// BMP8 destination row
+	const uint8_t* pSrc,			// BMP8 source row
+	const uint8_t* pMask,		// BMP8 alpha channel mask row
+	int16_t i,						// First pixel
+	int16_t sEnd,					// One past the last pixel
+	uint8_t*** pppucAlphaList,	// Table for each mask level (nullptr = opaque)
+	uint8_t ucTransparent,		// Mask levels below this are transparent
+	const uint8_t* pucDim)		// Dimming for mask levels (if bDim)
+	{
+	for (;i < sEnd;i++)
+		{
+		uint8_t ucSrc = pSrc[i];
+		if (bSkipZero && ucSrc == 0) continue;
+
+		uint8_t ucMask = bDim ? pucDim[pMask[i]] : pMask[i];
+		if (ucMask >= ucTransparent)
+			{
+			uint8_t** ppucAlpha = pppucAlphaList[ucMask];
+			if (ppucAlpha) // There is an alpha channel
+				{
+				ASSERT(ppucAlpha[ucSrc]); // catch source errors
+				pDst[i] = ppucAlpha[ucSrc][pDst[i]];
+				}
+			else // it is opaque
+				{
+				pDst[i] = ucSrc;
+				}
+			}
+		}
+	}
+
+// Alpha blend one row through a multialpha (or fast multialpha) table list.
+// Runs of 16 pixels whose mask is all at one level are done with one table
+// lookup for the level (skipped if transparent, copied if opaque), and, when
+// not dimming, runs that are all transparent are skipped.  The tables are 64K
+// each and reached through row pointers, so the lookups themselves are still
+// one at a time.  Rows whose masks keep changing level fall back to going a
+// pixel at a time (see ALPHABLIT_MAX_MIXED_RUNS).
+template <bool bDim,bool bSkipZero>
+static void AlphaBlitRow(
+	uint8_t* pDst,					// BMP8 destination row
+	const uint8_t* pSrc,			// BMP8 source row
+	const uint8_t* pMask,		// BMP8 alpha channel mask row
+	int16_t sW,						// Pixels in the row
+	uint8_t*** pppucAlphaList,	// Table for each mask level (nullptr = opaque)
+	uint8_t ucTransparent,		// Mask levels below this are transparent
+	const uint8_t* pucDim)		// Dimming for mask levels (if bDim)
+	{
+	int16_t i = 0;
+
+#if defined(ALPHABLIT_SSE2) || defined(ALPHABLIT_NEON)
+	int16_t sMixedRuns = 0;
+	for (;i + 16 <= sW && sMixedRuns < ALPHABLIT_MAX_MIXED_RUNS;i += 16)
+		{
+		if (AlphaSame16(pMask + i))
+			{
+			sMixedRuns = 0;
+			uint8_t ucMask = bDim ? pucDim[pMask[i]] : pMask[i];
+			if (ucMask < ucTransparent) continue; // all transparent
+
+			uint8_t** ppucAlpha = pppucAlphaList[ucMask];
+			if (ppucAlpha) // all at one alpha level
+				{
+				for (int16_t k = i;k < i + 16;k++)
+					{
+					uint8_t ucSrc = pSrc[k];
+					if (bSkipZero && ucSrc == 0) continue;
+					ASSERT(ppucAlpha[ucSrc]); // catch source errors
+					pDst[k] = ppucAlpha[ucSrc][pDst[k]];
+					}
+				}
+			else if (!bSkipZero || AlphaAtLeast16(pSrc + i,1) == 0xFFFF) // all opaque
+				{
+				memcpy(pDst + i,pSrc + i,16);
+				}
+			else // opaque with holes
+				{
+				for (int16_t k = i;k < i + 16;k++)
+					if (pSrc[k]) pDst[k] = pSrc[k];
+				}
+			continue;
+			}
+
+		if (!bDim && AlphaAtLeast16(pMask + i,ucTransparent) == 0) // all transparent
+			{
+			sMixedRuns = 0;
+			continue;
+			}
+
+		sMixedRuns++;
+		AlphaBlitPixels<bDim,bSkipZero>(pDst,pSrc,pMask,i,i + 16,pppucAlphaList,ucTransparent,pucDim);
+		}
+#endif
+
+	AlphaBlitPixels<bDim,bSkipZero>(pDst,pSrc,pMask,i,sW,pppucAlphaList,ucTransparent,pucDim);
+	}
+
 /////////////////////////////////////////////////////////////////////////////////////
 //  Allows "Ad Hoc" alpha adjustment with accumulative error.
 //  (CAUTION, not reversable, UNLESS a DIFFERENT destination
@@ -81,13 +226,13 @@ void rspGeneralAlphaBlit(RMultiAlpha* pX,RImage* pimMask,
 	if (rspSimpleClip(sSrcX,sSrcY,sDstX,sDstY,sDstW,sDstH,
 		rDstClip.sX,rDstClip.sY,rDstClip.sW,rDstClip.sH) == -1) return ; // clipped out
 	
-	int16_t i,j;
+	int16_t j;
 	int32_t lSrcP = pimSrc->m_lPitch;
 	int32_t lDstP = pimDst->m_lPitch;
 	int32_t lMaskP = pimMask->m_lPitch;
-	uint8_t* pSrc,*pSrcLine = pimSrc->m_pData + sSrcX + sSrcY * lSrcP;
-	uint8_t* pMask,*pMaskLine = pimMask->m_pData + sSrcX + sSrcY * lSrcP;
-	uint8_t* pDst,*pDstLine = pimDst->m_pData + sDstX + lDstP * sDstY;
+	uint8_t* pSrcLine = pimSrc->m_pData + sSrcX + sSrcY * lSrcP;
+	uint8_t* pMaskLine = pimMask->m_pData + sSrcX + sSrcY * lSrcP;
+	uint8_t* pDstLine = pimDst->m_pData + sDstX + lDstP * sDstY;
 	uint8_t*** pppucAlphaList = pX->m_pGeneralAlpha;
 	uint8_t ucTransparent = *(pX->m_pLevelOpacity);
 	// set clip off at half lowest level value!
@@ -96,28 +241,7 @@ void rspGeneralAlphaBlit(RMultiAlpha* pX,RImage* pimMask,
 
 	for (j=0;j<sDstH;j++,pSrcLine += lSrcP,pDstLine += lDstP,pMaskLine += lMaskP)
 		{
-		pSrc = pSrcLine;
-		pDst = pDstLine;
-		pMask = pMaskLine;
-		uint8_t ucMask;
-		uint8_t** pucTable;
-
-		for (i=0;i<sDstW;i++,pSrc++,pDst++,pMask++)
-			{
-			ucMask = *pMask;
-			if (ucMask >= ucTransparent)
-				{
-				pucTable = pppucAlphaList[ucMask];
-				if (pucTable) // There is an alpha channel
-					{
-					*pDst = pucTable[*pSrc][*pDst];
-					}
-				else // it is opaque
-					{
-					*pDst = *pSrc;
-					}
-				}
-			}
+		AlphaBlitRow<false,false>(pDstLine,pSrcLine,pMaskLine,sDstW,pppucAlphaList,ucTransparent,nullptr);
 		}
 	}
 
@@ -135,13 +259,13 @@ void rspGeneralAlphaBlit(uint8_t sLevel,RMultiAlpha* pX,RImage* pimMask,
 	if (rspSimpleClip(sSrcX,sSrcY,sDstX,sDstY,sDstW,sDstH,
 		rDstClip.sX,rDstClip.sY,rDstClip.sW,rDstClip.sH) == -1) return ; // clipped out
 	
-	int16_t i,j;
+	int16_t j;
 	int32_t lSrcP = pimSrc->m_lPitch;
 	int32_t lDstP = pimDst->m_lPitch;
 	int32_t lMaskP = pimMask->m_lPitch;
-	uint8_t* pSrc,*pSrcLine = pimSrc->m_pData + sSrcX + sSrcY * lSrcP;
-	uint8_t* pMask,*pMaskLine = pimMask->m_pData + sSrcX + sSrcY * lSrcP;
-	uint8_t* pDst,*pDstLine = pimDst->m_pData + sDstX + lDstP * sDstY;
+	uint8_t* pSrcLine = pimSrc->m_pData + sSrcX + sSrcY * lSrcP;
+	uint8_t* pMaskLine = pimMask->m_pData + sSrcX + sSrcY * lSrcP;
+	uint8_t* pDstLine = pimDst->m_pData + sDstX + lDstP * sDstY;
 	uint8_t*** pppucAlphaList = pX->m_pGeneralAlpha;
 	uint8_t ucTransparent = *(pX->m_pLevelOpacity);
 	// set clip off at half lowest level value!
@@ -152,28 +276,7 @@ void rspGeneralAlphaBlit(uint8_t sLevel,RMultiAlpha* pX,RImage* pimMask,
 
 	for (j=0;j<sDstH;j++,pSrcLine += lSrcP,pDstLine += lDstP,pMaskLine += lMaskP)
 		{
-		pSrc = pSrcLine;
-		pDst = pDstLine;
-		pMask = pMaskLine;
-		uint8_t ucMask;
-		uint8_t** pucTable;
-
-		for (i=0;i<sDstW;i++,pSrc++,pDst++,pMask++)
-			{
-			ucMask = pucDim[*pMask]; // do the dynamic dimming!
-			if (ucMask >= ucTransparent)
-				{
-				pucTable = pppucAlphaList[ucMask];
-				if (pucTable) // There is an alpha channel
-					{
-					*pDst = pucTable[*pSrc][*pDst];
-					}
-				else // it is opaque
-					{
-					*pDst = *pSrc;
-					}
-				}
-			}
+		AlphaBlitRow<true,false>(pDstLine,pSrcLine,pMaskLine,sDstW,pppucAlphaList,ucTransparent,pucDim);
 		}
 	}
 
@@ -191,13 +294,13 @@ extern void rspGeneralAlphaBlitT(uint8_t sLevel,RMultiAlpha* pX,RImage* pimMask,
 	if (rspSimpleClip(sSrcX,sSrcY,sDstX,sDstY,sDstW,sDstH,
 		rDstClip.sX,rDstClip.sY,rDstClip.sW,rDstClip.sH) == -1) return ; // clipped out
 	
-	int16_t i,j;
+	int16_t j;
 	int32_t lSrcP = pimSrc->m_lPitch;
 	int32_t lDstP = pimDst->m_lPitch;
 	int32_t lMaskP = pimMask->m_lPitch;
-	uint8_t* pSrc,*pSrcLine = pimSrc->m_pData + sSrcX + sSrcY * lSrcP;
-	uint8_t* pMask,*pMaskLine = pimMask->m_pData + sSrcX + sSrcY * lSrcP;
-	uint8_t* pDst,*pDstLine = pimDst->m_pData + sDstX + lDstP * sDstY;
+	uint8_t* pSrcLine = pimSrc->m_pData + sSrcX + sSrcY * lSrcP;
+	uint8_t* pMaskLine = pimMask->m_pData + sSrcX + sSrcY * lSrcP;
+	uint8_t* pDstLine = pimDst->m_pData + sDstX + lDstP * sDstY;
 	uint8_t*** pppucAlphaList = pX->m_pGeneralAlpha;
 	uint8_t ucTransparent = *(pX->m_pLevelOpacity);
 	// set clip off at half lowest level value!
@@ -208,32 +311,7 @@ extern void rspGeneralAlphaBlitT(uint8_t sLevel,RMultiAlpha* pX,RImage* pimMask,
 
 	for (j=0;j<sDstH;j++,pSrcLine += lSrcP,pDstLine += lDstP,pMaskLine += lMaskP)
 		{
-		pSrc = pSrcLine;
-		pDst = pDstLine;
-		pMask = pMaskLine;
-		uint8_t ucMask;
-		uint8_t** pucTable;
-
-		for (i=0;i<sDstW;i++,pSrc++,pDst++,pMask++)
-			{
-			uint8_t ucSrc = *pSrc;
-			if (ucSrc)
-				{
-				ucMask = pucDim[*pMask]; // do the dynamic dimming!
-				if (ucMask >= ucTransparent)
-					{
-					pucTable = pppucAlphaList[ucMask];
-					if (pucTable) // There is an alpha channel
-						{
-						*pDst = pucTable[*pSrc][*pDst];
-						}
-					else // it is opaque
-						{
-						*pDst = *pSrc;
-						}
-					}
-				}
-			}
+		AlphaBlitRow<true,true>(pDstLine,pSrcLine,pMaskLine,sDstW,pppucAlphaList,ucTransparent,pucDim);
 		}
 	}
 
@@ -252,42 +330,20 @@ void rspFastMaskAlphaBlit(uint8_t*** pfaX,RImage* pimMask,
 	if (rspSimpleClip(sSrcX,sSrcY,sDstX,sDstY,sDstW,sDstH,
 		rDstClip.sX,rDstClip.sY,rDstClip.sW,rDstClip.sH) == -1) return ; // clipped out
 	
-	int16_t i,j;
+	int16_t j;
 	int32_t lSrcP = pimSrc->m_lPitch;
 	int32_t lDstP = pimDst->m_lPitch;
 	int32_t lMaskP = pimMask->m_lPitch;
 
-	uint8_t* pSrc,*pSrcLine = pimSrc->m_pData + sSrcX + sSrcY * lSrcP;
-	uint8_t* pMask,*pMaskLine = pimMask->m_pData + sSrcX + sSrcY * lSrcP;
-	uint8_t* pDst,*pDstLine = pimDst->m_pData + sDstX + lDstP * sDstY;
+	uint8_t* pSrcLine = pimSrc->m_pData + sSrcX + sSrcY * lSrcP;
+	uint8_t* pMaskLine = pimMask->m_pData + sSrcX + sSrcY * lSrcP;
+	uint8_t* pDstLine = pimDst->m_pData + sDstX + lDstP * sDstY;
 
    uint8_t ucTransparent = *reinterpret_cast<uint8_t*>(pfaX); // secret code!
 
 	for (j=0;j<sDstH;j++,pSrcLine += lSrcP,pDstLine += lDstP,pMaskLine += lMaskP)
 		{
-		pSrc = pSrcLine;
-		pDst = pDstLine;
-		pMask = pMaskLine;
-		uint8_t ucMask;
-		uint8_t** pucTable;
-
-		for (i=0;i<sDstW;i++,pSrc++,pDst++,pMask++)
-			{
-			ucMask = *pMask;
-			if (ucMask >= ucTransparent)
-				{
-				pucTable = pfaX[ucMask];
-				if (pucTable) // There is an alpha channel
-					{
-					ASSERT(pucTable[*pSrc]); // catch source errors
-					*pDst = *(pucTable[*pSrc] + *pDst);
-					}
-				else // it is opaque
-					{
-					*pDst = *pSrc;
-					}
-				}
-			}
+		AlphaBlitRow<false,false>(pDstLine,pSrcLine,pMaskLine,sDstW,pfaX,ucTransparent,nullptr);
 		}
 	}
 
@@ -308,46 +364,20 @@ void rspFastMaskAlphaBlitT(uint8_t*** pfaX,RImage* pimMask,
 	if (rspSimpleClip(sSrcX,sSrcY,sDstX,sDstY,sDstW,sDstH,
 		rDstClip.sX,rDstClip.sY,rDstClip.sW,rDstClip.sH) == -1) return ; // clipped out
 	
-	int16_t i,j;
+	int16_t j;
 	int32_t lSrcP = pimSrc->m_lPitch;
 	int32_t lDstP = pimDst->m_lPitch;
 	int32_t lMaskP = pimMask->m_lPitch;
 
-	uint8_t* pSrc,*pSrcLine = pimSrc->m_pData + sSrcX + sSrcY * lSrcP;
-	uint8_t* pMask,*pMaskLine = pimMask->m_pData + sSrcX + sSrcY * lSrcP;
-	uint8_t* pDst,*pDstLine = pimDst->m_pData + sDstX + lDstP * sDstY;
+	uint8_t* pSrcLine = pimSrc->m_pData + sSrcX + sSrcY * lSrcP;
+	uint8_t* pMaskLine = pimMask->m_pData + sSrcX + sSrcY * lSrcP;
+	uint8_t* pDstLine = pimDst->m_pData + sDstX + lDstP * sDstY;
 
    uint8_t ucTransparent = *reinterpret_cast<uint8_t*>(pfaX); // secret code!
 
 	for (j=0;j<sDstH;j++,pSrcLine += lSrcP,pDstLine += lDstP,pMaskLine += lMaskP)
 		{
-		pSrc = pSrcLine;
-		pDst = pDstLine;
-		pMask = pMaskLine;
-		uint8_t ucMask;
-		uint8_t** pucTable;
-
-		for (i=0;i<sDstW;i++,pSrc++,pDst++,pMask++)
-			{
-			uint8_t ucPix = *pSrc;
-			if (ucPix)
-				{
-				ucMask = *pMask;
-				if (ucMask >= ucTransparent)
-					{
-					pucTable = pfaX[ucMask];
-					if (pucTable) // There is an alpha channel
-						{
-						ASSERT(pucTable[ucPix]); // catch source errors
-						*pDst = *(pucTable[ucPix] + *pDst);
-						}
-					else // it is opaque
-						{
-						*pDst = ucPix;
-						}
-					}
-				}
-			}
+		AlphaBlitRow<false,true>(pDstLine,pSrcLine,pMaskLine,sDstW,pfaX,ucTransparent,nullptr);
 		}
 	}
 
@@ -58,6 +58,112 @@ IMAGELINKLATE(FSPR8,ConvertToFSPR8,ConvertFromFSPR8,
 
 //------------------------------------------------------------------------
 
+// Copy an opaque run with the widest moves that fit, letting the last move
+// overlap the one before it rather than finishing a byte at a time.
+// sLen must be at least 1.
+inline void CopyFSPR8Run(uint8_t* pDst,const uint8_t* pSrc,int16_t sLen)
+	{
+	if (sLen >= 16)
+		{
+		int16_t i;
+		for (i = 0;i + 16 <= sLen;i += 16) memcpy(pDst + i,pSrc + i,16);
+		if (i < sLen) memcpy(pDst + sLen - 16,pSrc + sLen - 16,16);
+		}
+	else if (sLen >= 8)
+		{
+		memcpy(pDst,pSrc,8);
+		memcpy(pDst + sLen - 8,pSrc + sLen - 8,8);
+		}
+	else if (sLen >= 4)
+		{
+		memcpy(pDst,pSrc,4);
+		memcpy(pDst + sLen - 4,pSrc + sLen - 4,4);
+		}
+	else
+		{
+		pDst[0] = pSrc[0];
+		pDst[sLen - 1] = pSrc[sLen - 1];
+		pDst[sLen >> 1] = pSrc[sLen >> 1];
+		}
+	}
+
+//------------------------------------------------------------------------
+
+// Decode a whole scanline.  pDst is where source x 0 goes.
+inline void BlitFSPR8Line(uint8_t* pDst,const uint8_t* pSrc,const uint8_t* pCB)
+	{
+	uint8_t ucCode;
+	while ((ucCode = *(pCB++)) != 0xFF)	// Clear run, or end of line code
+		{
+		pDst += ucCode;						// Skip
+		ucCode = *(pCB++);					// Opaque run
+		if (ucCode)
+			{
+			CopyFSPR8Run(pDst,pSrc,ucCode);
+			pDst += ucCode;
+			pSrc += ucCode;
+			}
+		}
+	}
+
+//------------------------------------------------------------------------
+
+// Decode source x sL up to (not including) sR of a scanline.  pDst is where
+// source x sL goes.
+inline void BlitFSPR8LineClipped(uint8_t* pDst,const uint8_t* pSrc,const uint8_t* pCB,
+											int16_t sL,int16_t sR)
+	{
+	int16_t	sX = 0;
+	uint8_t	ucCode;
+	while ((ucCode = *(pCB++)) != 0xFF)	// Clear run, or end of line code
+		{
+		sX += ucCode;
+		if (sX >= sR) return;				// The rest is clipped out
+		ucCode = *(pCB++);					// Opaque run
+		int16_t	sFrom = MAX(sX,sL);
+		int16_t	sTo = MIN(int16_t(sX + ucCode),sR);
+		if (sFrom < sTo) CopyFSPR8Run(pDst + sFrom - sL,pSrc + sFrom - sX,sTo - sFrom);
+		pSrc += ucCode;
+		sX += ucCode;
+		}
+	}
+
+//------------------------------------------------------------------------
+
+// Note where each scanline's opaque pixels start and end, so the BLiT can
+// tell which scanlines clipping touches without decoding them.
+static void SetFSPR8RowSpans(RImage* pImage)
+	{
+	RSpecialFSPR8* pSpec = (RSpecialFSPR8*) pImage->m_pSpecial;
+	pSpec->m_psRowSpan = (int16_t*)calloc(size_t(pImage->m_sHeight) * 2,sizeof(int16_t));
+
+	for (int16_t y = 0;y < pImage->m_sHeight;y++)
+		{
+		const uint8_t*	pCB = pSpec->m_pCodeArry[y];
+		int16_t	sX = 0,sL = -1,sR = 0;
+		uint8_t	ucCode;
+		while ((ucCode = *(pCB++)) != 0xFF)
+			{
+			sX += ucCode;
+			ucCode = *(pCB++);
+			if (ucCode)
+				{
+				if (sL < 0) sL = sX;
+				sX += ucCode;
+				sR = sX;
+				}
+			}
+
+		if (sL >= 0)
+			{
+			pSpec->m_psRowSpan[y * 2] = sL;
+			pSpec->m_psRowSpan[y * 2 + 1] = sR;
+			}
+		}
+	}
+
+//------------------------------------------------------------------------
+
 int16_t		DeleteFSPR8(RImage* pImage)
 	{
 	if (pImage->m_pSpecial != nullptr)
@@ -211,6 +317,8 @@ int16_t		LoadFSPR8(RImage* pImage, RFile* pcf)
 		pSpec->m_pCodeArry[i] = pSpec->m_pCodeBuf + lOffset;
 		}
 
+	SetFSPR8RowSpans(pImage);
+
 	return SUCCESS;
 	}
 
@@ -232,39 +340,13 @@ int16_t   ConvertFromFSPR8(RImage* pImage)
 
 	// BLiT Into the buffer!
 	uint8_t*	pDstLine = pImage->m_pData; // centered at 0,0
-	uint8_t*	pDst;
 
 	int16_t	sY=0;
 	RSpecialFSPR8* pInfo = (RSpecialFSPR8*) pImage->m_pSpecial;
 
-	uint8_t		ucCode;
-	uint8_t*	pSrc;
-	uint8_t*	pCB;
-
 	for (sY = 0; sY < pImage->m_sHeight; sY++,pDstLine += pImage->m_lPitch)
 		{
-		pSrc = pInfo->m_pBufArry[sY];
-		pDst = pDstLine;
-		pCB = pInfo->m_pCodeArry[sY];
-
-	NextCode3:
-
-		//==============================================================	
-		// 1) Do the clear run:
-		ucCode = *(pCB)++;	// Get Skip Length
-      if (ucCode == 0xFF)
-        continue;// End of line code
-		pDst += ucCode;		// Skip
-		
-		//==============================================================	
-		// 2) Do the opaque run:
-		ucCode = *(pCB)++;			// Get Skip Length
-		if (!ucCode) goto NextCode3;
-		
-		do	*(pDst++) = *(pSrc++);	// Copy pixel
-		while (--ucCode);	
-		
-		goto NextCode3;
+		BlitFSPR8Line(pDstLine,pInfo->m_pBufArry[sY],pInfo->m_pCodeArry[sY]);
 		}
 	//==============================================================	
 	// Now finish your job:
@@ -503,6 +585,8 @@ int16_t   ConvertToFSPR8(RImage*  pImage)
 	pImage->m_type = RImage::FSPR8;
 	pImage->m_ulSize = 0;	// BLiT needs to deal with copying, etc....
 
+	SetFSPR8RowSpans(pImage);
+
 	return RImage::FSPR8;
 	}
 
@@ -670,262 +754,25 @@ int16_t	rspBlit(RImage* pimSrc,RImage* pimDst,int16_t sDstX,int16_t sDstY,const
 		}
 
 
-	// Right now, pDst refers to the CLIPPED start of the scanline:
+	// Right now, pDstLine refers to the CLIPPED start of the scanline:
 	uint8_t*	pDstLine = pimDst->m_pData + sDstX + sDstY * pimDst->m_lPitch;
-	uint8_t*	pDst;
 
 	int16_t	sY=0;
 	RSpecialFSPR8* pInfo = (RSpecialFSPR8*) pimSrc->m_pSpecial;
+	const int16_t* psSpan = pInfo->m_psRowSpan + sSrcY * 2;
+	int16_t	sSrcR = sSrcX + sW; // one past the last source x to show
 
-	uint8_t	ucCode;
-	uint8_t*	pSrc;
-	uint8_t*	pCB;
-	int16_t sClipWidth;
-
-	//
-	if (sSrcX > 0)	// LClip Situation! => The slowest!
+	for (sY = sSrcY; sY < sSrcY + sH; sY++,pDstLine += lDstP,psSpan += 2)
 		{
-		// **** THE WORST OF ALL CASES!  TWO SIDED CLIPPING! ****
-		if (sW < (pimSrc->m_sWidth - sSrcX) )
-			{
-			for (sY = sSrcY; sY < sSrcY + sH; sY++,pDstLine += lDstP)
-				{	// Clip off left side:
-				pSrc = pInfo->m_pBufArry[sY];
-				pDst = pDstLine;
-				pCB = pInfo->m_pCodeArry[sY];
-				sClipWidth = sW; //sSrcX; // initial source...
-				int16_t sLeftClip = sSrcX;
-
-			NextSkip2S:
-				//==============================================================	
-				// 1) Skip a clear run?
-				ucCode = *(pCB++); // Get skip length
-            if (ucCode == 0xFF)
-              continue; // End of line code
-
-				// Don't update pDst until you are done skipping!
-				if ((sLeftClip -= ucCode) < 0) 
-					{
-					pDst -= sLeftClip; // NOW advance pDst the remainder of the skip
-					sClipWidth += sLeftClip; // and REDUCE what's left by remainder of skip!
-					if (sClipWidth <= 0)	// done line already?
-						{
-						// must jump past rest of code line
-						do	{
-							ucCode = *(pCB++); // opaque run
-							ucCode = *(pCB++); // clear run
-                     } while (ucCode != 0xFF);
-
-						continue; // start next line!
-						}
-
-					goto NormalOpaque2S;// We're done being clipped
-					}
-
-				//==============================================================	
-				// 2) Skip an opaque run?
-				ucCode = *(pCB++); // Get skip length
-
-				if (ucCode < sLeftClip) 
-					{
-					sLeftClip -= ucCode; // Adance both pointers, but don't copy!
-					pSrc += ucCode;		// Always need to advance source in an opaque run
-					//pDst += ucCode; // don't move the pDst until done clipping...
-					}
-				else	// We've broken out of the Clipped region!
-					{			// Do a partial opaque run:
-					pSrc += sLeftClip; 			// We DO need to advance the source!
-					//pDst += sClipWidth;				// and the Dest for the clipped part!
-					ucCode -= sLeftClip;			// Remaining part of run is opaque
-					
-					if (ucCode > sClipWidth) // a Contracted Run
-						{
-						ucCode = (uint8_t)sClipWidth;
-						sClipWidth = 0;
-						}
-					else	sClipWidth -= ucCode; // a full opaque run
-					
-					if (ucCode)	// Do an opaque run
-						{
-						do	*(pDst++) = *(pSrc++);	// Copy pixel
-						while (--ucCode);	
-						}
-					
-					if (sClipWidth) goto NormalClear2S;	
-					else continue; // next code line!
-					}
-					
-				goto NextSkip2S;	// Still in the clip region
-				
-			NormalClear2S:
-				//==============================================================	
-				// 1) Do a clear run?
-				ucCode = *(pCB++); // Get skip length
-            if (ucCode == 0xFF)
-              continue; // End of line code
-
-				if ( (sClipWidth -= ucCode) <= 0) continue; // Initial skip is clipped out!
-				
-				pDst += ucCode;
-				//==============================================================	
-				// 2) Do an opaque run?
-			NormalOpaque2S:
-				ucCode = *(pCB++);		// Get run length
-				if (ucCode > sClipWidth) // a Contracted Run
-					{
-					ucCode = (uint8_t)sClipWidth;
-					sClipWidth = 0;
-					}
-				else	sClipWidth -= ucCode; // a full opaque run
-				
-				if (ucCode)	// Do an opaque run
-					{
-					do	*(pDst++) = *(pSrc++);	// Copy pixel
-					while (--ucCode);	
-					}
-				
-				if (sClipWidth) goto NormalClear2S;	
-				else continue; // next code line!
-				// Do next line
-				}
-			}
-		else // This is the Left Clip ONLY case!
-			{
-			for (sY = sSrcY; sY < sSrcY + sH; sY++,pDstLine += lDstP)
-				{	// Clip off left side:
-				pSrc = pInfo->m_pBufArry[sY];
-				pDst = pDstLine;
-				pCB = pInfo->m_pCodeArry[sY];
-				sClipWidth = sSrcX; // initial source...
-
-			NextSkip:
-				//==============================================================	
-				// 1) Skip a clear run?
-				ucCode = *(pCB++); // Get skip length
-            if (ucCode == 0xFF)
-              continue; // End of line code
-
-				// Don't update pDst until you are done skipping!
-				// pDst += ucCode;
-				if ((sClipWidth -= ucCode) < 0) 
-					{
-					pDst -= sClipWidth; // NOW advance pDst the remainder of the skip
-					goto NormalOpaque;// We're done being clipped
-					}
-
-				//==============================================================	
-				// 2) Skip an opaque run?
-				ucCode = *(pCB++); // Get skip length
-
-				if (ucCode < sClipWidth) 
-					{
-					sClipWidth -= ucCode; // Adance both pointers, but don't copy!
-					pSrc += ucCode;		// Always need to advance source in an opaque run
-					//pDst += ucCode; // don't move the pDst until done clipping...
-					}
-				else	// We've broken out of the Clipped region!
-					{			// Do a partial opaque run:
-					pSrc += sClipWidth; 			// We DO need to advance the source!
-					//pDst += sClipWidth;				// and the Dest for the clipped part!
-					ucCode -= sClipWidth;			// Remaining part of run is opaque
-					if (!ucCode) goto NormalClear;
-					do	*(pDst++) = *(pSrc++);	// Should be an unrolled loop
-					while	(--ucCode);
-						
-					goto NormalClear; // continue
-					}
-					
-				goto NextSkip;	// Still in the clip region
-				
-			NormalClear:
-				//==============================================================	
-				// 1) Do a clear run?
-				ucCode = *(pCB++); // Get skip length
-            if (ucCode == 0xFF)
-              continue; // End of line code
-
-				pDst += ucCode;
-				//==============================================================	
-				// 2) Do an opaque run?
-			NormalOpaque:
-				ucCode = *(pCB++); // Get skip length
-				
-				if (!ucCode) goto NormalClear;
-				do	*(pDst++) = *(pSrc++);	// Should be an unrolled loop
-				while	(--ucCode);
-				
-				goto NormalClear;	
-				// Do next line
-				}
-			}
+		// Scanlines with nothing in the clip aren't decoded at all, and only
+		// those that cross its sides need the clipped decode.
+		if (psSpan[0] >= sSrcR || psSpan[1] <= sSrcX) continue;
+
+		if (psSpan[0] >= sSrcX && psSpan[1] <= sSrcR)
+			BlitFSPR8Line(pDstLine - sSrcX,pInfo->m_pBufArry[sY],pInfo->m_pCodeArry[sY]);
+		else
+			BlitFSPR8LineClipped(pDstLine,pInfo->m_pBufArry[sY],pInfo->m_pCodeArry[sY],sSrcX,sSrcR);
 		}
-	else 
-		if (sW < (pimSrc->m_sWidth - sSrcX) )
-			for (sY = sSrcY; sY < sSrcY + sH; sY++,pDstLine += lDstP)
-				{	
-				// Clip Off Right Side:
-				pSrc = pInfo->m_pBufArry[sY];
-				pDst = pDstLine;
-				pCB = pInfo->m_pCodeArry[sY];
-				sClipWidth = sW;
-				
-			NextCodeRC:	// Go until used up sClipWidth
-				//==============================================================	
-				// 1) Do the clear run:
-				ucCode = *(pCB++);	// Get Initial Skip Length
-            if (ucCode == 0xFF)
-              continue; // End of line code
-				
-            if ( (sClipWidth -= ucCode) <= 0)
-              continue; // Initial skip is clipped out!
-				
-				pDst += ucCode; // Advace destination
-				//==============================================================	
-				// 2) Do the opaque run:
-				ucCode = *(pCB++);		// Get run length
-				if (ucCode > sClipWidth) // a Contracted Run
-					{
-					ucCode = (uint8_t)sClipWidth;
-					sClipWidth = 0;
-					}
-				else	sClipWidth -= ucCode; // a full opaque run
-				
-				if (ucCode)	// Do an opaque run
-					{
-					do	*(pDst++) = *(pSrc++);	// Copy pixel
-					while (--ucCode);	
-					}
-				
-				if (sClipWidth) goto NextCodeRC; // any space left?
-				// Do next line!
-				}	
-			else	// do an unclipped BLiT
-				{
-				for (sY = sSrcY; sY < sSrcY + sH; sY++,pDstLine += lDstP)
-					{
-					pSrc = pInfo->m_pBufArry[sY];
-					pDst = pDstLine;
-					pCB = pInfo->m_pCodeArry[sY];
-
-				NextCode:
-					//==============================================================	
-					// 1) Do the clear run:
-					ucCode = *(pCB)++;	// Get Skip Length
-               if (ucCode == 0xFF) continue;// End of line code
-					pDst += ucCode;		// Skip
-					
-					//==============================================================	
-					// 2) Do the opaque run:
-					ucCode = *(pCB)++;			// Get Skip Length
-					if (!ucCode) goto NextCode;
-					
-					memcpy(pDst, pSrc, ucCode);
-					pDst += ucCode;
-					pSrc += ucCode;
-
-					goto NextCode;
-					}
-				}
 
 	// *******************************************************************
 	// IN RELEASE MODE, GIVE THE USER A CHANCE:
@@ -163,12 +163,15 @@ public:
 	uint8_t*	m_pCodeBuf;		// 32-aligned compression codes
 	uint8_t**	m_pBufArry;		// 32-aligned, arry of ptrs to m_pCompBuf scanlines
 	uint8_t**	m_pCodeArry;	// 32-aligned, arry of ptrs into m_pCodeBuf scanlines
+	int16_t*	m_psRowSpan;	// 2 per scanline: first opaque x and one past the last
+									// (both 0 for a clear line).  Not saved, made on load.
 
 	RSpecialFSPR8()
 		{
 		m_usCompType = m_usSourceType = 0;
       m_pCompBuf = m_pCompMem = m_pCodeBuf = nullptr;
       m_pBufArry = m_pCodeArry = nullptr;
+		m_psRowSpan = nullptr;
 		m_lBufSize = m_lCodeSize = 0;
 		}
 
@@ -178,6 +181,7 @@ public:
 		if (m_pCodeBuf) free(m_pCodeBuf);
 		if (m_pBufArry) free(m_pBufArry);
 		if (m_pCodeArry) free(m_pCodeArry);
+		if (m_psRowSpan) free(m_psRowSpan);
 		}
 	};
 
@@ -51,6 +51,7 @@
 // BACKWARDS COMPATIBILITY (03/23/97)
 //
 // - Supports loading RAttribute Files up to version 4
+// - Loads MultiGrid version 1 (16-bit sizes) and version 2 (32-bit sizes)
 //
 // PLANNED ENHANCEMENTS
 //
@@ -104,7 +105,7 @@ void	RMultiGrid::Dump(RImage* pimDst,int16_t sSrcX,int16_t sSrcY,int16_t sDstX,i
 	for (j=0;j < sH; j++)
 		for (i=0;i< sW;i++)
 			{
-			int16_t sValue = m_psGrid[i + sSrcX + (j + sSrcY)*int32_t(m_sWidth)];
+			int16_t sValue = m_psGrid[i + sSrcX + (j + sSrcY)*size_t(m_lWidth)];
          *(pimDst->m_pData + 2*(i + sDstX) + (j + sDstY)*pimDst->m_lPitch) = uint8_t(sValue >> 8);
          *(pimDst->m_pData + 2*(i + sDstX) + (j + sDstY)*pimDst->m_lPitch+1) = uint8_t(sValue & UINT8_MAX);
 			}
@@ -113,19 +114,19 @@ void	RMultiGrid::Dump(RImage* pimDst,int16_t sSrcX,int16_t sSrcY,int16_t sDstX,i
 // For Debugging
 void	RMultiGrid::DumpGrid(RImage* pimDst)
 	{
-	int16_t i,j;
+	int32_t i,j;
 
 	ASSERT(pimDst);
 	ASSERT(m_psGrid);
 	ASSERT(m_sIsCompressed);
 
-	int16_t sGridW;
-	int16_t sGridH;
+	int32_t lGridW;
+	int32_t lGridH;
 
-	GetGridDimensions(&sGridW,&sGridH);
+	GetGridDimensions(&lGridW,&lGridH);
 
-	for (j=0; j < sGridH; j++)
-		for (i=0; i < sGridW; i++)
+	for (j=0; j < lGridH; j++)
+		for (i=0; i < lGridW; i++)
 			{
 			int16_t sValue = *(m_ppsGridLines[j * (m_sMaskY + 1)] + i);
 
@@ -137,14 +138,14 @@ void	RMultiGrid::DumpGrid(RImage* pimDst)
 // For Debugging:
 void	RMultiGrid::DumpData(RImage* pimDst)
 	{
-	int16_t i,j;
+	int32_t i,j;
 
 	ASSERT(pimDst);
 	ASSERT(m_psGrid);
 	ASSERT(m_sIsCompressed);
 
-	for (j=0;j < m_sHeight; j ++)
-		for (i=0;i< m_sWidth; i++)
+	for (j=0;j < m_lHeight; j ++)
+		for (i=0;i< m_lWidth; i++)
 			{
 			int16_t sValue = GetVal(i,j);
 
@@ -158,13 +159,13 @@ void	RMultiGrid::DumpTiles(RImage* pimDst)
   UNUSED(pimDst);
 	int16_t sNumTiles = 0 ;// scan for the number of tiles:
 
-	int16_t i,j;
-	int16_t sGridW,sGridH;
-	GetGridDimensions(&sGridW,&sGridH);
+	int32_t i,j;
+	int32_t lGridW,lGridH;
+	GetGridDimensions(&lGridW,&lGridH);
 
-	for (j=0;j < sGridH;j++)
+	for (j=0;j < lGridH;j++)
 		{
-		for (i=0;i < sGridW;i++)
+		for (i=0;i < lGridW;i++)
 			{
 			int16_t sValue = *(m_ppsGridLines[j * (m_sMaskY + 1)] + i);
 			if (sValue < 0) sNumTiles = MAX(sNumTiles,int16_t(-sValue));
@@ -188,7 +189,7 @@ void	RMultiGrid::DumpTiles(RImage* pimDst)
 //
 //////////////////////////////////////////////////////////////////////
 
-int16_t	RMultiGrid::Alloc(int16_t sW, int16_t sH)
+int16_t	RMultiGrid::Alloc(int32_t lW, int32_t lH)
 	{
 #ifdef	_DEBUG
 	if (m_sIsCompressed)
@@ -198,10 +199,10 @@ int16_t	RMultiGrid::Alloc(int16_t sW, int16_t sH)
 		}
 #endif
 
-	if (!(m_psGrid = (int16_t*) calloc(sizeof(int16_t),int32_t(sW)*sH) )) return FAILURE;
+	if (!(m_psGrid = (int16_t*) calloc(sizeof(int16_t),size_t(lW)*lH) )) return FAILURE;
 
-	m_sWidth = sW;
-	m_sHeight = sH;
+	m_lWidth = lW;
+	m_lHeight = lH;
 
 	return SUCCESS;
 	}
@@ -267,9 +268,9 @@ int16_t	RMultiGrid::AllocGrid(int16_t sScaleW, int16_t sScaleH)
 
 
 	//--------------------------------------------- Allocate the coarse grid
-	int16_t sGridW,sGridH;
-	GetGridDimensions(&sGridW,&sGridH);
-	int16_t	sFullHeight = sGridH * sScaleH;
+	int32_t lGridW,lGridH;
+	GetGridDimensions(&lGridW,&lGridH);
+	int32_t	lFullHeight = lGridH * sScaleH;
 
 	int16_t*	psUncompressed = m_psGrid;		// Save old!
 
@@ -278,7 +279,7 @@ int16_t	RMultiGrid::AllocGrid(int16_t sScaleW, int16_t sScaleH)
 	int32_t	lByteTileSize = lShortTileSize << 1;
 //	int32_t	lLongTileSize = lShortTileSize >> 1;
 	// Initial Max
-	int16_t		sMaxNumTiles = MIN((int32_t)32767, (int32_t)1 + int32_t(sGridW) * (int32_t)sGridH);
+	int16_t		sMaxNumTiles = MIN((int32_t)32767, (int32_t)1 + lGridW * lGridH);
 
    if (!(m_psTiles = (int16_t*) calloc(lByteTileSize,sMaxNumTiles ) ))
      return FAILURE;
@@ -298,25 +299,25 @@ int16_t	RMultiGrid::AllocGrid(int16_t sScaleW, int16_t sScaleH)
 
 	//--------------------------------------------- Allocate the coarse grid
 
-   if (!(m_psGrid = (int16_t*) calloc(sizeof(int16_t),int32_t(sGridW)*sGridH) ))
+   if (!(m_psGrid = (int16_t*) calloc(sizeof(int16_t),size_t(lGridW)*lGridH) ))
      return FAILURE;
 
 	//--------------------------------------------- Add in the random access:
 
-   if (!(m_ppsGridLines = (int16_t**) calloc(sizeof(int16_t*),sFullHeight ) ))
+   if (!(m_ppsGridLines = (int16_t**) calloc(sizeof(int16_t*),lFullHeight ) ))
      return FAILURE;
-   for (int16_t i=0; i < sFullHeight; i++)
-     m_ppsGridLines[i] = m_psGrid + (i >> m_sShiftY)*sGridW;
+   for (int32_t i=0; i < lFullHeight; i++)
+     m_ppsGridLines[i] = m_psGrid + size_t(i >> m_sShiftY)*lGridW;
 
 	//---------------------------------------------  Populate the coarse grid:
 
 	int16_t	*psSrc,*psSrcLine = psUncompressed;
-	int32_t	lSrcSkip = int32_t(m_sWidth)*sScaleH;
+	size_t	lSrcSkip = size_t(m_lWidth)*sScaleH;
 
-   for (int16_t j=0;j < sFullHeight;j += sScaleH,psSrcLine += lSrcSkip)
+   for (int32_t j=0;j < lFullHeight;j += sScaleH,psSrcLine += lSrcSkip)
 		{
 		psSrc = psSrcLine;
-      for (int16_t i=0;i < sGridW;i++,psSrc += sScaleW)
+      for (int32_t i=0;i < lGridW;i++,psSrc += sScaleW)
 			{
 			*(m_ppsGridLines[j] + i) = *psSrc;
 			}
@@ -376,36 +377,37 @@ int16_t RMultiGrid::Compress(
 
 	// Now, attempt to compress things into blocks:
 	// First, do only the integral blocks:
-	int16_t sBlockX,sBlockY,sFullY,i,j;
+	int32_t lBlockX,lBlockY,lFullY;
+	int16_t i,j;
 	int16_t sGridVal,sVal;
 	int16_t sTileNumber = 1; // cannot use -0 as a valid offset!
 
-	int16_t sGridW,sGridH;
-	GetGridDimensions(&sGridW,&sGridH);
+	int32_t lGridW,lGridH;
+	GetGridDimensions(&lGridW,&lGridH);
 
-	int16_t sWholeGridW = sGridW - 1; // guaranteed to be whole.
-	int16_t	sWholeGridH = sGridH - 1;
+	int32_t lWholeGridW = lGridW - 1; // guaranteed to be whole.
+	int32_t	lWholeGridH = lGridH - 1;
 
-	int16_t	sExtraW = m_sWidth - (sWholeGridW << m_sShiftX);
-	int16_t	sExtraH = m_sHeight - (sWholeGridH << m_sShiftY);
+	int16_t	sExtraW = int16_t(m_lWidth - (lWholeGridW << m_sShiftX));
+	int16_t	sExtraH = int16_t(m_lHeight - (lWholeGridH << m_sShiftY));
 
 //	int16_t sMaxTile = MIN((int32_t)32767, (int32_t)1 + int32_t(sGridW) * (int32_t)sGridH);
 	int16_t	sShortSize = (m_sMaskX+1)*(m_sMaskY+1);
 	int16_t sNumMatches = 0;
 
 	int16_t sScanH = m_sMaskY + 1;
-	for (sFullY = 0,sBlockY = 0; sBlockY < sGridH; sBlockY++,sFullY += m_sMaskY + 1)
+	for (lFullY = 0,lBlockY = 0; lBlockY < lGridH; lBlockY++,lFullY += m_sMaskY + 1)
 		{
-		if (sBlockY == sWholeGridH) sScanH = sExtraH;
+		if (lBlockY == lWholeGridH) sScanH = sExtraH;
 
 		int16_t sScanW = m_sMaskX + 1;
-		for (sBlockX = 0; sBlockX < sGridW; sBlockX ++)
+		for (lBlockX = 0; lBlockX < lGridW; lBlockX ++)
 			{
-			if (sBlockX == sWholeGridW) sScanW = sExtraW;
+			if (lBlockX == lWholeGridW) sScanW = sExtraW;
 
-			sGridVal = *(m_ppsGridLines[sFullY] + sBlockX);
-			int16_t* psSrcBlock = psUncompressedData + int32_t(sBlockX) * (m_sMaskX + 1) +
-				int32_t(sFullY) * m_sWidth;
+			sGridVal = *(m_ppsGridLines[lFullY] + lBlockX);
+			int16_t* psSrcBlock = psUncompressedData + size_t(lBlockX) * (m_sMaskX + 1) +
+				size_t(lFullY) * m_lWidth;
 
 			// *********************************************** ANALIZE BLOCK
 			int16_t sMatch = 1; // homogeneous block?
@@ -417,7 +419,7 @@ int16_t RMultiGrid::Compress(
 				for (i = 0; i < sScanW; i++) // only copy what's needed...
 					{
 					// copy into temp block:
-					sVal = psSrcBlock[i + j * int32_t(m_sWidth)];
+					sVal = psSrcBlock[i + j * size_t(m_lWidth)];
 					*(m_ppsTileList[sTileNumber] + m_psTileLine[ j ] + i) = sVal;
 					if (sVal != sGridVal) sMatch = 0; // was not homogeneous
 					}
@@ -431,7 +433,7 @@ int16_t RMultiGrid::Compress(
 					{
 					int16_t k;
 
-					if ((sBlockX != sWholeGridW) && (sBlockY != sWholeGridH)) // do a quick compare:
+					if ((lBlockX != lWholeGridW) && (lBlockY != lWholeGridH)) // do a quick compare:
 						{
 						for (k=0;k < sTileNumber;k++)
 							{
@@ -448,7 +450,7 @@ int16_t RMultiGrid::Compress(
 
 							if (sComp) // matched an existing tile!
 								{
-								*(m_ppsGridLines[sFullY] + sBlockX) = -k;
+								*(m_ppsGridLines[lFullY] + lBlockX) = -k;
 								sFound = 1;
 								sNumMatches++;
 								break;
@@ -475,7 +477,7 @@ int16_t RMultiGrid::Compress(
 
 							if (sComp) // matched an existing tile!
 								{
-								*(m_ppsGridLines[sFullY] + sBlockX) = -k;
+								*(m_ppsGridLines[lFullY] + lBlockX) = -k;
 								sFound = 1;
 								sNumMatches++;
 								break;
@@ -488,7 +490,7 @@ int16_t RMultiGrid::Compress(
 				// NEED a new block!
 				if (!sFound) 
 					{
-					*(m_ppsGridLines[sFullY] + sBlockX) = -sTileNumber;
+					*(m_ppsGridLines[lFullY] + lBlockX) = -sTileNumber;
 					sTileNumber++;
 					if (sTileNumber == 32767)
 						{
@@ -525,7 +527,7 @@ int16_t RMultiGrid::Compress(
 
 	if (plNumBlocks) *plNumBlocks = --sTileNumber;
 	if (plSize) *plSize = int32_t(sTileNumber) * (int32_t(sShortSize) * sizeof(int16_t) + sizeof(int16_t*))
-		+ int32_t(sGridH) * (sGridW * sizeof(int16_t) + sizeof(int16_t*) );
+		+ lGridH * (lGridW * sizeof(int16_t) + sizeof(int16_t*) );
 
 	return SUCCESS;
 	}
@@ -541,18 +543,18 @@ int16_t RMultiGrid::Decompress()
 		}
 #endif
 
-	int16_t *psNewGrid = (int16_t*) calloc(sizeof(int16_t),int32_t(m_sWidth)*m_sHeight);
+	int16_t *psNewGrid = (int16_t*) calloc(sizeof(int16_t),size_t(m_lWidth)*m_lHeight);
 
    if (!psNewGrid) return FAILURE; // allocation error
 
 	// Draw into the new grid:
-	int16_t i,j;
+	int32_t i,j;
 
-	for (j=0;j < m_sHeight;j++)
+	for (j=0;j < m_lHeight;j++)
 		{
-		for (i=0;i < m_sWidth;i++)
+		for (i=0;i < m_lWidth;i++)
 			{
-			psNewGrid[i + int32_t(j)*m_sWidth ] = GetVal(i,j);
+			psNewGrid[i + size_t(j)*m_lWidth ] = GetVal(i,j);
 			}
 		}
 
@@ -587,21 +589,43 @@ int16_t RMultiGrid::Save(RFile* fp)
 		return FAILURE;
 		}
 	
+	// Only use the wide format when the realm actually needs it so
+	// ordinary maps stay readable by older builds.
+	int16_t sVersion = MULTIGRID_SHORT_VERSION;
+	if (m_lWidth > INT16_MAX || m_lHeight > INT16_MAX)
+		sVersion = MULTIGRID_CURRENT_VERSION;
+
 	fp->Write(MULTIGRID_COOKIE);
-	fp->Write(int16_t(MULTIGRID_CURRENT_VERSION));
+	fp->Write(sVersion);
+
+	int32_t lGridW,lGridH;
+	GetGridDimensions(&lGridW,&lGridH);
 
-	fp->Write(m_sWidth);
-	fp->Write(m_sHeight);
+	if (sVersion == MULTIGRID_SHORT_VERSION)
+		{
+		fp->Write(int16_t(m_lWidth));
+		fp->Write(int16_t(m_lHeight));
+		}
+	else
+		{
+		fp->Write(m_lWidth);
+		fp->Write(m_lHeight);
+		}
 	fp->Write(m_sIsCompressed); // ASSUME IT IS COMPRESSED!
 	fp->Write(m_sMaskX);
 	fp->Write(m_sMaskY);
 	fp->Write(int16_t(sizeof(int16_t))); // For future expansion!
 
-	int16_t sGridW,sGridH;
-	GetGridDimensions(&sGridW,&sGridH);
-
-	fp->Write(sGridW);
-	fp->Write(sGridH);
+	if (sVersion == MULTIGRID_SHORT_VERSION)
+		{
+		fp->Write(int16_t(lGridW));
+		fp->Write(int16_t(lGridH));
+		}
+	else
+		{
+		fp->Write(lGridW);
+		fp->Write(lGridH);
+		}
 
 	int16_t sNumTiles = GetNumTiles();
 	fp->Write(sNumTiles);
@@ -612,10 +636,10 @@ int16_t RMultiGrid::Save(RFile* fp)
 	fp->Write(int32_t(0)); // Reserved4
 
 	// Write out the grid of shorts:
-	int16_t i,j;
+	int32_t i,j;
 
-	for (j=0;j < sGridH; j++)
-		for (i=0;i<sGridW;i++)
+	for (j=0;j < lGridH; j++)
+		for (i=0;i<lGridW;i++)
 			fp->Write(*(m_ppsGridLines[j<<m_sShiftY] + i));
 
 	// Write out the tiles, omitting the zeroth black tile.
@@ -635,7 +659,7 @@ int16_t RMultiGrid::Save(RFile* fp)
 // Load
 //
 // Returns FAILURE or SUCCESS
-// Will currently only load a compressed Multigrid, version I
+// Will currently only load a compressed Multigrid, version I or II
 //
 //////////////////////////////////////////////////////////////////////
 
@@ -660,15 +684,28 @@ int16_t RMultiGrid::Load(RFile* fp)
 		}
 
 	fp->Read(&sVal);
-	if (sVal != MULTIGRID_CURRENT_VERSION)
+	if (sVal != MULTIGRID_SHORT_VERSION && sVal != MULTIGRID_CURRENT_VERSION)
 		{
 		TRACE("MultiGrid::Load: I don't support this version (%hd).\n",sVal);
 		return FAILURE;
 		}
 
+	int16_t sVersion = sVal;
+	int16_t sShortW,sShortH;
+
 	// Let's JAM!
-	fp->Read(&m_sWidth);
-	fp->Read(&m_sHeight);
+	if (sVersion == MULTIGRID_SHORT_VERSION)
+		{
+		fp->Read(&sShortW);
+		fp->Read(&sShortH);
+		m_lWidth = sShortW;
+		m_lHeight = sShortH;
+		}
+	else
+		{
+		fp->Read(&m_lWidth);
+		fp->Read(&m_lHeight);
+		}
 	fp->Read(&m_sIsCompressed); // should be compressed
 	fp->Read(&m_sMaskX);
 	fp->Read(&m_sMaskY);
@@ -676,13 +713,23 @@ int16_t RMultiGrid::Load(RFile* fp)
 	int16_t sCodeSize;
 	fp->Read(&sCodeSize); // normally 2 for short.
 
-	int16_t sGridW,sGridH;
+	int32_t lGridW,lGridH;
 
-	fp->Read(&sGridW);
-	fp->Read(&sGridH);
+	if (sVersion == MULTIGRID_SHORT_VERSION)
+		{
+		fp->Read(&sShortW);
+		fp->Read(&sShortH);
+		lGridW = sShortW;
+		lGridH = sShortH;
+		}
+	else
+		{
+		fp->Read(&lGridW);
+		fp->Read(&lGridH);
+		}
 
 	// ALLOCATE IT
-	m_psGrid = (int16_t*) calloc(sCodeSize,int32_t(sGridW)*sGridH);
+	m_psGrid = (int16_t*) calloc(sCodeSize,size_t(lGridW)*lGridH);
 	if (!m_psGrid)
 		{
 		TRACE("MultiGrid::Load: Out of Memory!!!!\n");
@@ -708,20 +755,20 @@ int16_t RMultiGrid::Load(RFile* fp)
 	fp->Read(&lVal); // Reserved3
 	fp->Read(&lVal); // Reserved4
 
-	int16_t i,j;
+	int32_t i,j;
 
 	// Must generate the shift members to use them now!
 	m_sShiftX = MaskToShift(m_sMaskX);
 	m_sShiftY = MaskToShift(m_sMaskY);
 
 	// Set up random access for grid:
-	int16_t	sFullHeight = sGridH * (m_sMaskY + 1);
-	if (!(m_ppsGridLines = (int16_t**) calloc(sizeof(int16_t*),sFullHeight ) )) return FAILURE;
-	for (i=0; i < sFullHeight; i++) m_ppsGridLines[i] = m_psGrid + (i >> m_sShiftY)*sGridW;
+	int32_t	lFullHeight = lGridH * (m_sMaskY + 1);
+	if (!(m_ppsGridLines = (int16_t**) calloc(sizeof(int16_t*),lFullHeight ) )) return FAILURE;
+	for (i=0; i < lFullHeight; i++) m_ppsGridLines[i] = m_psGrid + size_t(i >> m_sShiftY)*lGridW;
 
 	// Read in the grid of shorts:
-	for (j=0;j < sGridH; j++)
-		for (i=0;i<sGridW;i++)
+	for (j=0;j < lGridH; j++)
+		for (i=0;i<lGridW;i++)
 			fp->Read((m_ppsGridLines[j<<m_sShiftY] + i));
 
 	// Set up random access for tiles:
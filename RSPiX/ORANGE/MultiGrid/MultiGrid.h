@@ -41,7 +41,8 @@
 #include <GREEN/Image/Image.h> // For Debugging only
  
  #define MULTIGRID_COOKIE "_MultiGrid_"
- #define MULTIGRID_CURRENT_VERSION 1
+ #define MULTIGRID_CURRENT_VERSION 2
+ #define MULTIGRID_SHORT_VERSION 1	// 16-bit dimensions, still written when they fit
 
 //////////////////////////////////////////////////////////////////////
 //
@@ -54,6 +55,7 @@
 // BACKWARDS COMPATIBILITY (03/23/97)
 //
 // - Supports loading RAttribute Files up to version 4
+// - Version 1 files (16-bit dimensions) load into the 32-bit members
 //
 // PLANNED ENHANCEMENTS
 //
@@ -94,8 +96,8 @@ public:
 	//  User members:
 	//////////////////////////////////////////////////////////////////////
 
-	int16_t	m_sWidth;	// With compression, you might get huge objects!
-	int16_t	m_sHeight;
+	int32_t	m_lWidth;	// With compression, you might get huge objects!
+	int32_t	m_lHeight;
 
 	//////////////////////////////////////////////////////////////////////
 	//  User methods:
@@ -104,24 +106,26 @@ public:
 	// This inline does a high speed lookup into the compressed data.
 	// It ONLY works AFTER the data has been compressed!
 	//
-	int16_t	GetVal(int16_t sX, int16_t sY,int16_t sClipVal = -1)
+	int16_t	GetVal(int32_t lX, int32_t lY,int16_t sClipVal = -1)
 		{
 		//-----------------------------------------------------------------
 		ASSERT(m_sIsCompressed);
 
 	#ifdef MULTIGRID_CLIP
-		if ( (sX < 0) || (sY < 0) || (sX >= m_sWidth) || (sY >= m_sHeight) )
+		// Negative values wrap to huge unsigned ones, so one compare per axis
+		// clips both edges.
+		if ( (uint32_t(lX) >= uint32_t(m_lWidth)) || (uint32_t(lY) >= uint32_t(m_lHeight)) )
 			return	sClipVal;
 	#endif
 		//-----------------------------------------------------------------
 
-		int16_t sVal = *( m_ppsGridLines[sY] + (sX >> m_sShiftX) );
+		int16_t sVal = *( m_ppsGridLines[lY] + (lX >> m_sShiftX) );
 		if (sVal >=0) return sVal; 
 
 		// Cache miss -> must look into a stored tile:
 		//return -sVal; // For debugging
-		return *( m_ppsTileList[-sVal] + m_psTileLine[ sY & m_sMaskY ]
-						+ (sX & m_sMaskX) );
+		return *( m_ppsTileList[-sVal] + m_psTileLine[ lY & m_sMaskY ]
+						+ (lX & m_sMaskX) );
 		}
 
 	// If you wish to know the scale, you can get it from
@@ -133,12 +137,12 @@ public:
 		}
 
 	// If you wish to know the coarse grid dimensions:
-	void	GetGridDimensions(int16_t *psW,int16_t *psH)
+	void	GetGridDimensions(int32_t *plW,int32_t *plH)
 		{
-		*psW = m_sWidth >> m_sShiftX;
-		*psH = m_sHeight >> m_sShiftY;
-		if ( m_sWidth & m_sMaskX ) *psW = *psW + 1;	// Partial tiles
-		if ( m_sHeight & m_sMaskY ) *psH = *psH + 1;	// Partial tiles
+		*plW = m_lWidth >> m_sShiftX;
+		*plH = m_lHeight >> m_sShiftY;
+		if ( m_lWidth & m_sMaskX ) *plW = *plW + 1;	// Partial tiles
+		if ( m_lHeight & m_sMaskY ) *plH = *plH + 1;	// Partial tiles
 		}
 
 	// If you wish to know the enumber of unique blocks:
@@ -147,13 +151,13 @@ public:
 		ASSERT(m_sIsCompressed);
 
 		int16_t sNumTiles = 0 ;// scan for the number of tiles:
-		int16_t i,j;
-		int16_t sGridW,sGridH;
-		GetGridDimensions(&sGridW,&sGridH);
+		int32_t i,j;
+		int32_t lGridW,lGridH;
+		GetGridDimensions(&lGridW,&lGridH);
 
-		for (j=0;j < sGridH;j++)
+		for (j=0;j < lGridH;j++)
 			{
-			for (i=0;i < sGridW;i++)
+			for (i=0;i < lGridW;i++)
 				{
 				int16_t sValue = *(m_ppsGridLines[j * (m_sMaskY + 1)] + i);
 				if (sValue < 0) sNumTiles = MAX(sNumTiles,int16_t(-sValue));
@@ -178,29 +182,29 @@ public:
 	// Returns SUCCESS or FAILURE
 	// Sets up the UNCOMPRESSED data
 	//
-	int16_t	Alloc(int16_t sW, int16_t sH);
+	int16_t	Alloc(int32_t lW, int32_t lH);
 
 	// UNCOMPRESSED ACCESS:
 	//
-	void	SetValueUncompressed(int16_t sVal,int16_t sX,int16_t sY)
+	void	SetValueUncompressed(int16_t sVal,int32_t lX,int32_t lY)
 		{
 		ASSERT(m_psGrid);
 		ASSERT(sVal >= 0);
 		ASSERT(!m_sIsCompressed);
-		ASSERT( (sX >=0) && (sY >= 0) && (sX < m_sWidth) && (sY < m_sHeight));
+		ASSERT( (lX >=0) && (lY >= 0) && (lX < m_lWidth) && (lY < m_lHeight));
 
-		*(m_psGrid + sX + int32_t(sY) * m_sWidth) = sVal;
+		*(m_psGrid + lX + size_t(lY) * m_lWidth) = sVal;
 		}
 
 	// UNCOMPRESSED READ ACCESS
 	//
-	int16_t GetValueUncompressed(int16_t sX, int16_t sY)
+	int16_t GetValueUncompressed(int32_t lX, int32_t lY)
 		{
 		ASSERT(m_psGrid);
 		ASSERT(!m_sIsCompressed);
-		ASSERT( (sX >= 0) && (sY >= 0) && (sX < m_sWidth) && (sY < m_sHeight));
+		ASSERT( (lX >= 0) && (lY >= 0) && (lX < m_lWidth) && (lY < m_lHeight));
 
-		return *(m_psGrid + sX + int32_t(sY) * m_sWidth);
+		return *(m_psGrid + lX + size_t(lY) * m_lWidth);
 		}
 
 	// A visual Debug View: (Uncompressed)
@@ -256,7 +260,7 @@ public:
 
 	void	ClearUncompressed()	
 		{
-		m_sWidth = m_sHeight = 0;
+		m_lWidth = m_lHeight = 0;
 		m_psGrid = nullptr;
 		}
 
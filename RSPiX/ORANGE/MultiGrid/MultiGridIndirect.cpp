@@ -311,22 +311,22 @@ int16_t RMultiGridIndirect::AddFSPR1(RImage* pimSrc,int16_t sLogX,int16_t sLogY,
 
 		if (sClip)
 			{
-			int16_t sClip;
-			sClip = m_pmg->m_sWidth - sDstX - m_sTileW;
-			if (sClip < 0) sW += sClip;
-			sClip = m_pmg->m_sHeight - sDstY - m_sTileH;
-			if (sClip < 0) sH += sClip;
+			int32_t lClip;
+			lClip = m_pmg->m_lWidth - sDstX - m_sTileW;
+			if (lClip < 0) sW += lClip;
+			lClip = m_pmg->m_lHeight - sDstY - m_sTileH;
+			if (lClip < 0) sH += lClip;
 
 			if ( (sW < 1) || (sH < 1) ) return; // clipped out
 			}
 
-		int32_t	lDstP = m_pmg->m_sWidth; // (in shorts)
+		int32_t	lDstP = m_pmg->m_lWidth; // (in shorts)
 		int32_t	lSrcP = m_sTileW;
 		uint8_t*	pSrc,*pSrcLine = m_pimTempTile->m_pData;
 		uint16_t*  pDst,*pDstLine = (uint16_t*)m_pmg->m_psGrid;
 
 		// Adjust for actual coordinates!!!!
-		pDstLine += int32_t(m_pmg->m_sWidth) * sDstY + sDstX;
+		pDstLine += size_t(m_pmg->m_lWidth) * sDstY + sDstX;
 		int16_t	i,j;
 
 		for (j=0;j < sH;j++,pSrcLine += lSrcP,pDstLine += lDstP)
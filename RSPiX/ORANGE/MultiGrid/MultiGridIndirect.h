@@ -112,7 +112,7 @@ public:
 	// will recieve a nullptr terminated string of dereferenced
 	// palette hits for that point.
 	//
-	int16_t	GetVal(uint8_t*	pszResult,int16_t sX, int16_t sY,char ucClipVal = -1)
+	int16_t	GetVal(uint8_t*	pszResult,int32_t lX, int32_t lY,char ucClipVal = -1)
 		{
      UNUSED(ucClipVal);
 		//-----------------------------------------------------------------
@@ -120,12 +120,12 @@ public:
 		ASSERT(m_pucPalette);
 		ASSERT(m_pmg->m_sIsCompressed);
 		// 1) Get the set of index planes:
-		uint16_t usList = uint16_t(m_pmg->GetVal(sX,sY,-1));
+		uint16_t usList = uint16_t(m_pmg->GetVal(lX,lY,-1));
 		// Check each plane individually
 		for (int16_t i=0;i < m_sMaxPlanes;i++)
 			{
 			if (usList & ms_asColorToPlane[i]) 
-				*pszResult++ = *(GetPalette(sX,sY)+i); // look into clipping:
+				*pszResult++ = *(GetPalette(lX,lY)+i); // look into clipping:
 			}
 
 		*pszResult = 0;
@@ -156,16 +156,16 @@ public:
 	// Low level palette access
 	// Just get the current byte array of MGI_MAX_PLANES size:
 	//
-	uint8_t*	GetPalette(int16_t sX,int16_t sY, uint8_t* pucOnError = nullptr)
+	uint8_t*	GetPalette(int32_t lX,int32_t lY, uint8_t* pucOnError = nullptr)
 		{
 		ASSERT(m_pucPalette);
 
 	#ifdef	MGI_CLIP
-		if ( (sX < 0) || (sY < 0) || (sX >= m_sWidth) || (sY >= m_sHeight) ) 
+		if ( (lX < 0) || (lY < 0) || (lX >= m_sWidth) || (lY >= m_sHeight) ) 
 			return pucOnError;
 	#endif
 
-		return m_ppucAccessY[sY] + m_plAccessX[sX];
+		return m_ppucAccessY[lY] + m_plAccessX[lX];
 		}
 
 	// This gives you the number of taken palette entries in a tile:
@@ -187,7 +187,7 @@ public:
 		{
 		ASSERT(!m_pmg);
 		ASSERT(pmg);
-		ASSERT( (pmg->m_sWidth == m_sWidth) && (pmg->m_sHeight == m_sHeight));
+		ASSERT( (pmg->m_lWidth == m_sWidth) && (pmg->m_lHeight == m_sHeight));
 		ASSERT(!pmg->m_sIsCompressed);
 
 		m_pmg = pmg;
@@ -913,7 +913,7 @@ void CSoundThing::EditRender(void)
    m_sX2	-= m_pImage->m_sWidth / 2;
    m_sY2	-= m_pImage->m_sHeight;
 
-   m_sLayer = CRealm::GetLayerViaAttrib(realm()->GetLayer((int16_t) position.x, (int16_t) position.z));
+   m_sLayer = CRealm::GetLayerViaAttrib(realm()->GetLayer((int32_t) position.x, (int32_t) position.z));
 
    Object::enqueue(SpriteUpdate); // Update sprite in scene
 	}
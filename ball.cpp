@@ -345,7 +345,7 @@ void CBall::Render(void)
   m_sPriority = position.z;
 
   m_sLayer = CRealm::GetLayerViaAttrib(
-                        realm()->GetLayer((int16_t) position.x, (int16_t) position.z));
+                        realm()->GetLayer((int32_t) position.x, (int32_t) position.z));
 
 
   // Cheese festival rotation.
@@ -216,8 +216,8 @@ bool	CBand::ms_bDonePlaying	= false;
 
 CBand::CBand(void)
 {
-  m_ucNextBouyID = 1;
-  m_ucDestBouyID = 1;
+  m_u16NextBouyID = 1;
+  m_u16DestBouyID = 1;
   m_bCivilian = true;
 }
 
@@ -277,7 +277,7 @@ int16_t CBand::Load(					// Returns 0 if successfull, non-zero otherwise
 			{
 				default:
 				case 37:
-               pFile->Read(&m_ucDestBouyID);
+               CBouy::ReadID(pFile, ulFileVersion, &m_u16DestBouyID);
 				case 36:
 				case 35:
 				case 34:
@@ -316,7 +316,7 @@ int16_t CBand::Load(					// Returns 0 if successfull, non-zero otherwise
 				case 2:
 				case 1:
                pFile->Read(reinterpret_cast<uint8_t*>(&m_eWeaponType));
-					pFile->Read(&m_ucNextBouyID);
+					CBouy::ReadID(pFile, ulFileVersion, &m_u16NextBouyID);
 					break;
 			}
 
@@ -364,11 +364,11 @@ int16_t CBand::Save(										// Returns 0 if successfull, non-zero otherwise
 	}
 
 	// Save band member specific data
-   pFile->Write(&m_ucDestBouyID);
+   pFile->Write(&m_u16DestBouyID);
    uint16_t child_id = child() ? child()->GetInstanceID() : UINT16_MAX;
    pFile->Write(child_id);
    pFile->Write(reinterpret_cast<uint8_t*>(&m_eWeaponType));
-	pFile->Write(&m_ucNextBouyID);
+	pFile->Write(&m_u16NextBouyID);
 
 	if (!pFile->Error())
 	{
@@ -411,9 +411,9 @@ int16_t CBand::Init(void)
 	m_stockpile.m_sHitPoints = ms_sStartingHitPoints;
 
 	// Set them facing their first bouy so they are lined up ready to march
-//	m_ucDestBouyID = 1;		// This is the end of the parade route bouy
-//	m_ucNextBouyID = m_pNavNet->FindNearestBouy(position.x, position.z);
-	m_pNextBouy = m_pNavNet->GetBouy(m_ucNextBouyID);
+//	m_u16DestBouyID = 1;		// This is the end of the parade route bouy
+//	m_u16NextBouyID = m_pNavNet->FindNearestBouy(position.x, position.z);
+	m_pNextBouy = m_pNavNet->GetBouy(m_u16NextBouyID);
 //	ASSERT(m_pNextBouy);
    if (m_pNextBouy)
 		{
@@ -538,8 +538,8 @@ void CBand::Update(void)
 				if ((dX*dX + dZ*dZ) < ms_dCloseToBouy)
 				{
 					// Set next bouy, x, z, and rotation
-					m_ucNextBouyID = m_pNextBouy->NextRouteNode(m_ucDestBouyID);
-					if (m_ucNextBouyID == 0)
+					m_u16NextBouyID = m_pNavNet->NextWaypoint(m_pNextBouy->m_u16ID, m_u16DestBouyID);
+					if (m_u16NextBouyID == 0)
 					{
 						// Note that we're done playing music.
 						ms_bDonePlaying	= true;
@@ -556,7 +556,7 @@ void CBand::Update(void)
 					}
 					else
 					{
-						m_pNextBouy = m_pNavNet->GetBouy(m_ucNextBouyID);
+						m_pNextBouy = m_pNavNet->GetBouy(m_u16NextBouyID);
 						m_sNextX = m_pNextBouy->GetX();
 						m_sNextZ = m_pNextBouy->GetZ();
 //						rotation.y = rspATan(position.z - m_sNextZ, m_sNextX - position.x);
@@ -583,6 +583,9 @@ void CBand::Update(void)
 	
 					m_dVel			-= m_dDeltaVel;
 				}
+
+				// Steer clear of the rest of the band.
+				AvoidCrowd(dSeconds);
 		
 				break;
 
@@ -595,18 +598,18 @@ void CBand::Update(void)
 				if (lThisTime > m_lTimer)
 				{
 					m_state = State_Mingle;
-					m_ucDestBouyID = SelectRandomBouy();
-               m_ucNextBouyID = m_pNavNet->FindNearestBouy(position.x, position.z);
-					m_pNextBouy = m_pNavNet->GetBouy(m_ucNextBouyID);
+					m_u16DestBouyID = SelectRandomBouy();
+               m_u16NextBouyID = m_pNavNet->FindNearestBouy(position.x, position.z);
+					m_pNextBouy = m_pNavNet->GetBouy(m_u16NextBouyID);
 					m_lTimer = lThisTime + ms_lMingleTime;
-               if (m_ucDestBouyID == 0 || !m_pNextBouy)
+               if (m_u16DestBouyID == 0 || !m_pNextBouy)
 					{
 						m_state = State_Wait;
 					}
 					else
 					{
-						m_ucNextBouyID = m_pNextBouy->NextRouteNode(m_ucDestBouyID);
-						m_pNextBouy = m_pNavNet->GetBouy(m_ucNextBouyID);
+						m_u16NextBouyID = m_pNavNet->NextWaypoint(m_pNextBouy->m_u16ID, m_u16DestBouyID);
+						m_pNextBouy = m_pNavNet->GetBouy(m_u16NextBouyID);
                   if (m_pNextBouy)
 						{
 							m_sNextX = m_pNextBouy->GetX();
@@ -685,25 +688,25 @@ void CBand::Update(void)
 				if ((dX*dX + dZ*dZ) < ms_dCloseToBouy)
 				{
 					// Set next bouy, x, z, and rotation
-					m_ucNextBouyID = m_pNextBouy->NextRouteNode(m_ucDestBouyID);
+					m_u16NextBouyID = m_pNavNet->NextWaypoint(m_pNextBouy->m_u16ID, m_u16DestBouyID);
 					// BEGIN TEMP.
-					LOG(m_pNextBouy->m_ucID, GetInstanceID() );
-					LOG(m_ucDestBouyID, GetInstanceID() );
-					LOG(m_ucNextBouyID, GetInstanceID() );
+					LOG(m_pNextBouy->m_u16ID, GetInstanceID() );
+					LOG(m_u16DestBouyID, GetInstanceID() );
+					LOG(m_u16NextBouyID, GetInstanceID() );
 					// END TEMP.
 
-					if (m_ucNextBouyID == 0 || m_ucNextBouyID == 255)
+					if (m_u16NextBouyID == 0 || m_u16NextBouyID == BOUY_ID_UNREACHABLE)
 					{
 						if (m_panimCur != &m_animRun)
 							m_panimCur = &m_animRun;
-						m_ucDestBouyID = SelectRandomBouy();
-						m_ucNextBouyID = m_pNextBouy->NextRouteNode(m_ucDestBouyID);
+						m_u16DestBouyID = SelectRandomBouy();
+						m_u16NextBouyID = m_pNavNet->NextWaypoint(m_pNextBouy->m_u16ID, m_u16DestBouyID);
 						m_sNextX = m_pNextBouy->GetX();
 						m_sNextZ = m_pNextBouy->GetZ();
 						AlignToBouy();
 						// BEGIN TEMP.
-						LOG(m_ucDestBouyID, GetInstanceID() );
-						LOG(m_ucNextBouyID, GetInstanceID() );
+						LOG(m_u16DestBouyID, GetInstanceID() );
+						LOG(m_u16NextBouyID, GetInstanceID() );
 						LOG(m_sNextX, GetInstanceID() );
 						LOG(m_sNextZ, GetInstanceID() );
 						// END TEMP.
@@ -787,7 +790,7 @@ void CBand::Update(void)
 					}
 					else
 					{
-						m_pNextBouy = m_pNavNet->GetBouy(m_ucNextBouyID);
+						m_pNextBouy = m_pNavNet->GetBouy(m_u16NextBouyID);
                   if (m_pNextBouy)
 						{
 							m_sNextX = m_pNextBouy->GetX();
@@ -816,8 +819,8 @@ void CBand::Update(void)
 				if (bNoWalk == true
 					|| (sHeight - dNewY > 10) )// && m_bAboveTerrain == false && m_dExtHorzVel == 0.0))
 				{
-					m_ucDestBouyID = SelectRandomBouy();
-               m_ucNextBouyID = m_pNavNet->FindNearestBouy(position.x, position.z);
+					m_u16DestBouyID = SelectRandomBouy();
+               m_u16NextBouyID = m_pNavNet->FindNearestBouy(position.x, position.z);
 					m_sNextX = m_pNextBouy->GetX();
 					m_sNextZ = m_pNextBouy->GetZ();
 					m_lAlignTimer = lThisTime + 3000;
@@ -839,8 +842,8 @@ void CBand::Update(void)
 				// Restore Values ////////////////////////////////////////////////////////
 	
 					m_dVel			-= m_dDeltaVel;
-					m_ucDestBouyID = SelectRandomBouy();
-               m_ucNextBouyID = m_pNavNet->FindNearestBouy(position.x, position.z);
+					m_u16DestBouyID = SelectRandomBouy();
+               m_u16NextBouyID = m_pNavNet->FindNearestBouy(position.x, position.z);
 					m_sNextX = m_pNextBouy->GetX();
 					m_sNextZ = m_pNextBouy->GetZ();
 					m_lAlignTimer = lThisTime + 3000;
@@ -860,6 +863,9 @@ void CBand::Update(void)
 					m_sRotateDir = GetRand() % 2;
 				}
 
+				// Steer clear of anyone in the way before running into them.
+				AvoidCrowd(dSeconds);
+
 				break;
 
 //-----------------------------------------------------------------------
@@ -1014,11 +1020,11 @@ int16_t CBand::EditModify(void)
 
 		if (pguiStartBouy)
 		{
-			RSP_SAFE_GUI_REF_VOID(pguiStartBouy, SetText("%d", m_ucNextBouyID));
+			RSP_SAFE_GUI_REF_VOID(pguiStartBouy, SetText("%d", m_u16NextBouyID));
 			RSP_SAFE_GUI_REF((REdit*) pguiStartBouy, m_sCaretPos = strlen(pguiStartBouy->m_szText));
 			RSP_SAFE_GUI_REF_VOID(pguiStartBouy, Compose());
 			
-			RSP_SAFE_GUI_REF_VOID(pguiDestBouy, SetText("%d", m_ucDestBouyID));
+			RSP_SAFE_GUI_REF_VOID(pguiDestBouy, SetText("%d", m_u16DestBouyID));
 			RSP_SAFE_GUI_REF((REdit*) pguiDestBouy, m_sCaretPos = strlen(pguiDestBouy->m_szText));
 			RSP_SAFE_GUI_REF_VOID(pguiDestBouy, Compose());
 
@@ -1060,8 +1066,8 @@ int16_t CBand::EditModify(void)
 
 			if (DoGui(pGui) == GUI_ID_OK)
 			{
-				m_ucNextBouyID = RSP_SAFE_GUI_REF(pguiStartBouy, GetVal());
-				m_ucDestBouyID = RSP_SAFE_GUI_REF(pguiDestBouy, GetVal());
+				m_u16NextBouyID = RSP_SAFE_GUI_REF(pguiStartBouy, GetVal());
+				m_u16DestBouyID = RSP_SAFE_GUI_REF(pguiDestBouy, GetVal());
 				if (plbChildTypes != nullptr)
 					{
 					RGuiItem*	pguiSel	= plbChildTypes->GetSel();
@@ -1391,9 +1397,9 @@ void CBand::OnPanicMsg(Panic_Message* pMessage)
 		m_panimCur = &m_animOnFire;
       m_lAnimTime = GetRand() % m_panimCur->m_psops->totalTime;
 		// Pick a random bouy to run to
-		m_ucDestBouyID = SelectRandomBouy();
-      m_ucNextBouyID = m_pNavNet->FindNearestBouy(position.x, position.z);
-		m_pNextBouy = m_pNavNet->GetBouy(m_ucNextBouyID);
+		m_u16DestBouyID = SelectRandomBouy();
+      m_u16NextBouyID = m_pNavNet->FindNearestBouy(position.x, position.z);
+		m_pNextBouy = m_pNavNet->GetBouy(m_u16NextBouyID);
 		if (m_pNextBouy)
 		{
 			m_sNextX = m_pNextBouy->GetX();
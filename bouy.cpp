@@ -162,6 +162,8 @@
 #include "navnet.h"
 #include "realm.h"
 
+#include <algorithm>
+
 ////////////////////////////////////////////////////////////////////////////////
 // Macros/types/etc.
 ////////////////////////////////////////////////////////////////////////////////
@@ -185,15 +187,12 @@ bool  CBouy::ms_bShowBouys = true;
 CBouy::CBouy(void)
 {
   m_sSuspend = 0;
-  m_paucRouteTable = nullptr;
-  m_sRouteTableSize = 0;
+  m_u16ID = 0;
+  m_u16RouteTableSize = 0;
 }
 
 CBouy::~CBouy(void)
 {
-  if (m_paucRouteTable != nullptr)
-    free(m_paucRouteTable);
-
   // Free resources
   FreeResources();
 }
@@ -348,7 +347,7 @@ int16_t CBouy::Save(										// Returns 0 if successfull, non-zero otherwise
 void CBouy::Startup(void)								// Returns 0 if successfull, non-zero otherwise
 {
 	// At this point we can assume the CHood was loaded, so we init our height
-   position.y = realm()->GetHeight((int16_t) position.x, (int16_t) position.z);
+   position.y = realm()->GetHeight((int32_t) position.x, (int32_t) position.z);
 
 	// Init other stuff
 	// Get pointer to Navigation Net
@@ -454,6 +453,12 @@ int16_t CBouy::EditMove(									// Returns 0 if successfull, non-zero otherwise
    position.y = sY;
    position.z = sZ;
 
+	if (m_pParentNavNet)
+	{
+		m_pParentNavNet->InvalidateGrid();
+		m_pParentNavNet->InvalidateRoutes();
+	}
+
 	return SUCCESS;
 }
 
@@ -487,7 +492,7 @@ void CBouy::EditRender(void)
    m_sPriority = position.z;
 
 	// Layer should be based on info we get from attribute map.
-   m_sLayer = CRealm::GetLayerViaAttrib(realm()->GetLayer((int16_t) position.x, (int16_t) position.z));
+   m_sLayer = CRealm::GetLayerViaAttrib(realm()->GetLayer((int32_t) position.x, (int32_t) position.z));
 
    Object::enqueue(SpriteUpdate); // Update sprite in scene
 }
@@ -569,7 +574,7 @@ int16_t CBouy::GetResources(void)						// Returns 0 if successfull, non-zero oth
 						0,															// Dst.
 						m_pImage->m_sHeight - BOUY_ID_FONT_HEIGHT,	// Dst.
 						"%d",														// Format.
-						(int16_t)m_ucID);										// Src.
+						m_u16ID);										// Src.
 																					
 					// Convert to efficient transparent blit format . . .
 					if (m_pImage->Convert(RImage::FSPR8) != RImage::FSPR8)
@@ -625,6 +630,12 @@ int16_t CBouy::FreeResources(void)						// Returns 0 if successfull, non-zero ot
 
 void CBouy::Unlink(void)
 {
+	// Any bouy with a route to this one may have been routing through it, so
+	// find them before the links are gone.
+	std::vector<uint16_t> au16Affected;
+	m_pParentNavNet->GetConnectedBouys(m_u16ID, &au16Affected);
+	au16Affected.erase(std::remove(au16Affected.begin(), au16Affected.end(), m_u16ID), au16Affected.end());
+
 	// Follow all of this bouy's direct links and unlink this bouy
    for(const managed_ptr<CBouy>& pLinkedBouy : m_aplDirectLinks)
       pLinkedBouy->m_aplDirectLinks.erase(this);
@@ -633,7 +644,10 @@ void CBouy::Unlink(void)
    m_aplDirectLinks.clear();
 
 	// Remove this bouy from the network
-	m_pParentNavNet->RemoveBouy(m_ucID);
+	m_pParentNavNet->RemoveBouy(m_u16ID);
+
+	// Only those bouys need new routing tables
+	m_pParentNavNet->UpdateRoutingTables(au16Affected);
 }
 
 
@@ -643,145 +657,117 @@ void CBouy::Unlink(void)
 //							  routing table.
 ////////////////////////////////////////////////////////////////////////////////
 
-int16_t CBouy::BuildRoutingTable(void)
+int16_t CBouy::BuildRoutingTable(const BouyLinkTable& links)
 {
-	int16_t sResult = SUCCESS;
-	uint8_t* aVisited = nullptr;
-	uint8_t* aDistance = nullptr;
-	uint8_t* aParent = nullptr;
-	uint8_t* pucCurrentNode = nullptr;
-	uint8_t* pucAdjNode = nullptr;
-   managed_ptr<CBouy> pTraverseBouy;
-
-   ASSERT(m_pParentNavNet);
-	int16_t sCurrentNumNodes = m_pParentNavNet->GetNumNodes();
-	RQueue <uint8_t, 256> bfsQueue;
-
-	// Make sure there is enough space in the routing table, or
-	// reallocate it if there isn't enough.
-	if (m_sRouteTableSize < sCurrentNumNodes)
+	ASSERT(!links.aulFirst.empty());
+	uint16_t u16CurrentNumNodes = links.aulFirst.size() - 1;
+	ASSERT(m_u16ID < u16CurrentNumNodes);
+
+	// aFirstHop doubles as the visited flag for the BSF: it holds the direct
+	// link you leave this bouy by to reach each node, BOUY_ID_UNREACHABLE if
+	// the node hasn't been reached yet, and 0 for this bouy itself.
+	std::vector<uint16_t> aFirstHop(u16CurrentNumNodes, BOUY_ID_UNREACHABLE);
+	std::vector<uint16_t> bfsQueue;
+	bfsQueue.reserve(u16CurrentNumNodes);
+
+	// Breadth-First Search
+	aFirstHop[m_u16ID] = 0;
+	bfsQueue.push_back(m_u16ID);
+
+	for (size_t i = 0; i < bfsQueue.size(); i++)
 	{
-		if (m_paucRouteTable != nullptr)
-			free(m_paucRouteTable);
-		m_paucRouteTable = (uint8_t*) malloc(sCurrentNumNodes);
-		m_sRouteTableSize = sCurrentNumNodes;
-	}
-
-	// Allocate memory for use in building the BSF tree
-	aVisited = (uint8_t*) malloc(sCurrentNumNodes);
-	aDistance = (uint8_t*) malloc(sCurrentNumNodes);
-	aParent = (uint8_t*) malloc(sCurrentNumNodes);
-
-	if (m_paucRouteTable != nullptr &&
-	    aVisited != nullptr &&
-		 aDistance != nullptr &&
-		 aParent != nullptr)
-	{
-		// Initialize the table to unreachable and initialize the
-		// BSF data structures.
-      std::memset(m_paucRouteTable, 255, m_sRouteTableSize);
-      std::memset(aVisited, 0, sCurrentNumNodes);
-      std::memset(aDistance, 255, sCurrentNumNodes);
-      std::memset(aParent, 0, sCurrentNumNodes);
-
-		// Breadth-First Search
-		aVisited[m_ucID] = TRUE;
-		aDistance[m_ucID] = 0;
-		bfsQueue.EnQ(&m_ucID);
-
-		while (!bfsQueue.IsEmpty())
+		uint16_t u16CurrentNode = bfsQueue[i];
+		for (uint32_t j = links.aulFirst[u16CurrentNode]; j < links.aulFirst[u16CurrentNode + 1]; j++)
 		{
-			pucCurrentNode = bfsQueue.DeQ();
-			pTraverseBouy = m_pParentNavNet->GetBouy(*pucCurrentNode);
-         for(const managed_ptr<CBouy>& pLinkedBouy : pTraverseBouy->m_aplDirectLinks)
-         {
-				pucAdjNode = &(pLinkedBouy->m_ucID);
-				if (aVisited[*pucAdjNode] == FALSE)
-				{
-					aVisited[*pucAdjNode] = TRUE;
-					aParent[*pucAdjNode] = *pucCurrentNode;
-					aDistance[*pucAdjNode] = aDistance[*pucCurrentNode] + 1;
-					bfsQueue.EnQ(pucAdjNode);
-            }
+			uint16_t u16AdjNode = links.au16Links[j];
+			if (aFirstHop[u16AdjNode] == BOUY_ID_UNREACHABLE)
+			{
+				// Directly connected nodes are their own first hop, everything
+				// further out inherits the first hop of the node that found it.
+				if (u16CurrentNode == m_u16ID)
+					aFirstHop[u16AdjNode] = u16AdjNode;
+				else
+					aFirstHop[u16AdjNode] = aFirstHop[u16CurrentNode];
+				bfsQueue.push_back(u16AdjNode);
 			}
 		}
+	}
 
-		// Breadth-First Search complete.
-
-		// Now the aDistance contains the hop count to all other connected nodes
-		// and aParent provides a way to build the routing table by traversing
-		// backwards.
-
-		uint8_t ucCurrentDistance;
-		uint8_t curr;
-		int16_t j;
-
-		for (j = 1; j < sCurrentNumNodes; j++)
-		{
-			ucCurrentDistance = aDistance[j];
-			// If distance is 255 (infinite flag) then mark that node
-			// as unreachable in the routing table using 255 as the flag
-			if (ucCurrentDistance == 255)
-			{
-				m_paucRouteTable[j] = 255;
-			}
-			else
-			{
-				// If distance is 0, then this is the node, and mark it in the
-				// routing table as 0, meaning you have reached your final destination
-				if (j == m_ucID)
-				{
-					m_paucRouteTable[j] = 0;
-				}
-				else
-				{
-					// If the distance is 1, it is a directly connected node, so put
-					// its ID in the routing table as the node to go to.
-					if (ucCurrentDistance == 1)
-					{
-						m_paucRouteTable[j] = j;
-					}
-					else
-					{
-						// Else, its a child of a directly connected node, so find out which
-						// one by tracing back along the parent tree.
-						curr = j;
+	// Breadth-First Search complete.
 
-						while (aParent[curr] != m_ucID)
-							curr = aParent[curr];
+	// ID 0 is never assigned, so it is always unreachable.
+	if (u16CurrentNumNodes > 0)
+		aFirstHop[0] = BOUY_ID_UNREACHABLE;
 
-						m_paucRouteTable[j] = curr;
-					}
-				}
-			}
-		}
+	// Collapse the table into runs of destinations with the same next hop.
+	m_aRouteRuns.clear();
+	m_au8RouteDense.clear();
+	m_au16RouteHops.clear();
+	for (uint16_t j = 0; j < u16CurrentNumNodes; j++)
+	{
+		if (m_aRouteRuns.empty() || m_aRouteRuns.back().u16Next != aFirstHop[j])
+			m_aRouteRuns.push_back({ j, aFirstHop[j] });
 	}
-	else
+	m_u16RouteTableSize = u16CurrentNumNodes;
+
+	// If the next hops alternate so much that the runs cost more than a byte
+	// per node, keep the row dense instead.  Every next hop is a direct link,
+	// 0 or BOUY_ID_UNREACHABLE, so there are few enough to index by a byte.
+	std::vector<uint16_t> au16Hops(aFirstHop);
+	std::sort(au16Hops.begin(), au16Hops.end());
+	au16Hops.erase(std::unique(au16Hops.begin(), au16Hops.end()), au16Hops.end());
+	if (au16Hops.size() <= 256 &&
+		 m_aRouteRuns.size() * sizeof(RouteRun) > u16CurrentNumNodes + au16Hops.size() * sizeof(uint16_t))
 	{
-		TRACE("CBouy::BuildRoutingTable: Error allocating memory for tables for bouy %d\n", m_ucID);
-		sResult = FAILURE;
+		m_aRouteRuns.clear();
+		m_au16RouteHops = au16Hops;
+		m_au8RouteDense.resize(u16CurrentNumNodes);
+		for (uint16_t j = 0; j < u16CurrentNumNodes; j++)
+			m_au8RouteDense[j] = uint8_t(std::lower_bound(au16Hops.begin(), au16Hops.end(), aFirstHop[j]) - au16Hops.begin());
 	}
+	m_aRouteRuns.shrink_to_fit();
 
-	if (aVisited)
-		free(aVisited);
-	if (aDistance)
-		free(aDistance);
-	if (aParent)
-		free(aParent);
-
-	return sResult;
+	return SUCCESS;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 // NextRouteNode - Tells you which node to go to next to get to your destination
 ////////////////////////////////////////////////////////////////////////////////
 
-uint8_t CBouy::NextRouteNode(uint8_t dst)
+uint16_t CBouy::NextRouteNode(uint16_t dst)
 {
-	if (dst >= m_pParentNavNet->GetNumNodes())
-		return 255;
+	if (dst >= m_u16RouteTableSize)
+		return BOUY_ID_UNREACHABLE;
+
+	if (!m_au8RouteDense.empty())
+		return m_au16RouteHops[m_au8RouteDense[dst]];
+
+	// Find the last run that starts at or before dst.
+	auto iter = std::upper_bound(m_aRouteRuns.begin(), m_aRouteRuns.end(), dst,
+		[](uint16_t u16Dst, const RouteRun& run) { return u16Dst < run.u16FirstDst; });
+	ASSERT(iter != m_aRouteRuns.begin());
+	return (iter - 1)->u16Next;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// ReadID - Read a bouy ID saved by doofuses, band members and navnets
+////////////////////////////////////////////////////////////////////////////////
+
+void CBouy::ReadID(
+	RFile* pFile,											// In:  File to read from
+	uint32_t ulFileVersion,								// In:  Version of file format being read
+	uint16_t* pu16ID)										// Out: Bouy ID
+{
+	if (ulFileVersion < BOUY_WIDE_ID_FILE_VERSION)
+	{
+		uint8_t ucID = 0;
+		pFile->Read(&ucID);
+		*pu16ID = ucID;
+	}
 	else
-		return m_paucRouteTable[dst];	
+	{
+		pFile->Read(pu16ID);
+	}
 }
 
 ////////////////////////////////////////////////////////////////////////////////
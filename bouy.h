@@ -63,6 +63,25 @@
 #include "thing.h"
 #include <newpix/sprite_base.h>
 
+#include <vector>
+
+// Bouy IDs are 16 bit.  ID 0 is never assigned, so NextRouteNode() uses it
+// to mean "you are here" and BOUY_ID_UNREACHABLE to mean "no route".
+#define BOUY_ID_UNREACHABLE			0xFFFF
+#define BOUY_MAX_ID						0xFFFE
+
+// Realm file version at which saved bouy IDs grew from 8 to 16 bits.
+#define BOUY_WIDE_ID_FILE_VERSION	50
+
+// Flattened copy of a nav net's links, indexed by bouy ID.  Routing tables
+// are built from this rather than from the bouys themselves so that several
+// can be built at once on worker threads.
+typedef struct
+	{
+	std::vector<uint32_t> aulFirst;		// Start of each ID's links in au16Links, plus one past the last
+	std::vector<uint16_t> au16Links;		// Linked bouy IDs, ascending for each bouy
+	} BouyLinkTable;
+
 // Template node class for linked lists
 template <class Owner, class K>
 class CTreeListNode
@@ -218,17 +237,34 @@ class CBouy
 	// Variables
 	//---------------------------------------------------------------------------
 	public:
-		uint8_t	m_ucID;								// Bouy ID (or address)
+		uint16_t	m_u16ID;								// Bouy ID (or address)
       std::set<managed_ptr<CBouy>> m_aplDirectLinks;
-		TreeListNode m_TreeNode;
 
 	protected:
       managed_ptr<CNavigationNet> m_pParentNavNet;		// Pointer to its navigation network
 
 		int16_t m_sSuspend;							// Suspend flag
 
-		uint8_t* m_paucRouteTable;				// Routing table (new non-STL way)
-      int16_t m_sRouteTableSize;
+		// The routing table is stored as runs of consecutive destination IDs
+		// that share the same next hop.  Bouys tend to be numbered in the order
+		// they were laid down, so each direct link usually leads to a few
+		// contiguous blocks of IDs and a row costs far less than one entry
+		// per node in the network.  A run costs 4 bytes though, so when the
+		// next hops alternate the row is kept dense instead: one byte per
+		// node, indexing the few distinct next hops (direct links, 0 and
+		// BOUY_ID_UNREACHABLE).  Either way, for a bouy with at most 254
+		// direct links, a row never costs more than one byte per node plus
+		// two per distinct next hop.
+		typedef struct
+			{
+			uint16_t	u16FirstDst;					// First destination ID of this run
+			uint16_t	u16Next;							// Next hop for every ID in the run
+			} RouteRun;
+
+		std::vector<RouteRun> m_aRouteRuns;		// Routing table, sorted by u16FirstDst (or empty if dense)
+		std::vector<uint8_t> m_au8RouteDense;	// Dense routing table, index into m_au16RouteHops per ID (or empty)
+		std::vector<uint16_t> m_au16RouteHops;	// Distinct next hops of the dense table
+		uint16_t m_u16RouteTableSize;				// Number of destination IDs it covers
 
 		// Tracks file counter so we know when to load/save "common" data 
 		static int16_t ms_sFileCount;
@@ -307,7 +343,7 @@ class CBouy
 		// Get the next link to follow to get to this destination.  This is
 		// normally a routing table lookup unless the entry is not in the routing
 		// table, then it is discovered and added as an entry to the routing table.
-		uint8_t NextRouteNode(uint8_t dst);
+		uint16_t NextRouteNode(uint16_t dst);
 
 		// Disconnect this node from the network.  This will visit all of its
 		// direct links and remove itself from their link list and then free
@@ -315,20 +351,32 @@ class CBouy
 		// editor.
 		void Unlink(void);
 
-		// Fill in all entries in the routing table.
-		int16_t BuildRoutingTable(void);
+		// Fill in all entries in the routing table.  Only reads links and
+		// writes this bouy's table, so different bouys may be built at once.
+		int16_t BuildRoutingTable(const BouyLinkTable& links);
 
 		// Print the routing table for this bouy - for debugging
 		void PrintRouteTable(FILE* fp)
 		{
-			int16_t i;
 			char szLine[256];
-			for (i = 0; i < m_sRouteTableSize; i++)
+			for (const RouteRun& run : m_aRouteRuns)
 			{
-				sprintf(szLine, "%d next %d\n", i, m_paucRouteTable[i]);
+				sprintf(szLine, "%d+ next %d\n", run.u16FirstDst, run.u16Next);
 				fwrite(szLine, sizeof(char), strlen(szLine), fp);				
 			}
+			for (size_t i = 0; i < m_au8RouteDense.size(); i++)
+			{
+				sprintf(szLine, "%d next %d\n", int(i), m_au16RouteHops[m_au8RouteDense[i]]);
+				fwrite(szLine, sizeof(char), strlen(szLine), fp);
+			}
 		}
+
+		// Read a saved bouy ID.  Realm files before BOUY_WIDE_ID_FILE_VERSION
+		// stored it as a single byte.
+		static void ReadID(
+			RFile* pFile,											// In:  File to read from
+			uint32_t ulFileVersion,								// In:  Version of file format being read
+			uint16_t* pu16ID);									// Out: Bouy ID
 		
 		// Used by gameedit to know is this bouy is visible or hidden
 		bool Visible(void)
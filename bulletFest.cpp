@@ -748,12 +748,12 @@ bool CBulletFest::Fire(			// Returns true if a hit, false otherwise.
 	// This makes them appear to be unhindered by the edge of the realm.
 	// (except the bottom edge which is greater so that, if the bullet 
 	// is exceptionally high, it will go, hopefully, entirely off screen).	
-	int16_t	sMaxX			= pRealm->GetRealmWidth() + 10;
+	int32_t	lMaxX			= pRealm->GetRealmWidth() + 10;
 	int16_t	sMaxY			= 512;					// Robustness: Guard against infinite loop
 														// in the remote possibility that we shoot
 														// straight up (currently one can only shoot
 														// horizontally).
-	int16_t	sMaxZ			= pRealm->GetRealmHeight() + sY + 10;
+	int32_t	lMaxZ			= pRealm->GetRealmHeight() + sY + 10;
 
 	int16_t	sMinX			= -10;
 	int16_t	sMinY			= -512;
@@ -766,11 +766,11 @@ bool CBulletFest::Fire(			// Returns true if a hit, false otherwise.
 			fPosX > sMinX 
 		&& fPosY > sMinY 
 		&& fPosZ > sMinZ 
-		&& fPosX < sMaxX 
+		&& fPosX < lMaxX 
 		&& fPosY < sMaxY 
-		&& fPosZ < sMaxZ)
+		&& fPosZ < lMaxZ)
 		{
-		sCurH = pRealm->GetHeight((int16_t) fPosX, (int16_t) fPosZ);
+		sCurH = pRealm->GetHeight((int32_t) fPosX, (int32_t) fPosZ);
 		// If bullet below or at terrain . . .
 		if (fPosY <=  sCurH)
 			{
@@ -902,7 +902,7 @@ bool CBulletFest::Fire(			// Returns true if a hit, false otherwise.
             psl2d->m_sX2End,
             psl2d->m_sY2End);
 			psl2d->m_sPriority	= fStartZ;
-			psl2d->m_sLayer		= CRealm::GetLayerViaAttrib(pRealm->GetLayer((int16_t) fStartX, (int16_t) fStartZ));
+			psl2d->m_sLayer		= CRealm::GetLayerViaAttrib(pRealm->GetLayer((int32_t) fStartX, (int32_t) fStartZ));
 			psl2d->m_u8Color		= ms_u8TracerIndex;
 			// Destroy when done.
          psl2d->flags.DeleteOnRender = true;
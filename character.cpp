@@ -1522,12 +1522,12 @@ bool CCharacter::IsPathClear(	// Returns true, if the entire path is clear.
 	float	fTotalDistXZ	= 0.0F;
 
 	// Store extents.
-   int16_t	sMaxX			= realm()->GetRealmWidth();
+   int32_t	lMaxX			= realm()->GetRealmWidth();
 	int16_t	sMaxY			= 512;					// Robustness: Guard against infinite loop
 														// in the remote possibility that we shoot
 														// straight up (currently one can only shoot
 														// horizontally).
-   int16_t	sMaxZ			= realm()->GetRealmHeight();
+   int32_t	lMaxZ			= realm()->GetRealmHeight();
 
 	int16_t	sMinX			= 0;
 	int16_t	sMinY			= -512;
@@ -1541,9 +1541,9 @@ bool CCharacter::IsPathClear(	// Returns true, if the entire path is clear.
 			fPosX > sMinX 
 		&& fPosY > sMinY 
 		&& fPosZ > sMinZ 
-		&& fPosX < sMaxX 
+		&& fPosX < lMaxX 
 		&& fPosY < sMaxY 
-		&& fPosZ < sMaxZ
+		&& fPosZ < lMaxZ
 		&& fTotalDistXZ < sRangeXZ)
 		{
       GetFloorAttributes((int16_t)fPosX, (int16_t)fPosZ, u16Attribute, sCurH);
@@ -224,7 +224,7 @@ void CChunk::Render(void)
   m_sPriority = position.z;
 
   // Layer should be based on info we get from attribute map.
-  m_sLayer = CRealm::GetLayerViaAttrib(realm()->GetLayer((int16_t) position.x, (int16_t) position.z));
+  m_sLayer = CRealm::GetLayerViaAttrib(realm()->GetLayer((int32_t) position.x, (int32_t) position.z));
 
   Object::enqueue(SpriteUpdate); // Update sprite in scene
 }
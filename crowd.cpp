@@ -0,0 +1,232 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2016 RWS Inc, All Rights Reserved
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of version 2 of the GNU General Public License as published by
+// the Free Software Foundation
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+//
+// crowd.cpp
+// Project: Postal
+//
+// This module implements the local avoidance that keeps crowds of characters
+// from walking into each other.  See crowd.h.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include "crowd.h"
+
+#include "realm.h"
+#include "Thing3d.h"
+
+#include <cmath>
+
+////////////////////////////////////////////////////////////////////////////////
+// Macros/types/etc.
+////////////////////////////////////////////////////////////////////////////////
+
+// Kinds of things that make up a crowd.  Dudes don't steer, but the others
+// still keep out of their way.
+static const ClassIDType	ms_aidCrowdTypes[]	=
+	{
+	CPersonID, CBandID, COstrichID, CDudeID
+	};
+
+////////////////////////////////////////////////////////////////////////////////
+// Constructor / destructor.
+////////////////////////////////////////////////////////////////////////////////
+CCrowd::CCrowd(void)
+	{
+	}
+
+CCrowd::~CCrowd(void)
+	{
+	Reset();
+	}
+
+////////////////////////////////////////////////////////////////////////////////
+// Hash the realm's living characters.
+////////////////////////////////////////////////////////////////////////////////
+void CCrowd::Build(
+	CRealm* prealm)				// In:  Realm to gather characters from
+	{
+	m_aUnsorted.clear();
+	m_aulFirst.assign(CROWD_HASH_SIZE + 1, 0);
+
+	for (ClassIDType id : ms_aidCrowdTypes)
+		{
+		for (const managed_ptr<CThing>& pThing : prealm->GetThingsByType(id))
+			{
+			managed_ptr<CThing3d> pthing3d = pThing;
+			if (pthing3d->m_state == CThing3d::State_Dead)
+				continue;
+
+			int16_t	sRot	= rspMod360(pthing3d->rotation.y);
+			Member	member;
+			member.dX		= pthing3d->position.x;
+			member.dZ		= pthing3d->position.z;
+			member.dVelX	= COSQ[sRot] * pthing3d->m_dVel;
+			member.dVelZ	= -SINQ[sRot] * pthing3d->m_dVel;
+			member.u16ID	= pthing3d->GetInstanceID();
+			member.bSteers	= id != CDudeID;
+			m_aUnsorted.push_back(member);
+
+			// Count it in its bucket.
+			m_aulFirst[Bucket(int32_t(member.dX) >> CROWD_CELL_SHIFT, int32_t(member.dZ) >> CROWD_CELL_SHIFT) + 1]++;
+			}
+		}
+
+	// Turn the counts into the first index of each bucket.
+	uint32_t	ulBucket;
+	for (ulBucket = 1; ulBucket <= CROWD_HASH_SIZE; ulBucket++)
+		m_aulFirst[ulBucket]	+= m_aulFirst[ulBucket - 1];
+
+	// Drop each member into the next free slot of its bucket.
+	std::vector<uint32_t>	aulNext(m_aulFirst.begin(), m_aulFirst.end() - 1);
+	m_aMembers.resize(m_aUnsorted.size());
+	for (const Member& member : m_aUnsorted)
+		{
+		ulBucket	= Bucket(int32_t(member.dX) >> CROWD_CELL_SHIFT, int32_t(member.dZ) >> CROWD_CELL_SHIFT);
+		m_aMembers[aulNext[ulBucket]++]	= member;
+		}
+	}
+
+////////////////////////////////////////////////////////////////////////////////
+// Forget all characters.
+////////////////////////////////////////////////////////////////////////////////
+void CCrowd::Reset(void)
+	{
+	m_aMembers.clear();
+	m_aUnsorted.clear();
+	m_aulFirst.clear();
+	}
+
+////////////////////////////////////////////////////////////////////////////////
+// Get a velocity to add to a character's own to keep clear of its neighbors.
+// For each neighbor, find when the two will be closest if both keep going as
+// they are, and push away from that spot.  Meetings that are closer and sooner
+// push harder.  A neighbor that steers too pushes back the other way, so
+// each of the two takes half the push, in the manner of RVO.  A neighbor
+// that doesn't steer leaves all of it to us.
+////////////////////////////////////////////////////////////////////////////////
+bool CCrowd::GetAvoidance(		// Returns true if there is anyone to avoid
+	uint16_t u16ID,				// In:  Instance ID of the character (skipped)
+	double dX,						// In:  Character's position
+	double dZ,
+	double dVelX,					// In:  Character's velocity
+	double dVelZ,
+	double* pdAvoidX,				// Out: Velocity to add
+	double* pdAvoidZ)
+	{
+	*pdAvoidX	= 0.0;
+	*pdAvoidZ	= 0.0;
+	if (m_aulFirst.empty())
+		return false;
+
+	// Gather the buckets of the 3x3 cells around, skipping repeats so nobody
+	// gets counted twice.
+	uint32_t	aulBuckets[9];
+	int16_t	sNumBuckets	= 0;
+	int32_t	lCellX	= int32_t(dX) >> CROWD_CELL_SHIFT;
+	int32_t	lCellZ	= int32_t(dZ) >> CROWD_CELL_SHIFT;
+	int16_t	i;
+	for (int32_t lZ = lCellZ - 1; lZ <= lCellZ + 1; lZ++)
+		{
+		for (int32_t lX = lCellX - 1; lX <= lCellX + 1; lX++)
+			{
+			uint32_t	ulBucket	= Bucket(lX, lZ);
+			for (i = 0; i < sNumBuckets && aulBuckets[i] != ulBucket; i++)
+				;
+			if (i == sNumBuckets)
+				aulBuckets[sNumBuckets++]	= ulBucket;
+			}
+		}
+
+	bool	bAvoid	= false;
+	for (i = 0; i < sNumBuckets; i++)
+		{
+		uint32_t	ulEnd	= m_aulFirst[aulBuckets[i] + 1];
+		for (uint32_t ul = m_aulFirst[aulBuckets[i]]; ul < ulEnd; ul++)
+			{
+			const Member&	member	= m_aMembers[ul];
+			if (member.u16ID == u16ID)
+				continue;
+
+			// Where the neighbor is and how fast it's closing, relative to us.
+			double	dPosX	= member.dX - dX;
+			double	dPosZ	= member.dZ - dZ;
+			if (dPosX * dPosX + dPosZ * dPosZ > CROWD_NEIGHBOR_DIST * CROWD_NEIGHBOR_DIST)
+				continue;
+			double	dRelVelX	= member.dVelX - dVelX;
+			double	dRelVelZ	= member.dVelZ - dVelZ;
+
+			// Time of closest approach, within the horizon.
+			double	dTime	= 0.0;
+			double	dRelVelSq	= dRelVelX * dRelVelX + dRelVelZ * dRelVelZ;
+			if (dRelVelSq > 0.0)
+				{
+				dTime	= -(dPosX * dRelVelX + dPosZ * dRelVelZ) / dRelVelSq;
+				if (dTime < 0.0)
+					dTime	= 0.0;
+				else if (dTime > CROWD_TIME_HORIZON)
+					dTime	= CROWD_TIME_HORIZON;
+				}
+
+			// Where the neighbor will be then.
+			double	dMeetX	= dPosX + dRelVelX * dTime;
+			double	dMeetZ	= dPosZ + dRelVelZ * dTime;
+			double	dMeet		= std::sqrt(dMeetX * dMeetX + dMeetZ * dMeetZ);
+			if (dMeet >= CROWD_PERSONAL_SPACE)
+				continue;
+
+			// Right on top of each other gives no direction, so step aside by
+			// ID, which the neighbor will do the other way.
+			if (dMeet < 0.5)
+				{
+				dMeetX	= member.u16ID < u16ID ? -1.0 : 1.0;
+				dMeetZ	= 0.0;
+				dMeet		= 1.0;
+				}
+
+			double	dPush	= CROWD_MAX_AVOID_VEL * (1.0 - dMeet / CROWD_PERSONAL_SPACE) / (1.0 + dTime);
+			if (member.bSteers)
+				dPush	*= 0.5;
+			*pdAvoidX	-= dMeetX / dMeet * dPush;
+			*pdAvoidZ	-= dMeetZ / dMeet * dPush;
+			bAvoid	= true;
+			}
+		}
+
+	// Don't let a crowd throw anyone around.
+	double	dAvoid	= std::sqrt(*pdAvoidX * *pdAvoidX + *pdAvoidZ * *pdAvoidZ);
+	if (dAvoid > CROWD_MAX_AVOID_VEL)
+		{
+		*pdAvoidX	*= CROWD_MAX_AVOID_VEL / dAvoid;
+		*pdAvoidZ	*= CROWD_MAX_AVOID_VEL / dAvoid;
+		}
+
+	return bAvoid;
+	}
+
+////////////////////////////////////////////////////////////////////////////////
+// Hash bucket for a cell.
+////////////////////////////////////////////////////////////////////////////////
+uint32_t CCrowd::Bucket(
+	int32_t lCellX,				// In:  Cell coordinates
+	int32_t lCellZ)
+	{
+	return (uint32_t(lCellX) * 73856093u ^ uint32_t(lCellZ) * 19349663u) & (CROWD_HASH_SIZE - 1);
+	}
+
+////////////////////////////////////////////////////////////////////////////////
+// EOF
+////////////////////////////////////////////////////////////////////////////////
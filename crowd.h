@@ -0,0 +1,119 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2016 RWS Inc, All Rights Reserved
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of version 2 of the GNU General Public License as published by
+// the Free Software Foundation
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+//
+// crowd.h
+// Project: Postal
+//
+// Local avoidance for crowds of characters.  Once per realm update, Build()
+// drops every living character into a spatial hash (a counting sort, so it
+// takes linear time).  A character on the move can then ask GetAvoidance()
+// for a velocity that steers it clear of where its neighbors are headed,
+// before they actually meet.
+//
+////////////////////////////////////////////////////////////////////////////////
+#ifndef CROWD_H
+#define CROWD_H
+
+#include <RSPiX.h>
+
+#include <vector>
+
+class CRealm;
+
+// Hash cells are this many bits of realm units on a side (32).  Must be at
+// least CROWD_NEIGHBOR_DIST so neighbors are always in the 3x3 cells around.
+#define CROWD_CELL_SHIFT			5
+
+// Number of hash buckets (a power of 2).
+#define CROWD_HASH_SIZE				1024
+
+// Characters closer than this are considered neighbors.
+#define CROWD_NEIGHBOR_DIST		32.0
+
+// Characters try to keep this far apart, center to center.
+#define CROWD_PERSONAL_SPACE		16.0
+
+// Seconds ahead to look for meetings.
+#define CROWD_TIME_HORIZON			1.0
+
+// Fastest avoidance velocity.
+#define CROWD_MAX_AVOID_VEL		40.0
+
+class CCrowd
+	{
+	//---------------------------------------------------------------------------
+	// Types, enums, etc.
+	//---------------------------------------------------------------------------
+	protected:
+		typedef struct
+			{
+			double	dX;							// Position
+			double	dZ;
+			double	dVelX;						// Velocity
+			double	dVelZ;
+			uint16_t	u16ID;						// Instance ID
+			bool		bSteers;						// true, if it avoids us too
+			} Member;
+
+	//---------------------------------------------------------------------------
+	// Variables
+	//---------------------------------------------------------------------------
+	protected:
+		std::vector<Member> m_aMembers;		// Members sorted by bucket
+		std::vector<Member> m_aUnsorted;		// Members in the order found
+		std::vector<uint32_t> m_aulFirst;	// First member of each bucket (and one past the last)
+
+	//---------------------------------------------------------------------------
+	// Constructor(s) / destructor
+	//---------------------------------------------------------------------------
+	public:
+		CCrowd(void);
+		~CCrowd(void);
+
+	//---------------------------------------------------------------------------
+	// Functions
+	//---------------------------------------------------------------------------
+	public:
+		// Hash the realm's living characters.
+		void Build(
+			CRealm* prealm);						// In:  Realm to gather characters from
+
+		// Forget all characters.
+		void Reset(void);
+
+		// Get a velocity to add to a character's own to keep clear of its
+		// neighbors.
+		bool GetAvoidance(						// Returns true if there is anyone to avoid
+			uint16_t u16ID,						// In:  Instance ID of the character (skipped)
+			double dX,								// In:  Character's position
+			double dZ,
+			double dVelX,							// In:  Character's velocity
+			double dVelZ,
+			double* pdAvoidX,						// Out: Velocity to add
+			double* pdAvoidZ);
+
+	protected:
+		// Hash bucket for a cell.
+		static uint32_t Bucket(
+			int32_t lCellX,						// In:  Cell coordinates
+			int32_t lCellZ);
+	};
+
+#endif // CROWD_H
+////////////////////////////////////////////////////////////////////////////////
+// EOF
+////////////////////////////////////////////////////////////////////////////////
@@ -490,7 +490,7 @@ void CDeathWad::Render(void)
       m_sPriority = position.z;
 
 		// Layer should be based on info we get from the attribute map
-      m_sLayer = CRealm::GetLayerViaAttrib(realm()->GetLayer((int16_t) position.x, (int16_t) position.z));
+      m_sLayer = CRealm::GetLayerViaAttrib(realm()->GetLayer((int32_t) position.x, (int32_t) position.z));
 
       m_ptrans		= &m_trans;
 
@@ -445,6 +445,13 @@
 #define	NEAR_DEATH_HITPOINTS 31							// Below this, start writhing
 #define  MS_BETWEEN_SAMPLES	100						// Time between pain groans.
 #define  BURNT_BRIGHTNESS		-40						// -128 to 127.
+#define	FLOW_HOLD_COST	(8 * FLOWFIELD_STRAIGHT_COST)	// Flow field hunters hold this close to the dude.
+
+// Think priorities.  Deferred thinks gain priority each update so none starve.
+#define	THINK_WAIT_PRIORITY		256						// Per update put off.
+#define	THINK_NEAR_PRIORITY		1024						// Most for being near the dude.
+#define	THINK_HIT_PRIORITY		2048						// For having been hurt recently.
+#define	THINK_HIT_TIME				2000						// Time being hurt counts as recent.
 
 ////////////////////////////////////////////////////////////////////////////////
 // Variables/data
@@ -747,7 +754,7 @@ CDoofus::CDoofus(void)
 {
   m_sSuspend = 0;
   m_sNextX = m_sNextZ = 0.0;
-  m_ucDestBouyID = m_ucNextBouyID = 0;
+  m_u16DestBouyID = m_u16NextBouyID = 0;
   m_lAlignTimer = 0;
   m_lEvalTimer = 0;
   m_lShootTimer = 0;
@@ -757,11 +764,15 @@ CDoofus::CDoofus(void)
   m_lLastHelpCallTime = 0;
   m_lSampleTimeIsPlaying = 0;
   m_bRecentlyStuck = false;
+  m_bFlowHunt = false;
+  m_bThinkPending = false;
+  m_u16ThinkWaits = 0;
+  m_lLastHitTime = 0;
   m_bCivilian = false;
   //m_ptransExecutionTarget	= nullptr;
   //	m_spriteWeapon.m_pthing	= this;
-  m_ucSpecialBouy0ID = 0;
-  m_ucSpecialBouy1ID = 0;
+  m_u16SpecialBouy0ID = 0;
+  m_u16SpecialBouy1ID = 0;
   m_bPanic = false;
   m_bRegisteredBirth = false;
   // Default to no fallback weapon.
@@ -833,8 +844,8 @@ int16_t CDoofus::Load(										// Returns 0 if successfull, non-zero otherwise
 		{
 			default:
 			case 43:
-				pFile->Read(&m_ucSpecialBouy0ID);
-				pFile->Read(&m_ucSpecialBouy1ID);
+				CBouy::ReadID(pFile, ulFileVersion, &m_u16SpecialBouy0ID);
+				CBouy::ReadID(pFile, ulFileVersion, &m_u16SpecialBouy1ID);
 
 			case 42:
 			case 41:
@@ -929,8 +940,8 @@ int16_t CDoofus::Save(										// Returns 0 if successfull, non-zero otherwise
 
 		// Save the instance ID for the parent NavNet so it can be connected
 		// again after load
-		pFile->Write(&m_ucSpecialBouy0ID);
-		pFile->Write(&m_ucSpecialBouy1ID);
+		pFile->Write(&m_u16SpecialBouy0ID);
+		pFile->Write(&m_u16SpecialBouy1ID);
       uint16_t u16Data = invalid_id;	// Safety.
 		if (m_pNavNet)
 			u16Data	= m_pNavNet->GetInstanceID();
@@ -1134,7 +1145,7 @@ int16_t CDoofus::SelectDudeBouy(void)
       {
       if (m_dude)
 			{
-         m_ucDestBouyID = m_pNavNet->FindNearestBouy(m_dude->GetX(), m_dude->GetZ());
+         m_u16DestBouyID = m_pNavNet->FindNearestBouy(m_dude->GetX(), m_dude->GetZ());
 			}
 		}
 	else
@@ -1144,7 +1155,7 @@ int16_t CDoofus::SelectDudeBouy(void)
    if (realm()->m_asClassNumThings[CDudeID] > 0)
 	{
       pDude = (CDude*) realm()->m_aclassHeads[CDudeID].GetNext();
-		m_ucDestBouyID = m_pNavNet->FindNearestBouy(pDude->GetX(), pDude->GetZ());
+		m_u16DestBouyID = m_pNavNet->FindNearestBouy(pDude->GetX(), pDude->GetZ());
 	}
 	else
 	{
@@ -1155,8 +1166,8 @@ int16_t CDoofus::SelectDudeBouy(void)
 			pBouytest = nullptr;
 			while (pBouytest == nullptr)		
 			{
-				m_ucDestBouyID = GetRandom() % m_pNavNet->GetNumNodes();
-				pBouytest = m_pNavNet->GetBouy(m_ucDestBouyID);		
+				m_u16DestBouyID = GetRandom() % m_pNavNet->GetNumNodes();
+				pBouytest = m_pNavNet->GetBouy(m_u16DestBouyID);		
 			}
 		}
 	}
@@ -1169,9 +1180,9 @@ int16_t CDoofus::SelectDudeBouy(void)
 // SelectRandomBouy - make sure it exists before setting it
 ////////////////////////////////////////////////////////////////////////////////
 
-uint8_t CDoofus::SelectRandomBouy(void)
+uint16_t CDoofus::SelectRandomBouy(void)
 {
-	uint8_t ucSelect = 0;
+	uint16_t u16Select = 0;
    managed_ptr<CBouy> pBouy;
 
 	if (m_pNavNet->GetNumNodes() <= 1)
@@ -1179,10 +1190,10 @@ uint8_t CDoofus::SelectRandomBouy(void)
 
    while(!pBouy)
 	{
-		ucSelect = GetRandom() % m_pNavNet->GetNumNodes();
-		pBouy = m_pNavNet->GetBouy(ucSelect);
+		u16Select = GetRandom() % m_pNavNet->GetNumNodes();
+		pBouy = m_pNavNet->GetBouy(u16Select);
 	}
-	return ucSelect;
+	return u16Select;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -1284,15 +1295,20 @@ void CDoofus::AlignToBouy(void)
    milliseconds_t lThisTime = realm()->m_time.GetGameTime();
 	if (lThisTime > m_lAlignTimer || m_bRecentlyStuck)
 	{
-		// If he got stuck and is now free, pick a new bouy
-		if (m_bRecentlyStuck)
+		// If he got stuck and is now free, pick a new bouy.  Flow field
+		// hunters get a fresh waypoint every update anyway.
+		if (m_bRecentlyStuck && m_bFlowHunt && m_state == State_HuntNext)
+		{
+			m_bRecentlyStuck = false;
+		}
+		else if (m_bRecentlyStuck)
 		{
 			m_bRecentlyStuck = false;
-         m_ucNextBouyID = m_pNavNet->FindNearestBouy(position.x, position.z);
+         m_u16NextBouyID = m_pNavNet->FindNearestBouy(position.x, position.z);
 
-			if (m_ucNextBouyID > 0)
+			if (m_u16NextBouyID > 0)
 			{
-				m_pNextBouy = m_pNavNet->GetBouy(m_ucNextBouyID);
+				m_pNextBouy = m_pNavNet->GetBouy(m_u16NextBouyID);
             if (m_pNextBouy)
 				{
 					m_sNextX = m_pNextBouy->GetX();
@@ -1305,6 +1321,89 @@ void CDoofus::AlignToBouy(void)
 	}
 }
 
+////////////////////////////////////////////////////////////////////////////////
+// AvoidCrowd - Step aside from characters we're about to walk into, so crowds
+//					 flow around each other instead of piling up.
+////////////////////////////////////////////////////////////////////////////////
+
+void CDoofus::AvoidCrowd(double dSeconds)
+{
+	if (g_GameSettings.m_sCrowdAvoidance == FALSE)
+		return;
+
+   int16_t sRot = rspMod360(rotation.y);
+	double dAvoidX;
+	double dAvoidZ;
+   if (realm()->m_crowd.GetAvoidance(GetInstanceID(), position.x, position.z,
+		COSQ[sRot] * m_dVel, -SINQ[sRot] * m_dVel, &dAvoidX, &dAvoidZ))
+	{
+      double dNewX = position.x + dAvoidX * dSeconds;
+      double dNewY = position.y;
+      double dNewZ = position.z + dAvoidZ * dSeconds;
+		MakeValidPosition(&dNewX, &dNewY, &dNewZ, MaxStepUpThreshold);
+      position.x = dNewX;
+      position.y = dNewY;
+      position.z = dNewZ;
+		UpdateFirePosition();
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Think - Base version only clears the request.  Overrides should call it.
+////////////////////////////////////////////////////////////////////////////////
+
+void CDoofus::Think(void)
+{
+	m_bThinkPending = false;
+	m_u16ThinkWaits = 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// RequestThink - Think now, or have the realm run it when there is time.  Those
+//					   near the dude, recently hurt or kept waiting go first.
+////////////////////////////////////////////////////////////////////////////////
+
+void CDoofus::RequestThink(void)
+{
+	if (g_GameSettings.m_sThinkBudget <= 0)
+	{
+		Think();
+		return;
+	}
+
+	uint32_t ulPriority = uint32_t(m_u16ThinkWaits) * THINK_WAIT_PRIORITY;
+   if (m_dude)
+	{
+      double dX = m_dude->GetX() - position.x;
+      double dZ = m_dude->GetZ() - position.z;
+		ulPriority += uint32_t(THINK_NEAR_PRIORITY * ms_dGuardDistance / (ms_dGuardDistance + dX * dX + dZ * dZ));
+	}
+   if (m_lLastHitTime != 0 && realm()->m_time.GetGameTime() - m_lLastHitTime < THINK_HIT_TIME)
+		ulPriority += THINK_HIT_PRIORITY;
+
+	realm()->RequestThink(GetInstanceID(), ulPriority);
+	if (m_u16ThinkWaits < UINT16_MAX)
+		m_u16ThinkWaits++;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// GetFlowWaypoint - Head for a point a few cells down the flow field toward the
+//						   selected CDude.
+////////////////////////////////////////////////////////////////////////////////
+
+bool CDoofus::GetFlowWaypoint(uint32_t* pulCost)
+{
+	int32_t lX;
+	int32_t lZ;
+
+   if (!m_dude || !realm()->m_flowfields.GetWaypoint(m_dude->GetInstanceID(), int32_t(position.x), int32_t(position.z), &lX, &lZ, pulCost))
+		return false;
+
+	m_sNextX = lX;
+	m_sNextZ = lZ;
+	return true;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 // TryClearDirection - Given an angle, and a variance, checks the given angle
 //							  to see if it is clear.  If it is blocked by walls or fire
@@ -1390,7 +1489,7 @@ bool CDoofus::TryClearShot(double dRot, int16_t sVariance)
 	if (m_panimCur->m_ptransRigid)
 	{
 		int16_t sTries = 0;
-		int16_t sX, sY, sZ;
+		int32_t lX, lY, lZ;
 //		CThing* pthing = nullptr;
 		double dRotAttempt = dRot;
 
@@ -1434,12 +1533,12 @@ bool CDoofus::TryClearShot(double dRot, int16_t sVariance)
                 position.y + dMuzzleY,
                 position.z + dMuzzleZ,
 					 (int16_t) dRotAttempt,
-					 3,
+					 3.0,
 					 rspSqrt(CDoofus::SQDistanceToDude()),
 					 0,
-					 &sX,
-					 &sY,
-					 &sZ)
+					 &lX,
+					 &lY,
+					 &lZ)
 					 == false)
 
 				{
@@ -1870,13 +1969,24 @@ void CDoofus::Logic_Patrol(void)
 
 void CDoofus::Logic_Hunt(void)
 {
-	// Find the destination bouy (one closest to the Dude)
 	m_eDestinationState = State_HuntHold;
+
+	// Follow the flow field toward the Dude if there is one
+	uint32_t ulFlowCost;
+	m_bFlowHunt = SelectDude() == SUCCESS && GetFlowWaypoint(&ulFlowCost);
+	if (m_bFlowHunt)
+	{
+		m_state = State_HuntNext;
+      m_lTimer = realm()->m_time.GetGameTime() + ms_lReseekTime;
+		return;
+	}
+
+	// Find the destination bouy (one closest to the Dude)
 	SelectDudeBouy();
-   m_ucNextBouyID = m_pNavNet->FindNearestBouy(position.x, position.z);
-	if (m_ucNextBouyID > 0)
+   m_u16NextBouyID = m_pNavNet->FindNearestBouy(position.x, position.z);
+	if (m_u16NextBouyID > 0)
 	{
-		m_pNextBouy = m_pNavNet->GetBouy(m_ucNextBouyID);
+		m_pNextBouy = m_pNavNet->GetBouy(m_u16NextBouyID);
       if (m_pNextBouy)
 		{
 			m_sNextX = m_pNextBouy->GetX();
@@ -1920,16 +2030,27 @@ void CDoofus::Logic_HuntHold(void)
 		if (lThisTime > m_lTimer)
 		{
 			m_lTimer = lThisTime + 1000;
-			SelectDudeBouy();
-         m_ucNextBouyID = m_pNavNet->FindNearestBouy(position.x, position.z);
+			uint32_t ulFlowCost = 0;
+			m_bFlowHunt = SelectDude() == SUCCESS && GetFlowWaypoint(&ulFlowCost);
+			if (!m_bFlowHunt)
+			{
+				SelectDudeBouy();
+				m_u16NextBouyID = m_pNavNet->FindNearestBouy(position.x, position.z);
+			}
 			// See if he should move closer.
-			if (m_ucNextBouyID != m_ucDestBouyID)
+			if (m_bFlowHunt ? ulFlowCost > FLOW_HOLD_COST : m_u16NextBouyID != m_u16DestBouyID)
 			{
-				m_pNextBouy = m_pNavNet->GetBouy(m_ucNextBouyID);
-            if (m_pNextBouy)
+				if (!m_bFlowHunt)
+				{
+					m_pNextBouy = m_pNavNet->GetBouy(m_u16NextBouyID);
+					if (m_pNextBouy)
+					{
+						m_sNextX = m_pNextBouy->GetX();
+						m_sNextZ = m_pNextBouy->GetZ();
+					}
+				}
+				if (m_bFlowHunt || m_pNextBouy)
 				{
-					m_sNextX = m_pNextBouy->GetX();
-					m_sNextZ = m_pNextBouy->GetZ();
 					m_lTimer = lThisTime + ms_lReseekTime;
 					m_state = State_HuntNext;
 					m_eCurrentAction = Action_Advance;
@@ -1973,9 +2094,20 @@ void CDoofus::Logic_MoveNext(void)
 	double dSeconds = lElapsedTime / 1000.0;
    double dStartX = position.x;
    double dStartZ = position.z;
+	bool bFlow = m_bFlowHunt && m_state == State_HuntNext;
+	uint32_t ulFlowCost = 0;
 
 	if (!ReevaluateState())
 	{
+		// Flow field hunters get a new waypoint every update since the field
+		// may have been rebuilt.  If the field is gone, go back to the bouys.
+		if (bFlow && (SelectDude() != SUCCESS || !GetFlowWaypoint(&ulFlowCost)))
+		{
+			m_bFlowHunt = false;
+			m_state = State_Hunt;
+			return;
+		}
+
 		// Make sure its using the correct animation
 		if (m_state == State_MarchNext || m_state == State_WalkNext)
 		{
@@ -2026,14 +2158,23 @@ void CDoofus::Logic_MoveNext(void)
 			m_sRotateDir = GetRandom() % 2;
 		}
 
-		// See if we are at the next bouy yet
+		// Steer clear of anyone in the way before running into them.
+		AvoidCrowd(dSeconds);
+
       double dX = position.x - m_sNextX;
       double dZ = position.z - m_sNextZ;
 		double dsq = (dX * dX) + (dZ * dZ);
-		if (dsq < 5*5) // Was 10*10 for a long time, trying smaller to see if it keeps guys from getting stuck
+		// Flow field hunters have arrived once they are close enough to the Dude
+		if (bFlow)
+		{
+			if (ulFlowCost <= FLOW_HOLD_COST)
+				m_state = m_eDestinationState;
+		}
+		// See if we are at the next bouy yet
+		else if (dsq < 5*5) // Was 10*10 for a long time, trying smaller to see if it keeps guys from getting stuck
 		{
-			uint8_t ucNext = m_pNextBouy->NextRouteNode(m_ucDestBouyID);
-			if (ucNext == 0 || ucNext == 255) // you are here or you are lost
+			uint16_t u16Next = m_pNavNet->NextWaypoint(m_pNextBouy->m_u16ID, m_u16DestBouyID);
+			if (u16Next == 0 || u16Next == BOUY_ID_UNREACHABLE) // you are here or you are lost
 			{
 				m_state = m_eDestinationState;
 				switch (m_state)
@@ -2060,7 +2201,7 @@ void CDoofus::Logic_MoveNext(void)
 			{
 				// If the reseek timer has expired, find the Dude bouy 
 				// again since he may have moved
-				if (lThisTime > m_lTimer || ucNext == 255)
+				if (lThisTime > m_lTimer || u16Next == BOUY_ID_UNREACHABLE)
 				{
 					if (m_state == State_HuntNext)
 						m_state = State_Hunt;
@@ -2069,8 +2210,8 @@ void CDoofus::Logic_MoveNext(void)
 				}
 				else
 				{
-					m_ucNextBouyID = ucNext;
-					m_pNextBouy = m_pNavNet->GetBouy(ucNext);
+					m_u16NextBouyID = u16Next;
+					m_pNextBouy = m_pNavNet->GetBouy(u16Next);
 					m_sNextX = m_pNextBouy->GetX();
 					m_sNextZ = m_pNextBouy->GetZ();
 				}
@@ -2970,11 +3111,11 @@ void CDoofus::Logic_Retreat(void)
 	// as the destination bouy, then switch to State_MoveNext
 
 	m_eDestinationState = State_Guard;
-	m_ucDestBouyID = SelectRandomBouy();
-   m_ucNextBouyID = m_pNavNet->FindNearestBouy(position.x, position.z);
-	if (m_ucNextBouyID > 0)
+	m_u16DestBouyID = SelectRandomBouy();
+   m_u16NextBouyID = m_pNavNet->FindNearestBouy(position.x, position.z);
+	if (m_u16NextBouyID > 0)
 	{
-		m_pNextBouy = m_pNavNet->GetBouy(m_ucNextBouyID);
+		m_pNextBouy = m_pNavNet->GetBouy(m_u16NextBouyID);
       if (m_pNextBouy)
 		{
 			m_sNextX = m_pNextBouy->GetX();
@@ -3014,11 +3155,11 @@ void CDoofus::Logic_PanicBegin(void)
 
 	m_eDestinationState = State_PanicContinue;
 	m_bPanic = true;
-	m_ucDestBouyID = SelectRandomBouy();
-   m_ucNextBouyID = m_pNavNet->FindNearestBouy(position.x, position.z);
-	if (m_ucNextBouyID > 0)
+	m_u16DestBouyID = SelectRandomBouy();
+   m_u16NextBouyID = m_pNavNet->FindNearestBouy(position.x, position.z);
+	if (m_u16NextBouyID > 0)
 	{
-		m_pNextBouy = m_pNavNet->GetBouy(m_ucNextBouyID);
+		m_pNextBouy = m_pNavNet->GetBouy(m_u16NextBouyID);
       if (m_pNextBouy)
 		{
 			m_sNextX = m_pNextBouy->GetX();
@@ -3066,15 +3207,15 @@ void CDoofus::Logic_MarchBegin(void)
 	m_eDestinationState = State_March;
 	m_eCurrentAction = Action_March;
 	// Pick an endpoint that we are not already at.
-	if (m_ucDestBouyID == m_ucSpecialBouy0ID)
-		m_ucDestBouyID = m_ucSpecialBouy1ID;
+	if (m_u16DestBouyID == m_u16SpecialBouy0ID)
+		m_u16DestBouyID = m_u16SpecialBouy1ID;
 	else
-		m_ucDestBouyID = m_ucSpecialBouy0ID;
+		m_u16DestBouyID = m_u16SpecialBouy0ID;
 
-   m_ucNextBouyID = m_pNavNet->FindNearestBouy(position.x, position.z);
-	if (m_ucNextBouyID > 0)
+   m_u16NextBouyID = m_pNavNet->FindNearestBouy(position.x, position.z);
+	if (m_u16NextBouyID > 0)
 	{
-		m_pNextBouy = m_pNavNet->GetBouy(m_ucNextBouyID);
+		m_pNextBouy = m_pNavNet->GetBouy(m_u16NextBouyID);
       if (m_pNextBouy)
 		{
 			m_sNextX = m_pNextBouy->GetX();
@@ -3106,11 +3247,11 @@ void CDoofus::Logic_WalkBegin(void)
 	// See if dude is still alive
 	SelectDude();
 	m_eDestinationState = State_WalkContinue;
-	m_ucDestBouyID = SelectRandomBouy();
-   m_ucNextBouyID = m_pNavNet->FindNearestBouy(position.x, position.z);
-	if (m_ucNextBouyID > 0)
+	m_u16DestBouyID = SelectRandomBouy();
+   m_u16NextBouyID = m_pNavNet->FindNearestBouy(position.x, position.z);
+	if (m_u16NextBouyID > 0)
 	{
-		m_pNextBouy = m_pNavNet->GetBouy(m_ucNextBouyID);
+		m_pNextBouy = m_pNavNet->GetBouy(m_u16NextBouyID);
       if (m_pNextBouy)
 		{
 			m_sNextX = m_pNextBouy->GetX();
@@ -3447,6 +3588,7 @@ void CDoofus::OnShotMsg(Shot_Message* pMessage)
 	// If he is already shot, just deduct hit points for
 	// the additional bullets
 	m_stockpile.m_sHitPoints -= pMessage->sDamage;
+   m_lLastHitTime = realm()->m_time.GetGameTime();
 
 	if (m_state != State_Burning	&& 
 	    m_state != State_BlownUp	&&
@@ -3506,6 +3648,7 @@ void CDoofus::OnShotMsg(Shot_Message* pMessage)
 
 void CDoofus::OnExplosionMsg(Explosion_Message* pMessage)
 {
+   m_lLastHitTime = realm()->m_time.GetGameTime();
 	if (
 	    m_state != State_BlownUp	&&
 		 m_state != State_Die		&& 
@@ -3556,6 +3699,7 @@ void CDoofus::OnBurnMsg(Burn_Message* pMessage)
 {
 	CCharacter::OnBurnMsg(pMessage);
 	m_stockpile.m_sHitPoints -= pMessage->sDamage;
+   m_lLastHitTime = realm()->m_time.GetGameTime();
 
 	if (m_state != State_Burning	&& 
 	    m_state != State_BlownUp	&&
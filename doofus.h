@@ -295,10 +295,10 @@ class CDoofus : public CCharacter
 		// Navigation Net control
       managed_ptr<CNavigationNet> m_pNavNet;			// The network I should use
       //uint16_t m_u16NavNetID;					// My network's ID
-		uint8_t m_ucDestBouyID;				// Destination bouy
-		uint8_t m_ucNextBouyID;				// Next bouy to go to
-		uint8_t m_ucSpecialBouy0ID;			// Starting bouy for special cases like marching
-		uint8_t m_ucSpecialBouy1ID;			// Ending bouy for special cases like marching
+		uint16_t m_u16DestBouyID;				// Destination bouy
+		uint16_t m_u16NextBouyID;				// Next bouy to go to
+		uint16_t m_u16SpecialBouy0ID;			// Starting bouy for special cases like marching
+		uint16_t m_u16SpecialBouy1ID;			// Ending bouy for special cases like marching
       managed_ptr<CBouy> m_pNextBouy;					// pointer to next bouy to go to.
       double m_sNextX;						// Position of next Bouy
       double m_sNextZ;						// Position of next Bouy
@@ -342,6 +342,10 @@ class CDoofus : public CCharacter
 
       milliseconds_t				m_lSampleTimeIsPlaying; // Expected time for this sample
 		bool				m_bRecentlyStuck;			// Flag for when you get stuck on a wall.		
+		bool				m_bFlowHunt;				// Hunting along the realm's flow field, not the bouys.
+		bool				m_bThinkPending;			// Waiting for the realm to run Think().
+		uint16_t			m_u16ThinkWaits;			// Updates the pending Think() has been put off.
+      milliseconds_t				m_lLastHitTime;			// Last time he was shot, blown up or burned.
 		bool				m_bCivilian;				// Flag for civilian/hostile
 		bool				m_bRegisteredBirth;		// true, once we've registered our birth with the realm.
 
@@ -454,6 +458,11 @@ class CDoofus : public CCharacter
 		// Derived classes should use their own Update function
 		virtual void Update(void);
 
+		// Make the expensive decisions, like evaluating the logic table.  Runs
+		// from RequestThink() or, when the realm is short on time, from
+		// CRealm::RunThinks() on a later update.
+		virtual void Think(void);
+
 		// Guard the area until a CDude is nearby
 		virtual void Logic_Guard(void);
 
@@ -637,7 +646,7 @@ class CDoofus : public CCharacter
 		int16_t SelectDudeBouy(void);					// Returns 0 if successful, non-zero otherwise
 
 		// Return a valid random bouy or 0 if no bouys exist.
-		uint8_t SelectRandomBouy(void);
+		uint16_t SelectRandomBouy(void);
 
 		// Set a pointer to the CDude you are tracking for other CDude related
 		// functions like FindDirection and SQDistanceToDude
@@ -649,6 +658,19 @@ class CDoofus : public CCharacter
 		// If Alignment timer is up, recalc the direction to the bouy.
 		void AlignToBouy(void);
 
+		// Step aside from any characters we're about to walk into.
+		void AvoidCrowd(
+			double dSeconds);						// In:  Seconds since last update
+
+		// Think() now, or queue it with the realm if the ThinkBudget setting is
+		// on.  Call every update while m_bThinkPending is set.
+		void RequestThink(void);
+
+		// Set m_sNextX/Z to the next waypoint on the flow field toward the
+		// selected CDude.
+		bool GetFlowWaypoint(						// Returns false if there is no field or route
+			uint32_t* pulCost);						// Out: Cost from here to the CDude
+
 		// Find the squared distance to the CDude (to avoid sqrt)
 		double SQDistanceToDude(void);
 
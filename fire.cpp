@@ -493,7 +493,7 @@ void CFire::Update(void)
 
 				// Check attribute map for walls, and if you hit a wall, 
 				// set the timer so you will die off next time around.
-				int16_t sHeight = realm()->GetHeight(int16_t(dNewX), int16_t(dNewZ));
+				int16_t sHeight = realm()->GetHeight(int32_t(dNewX), int32_t(dNewZ));
 				// If it hits a wall taller than itself, then it will rotate in the
 				// predetermined direction until it is free to move.
             if ((int16_t) position.y < sHeight)
@@ -564,7 +564,7 @@ void CFire::Render(void)
       m_sPriority = position.z;
 
 		// Layer should be based on info we get from attribute map.
-      m_sLayer = CRealm::GetLayerViaAttrib(realm()->GetLayer((int16_t) position.x, (int16_t) position.z));
+      m_sLayer = CRealm::GetLayerViaAttrib(realm()->GetLayer((int32_t) position.x, (int32_t) position.z));
 
 		// Copy the color info and the alpha channel to the Alpha Sprite
       m_pImage = &(pAnim->m_imColor);
@@ -726,7 +726,7 @@ void CFireball::Update(void)
 
 						// Check attribute map for walls, and if you hit a wall, 
 						// set the timer so you will die off next time around.
-						int16_t sHeight = realm()->GetHeight(int16_t(dNewX), int16_t(dNewZ));
+						int16_t sHeight = realm()->GetHeight(int32_t(dNewX), int32_t(dNewZ));
 						// If it hits a wall taller than itself, then it will rotate in the
 						// predetermined direction until it is free to move.
                   if ((int16_t) position.y < sHeight ||
@@ -825,7 +825,7 @@ void CFireball::Render(void)
       m_sPriority = position.z;
 
 		// Layer should be based on info we get from attribute map.
-      m_sLayer = CRealm::GetLayerViaAttrib(realm()->GetLayer((int16_t) position.x, (int16_t) position.z));
+      m_sLayer = CRealm::GetLayerViaAttrib(realm()->GetLayer((int32_t) position.x, (int32_t) position.z));
 
 //		m_sAlphaLevel = 200;
 		if (m_lTotalFlameTime == 0)
@@ -298,9 +298,9 @@ void CFirebomb::Update(void)
 				// Make sure we start in a valid position.  If we are staring
 				// inside a wall, just delete this object now.
 #ifdef UNUSED_VARIABLE
-          usAttrib = realm()->GetFloorAttribute((int16_t) position.x, (int16_t) position.z);
+          usAttrib = realm()->GetFloorAttribute((int32_t) position.x, (int32_t) position.z);
 #endif
-            sHeight = realm()->GetHeight((int16_t) position.x, (int16_t) position.z);
+            sHeight = realm()->GetHeight((int32_t) position.x, (int32_t) position.z);
             if (position.y < sHeight)
 				{
                Object::enqueue(SelfDestruct);
@@ -323,7 +323,7 @@ void CFirebomb::Update(void)
             dNewY = position.y;
 				AdjustPosVel(&dNewY, &m_dVertVel, dSeconds);
 				// Check the height to see if it hit the ground
-				sHeight = realm()->GetHeight(int16_t(dNewX), int16_t(dNewZ));
+				sHeight = realm()->GetHeight(int32_t(dNewX), int32_t(dNewZ));
 
 				// If its lower than the last and current height, assume it
 				// hit the ground.
@@ -433,7 +433,7 @@ void CFirebomb::Render(void)
       m_sPriority = position.z;
 
 		// Layer should be based on info we get from attribute map
-      m_sLayer = CRealm::GetLayerViaAttrib(realm()->GetLayer((int16_t) position.x, (int16_t) position.z));
+      m_sLayer = CRealm::GetLayerViaAttrib(realm()->GetLayer((int32_t) position.x, (int32_t) position.z));
 
       m_ptrans		= &m_trans;
 
@@ -691,7 +691,7 @@ void CFirefrag::Update(void)
             dNewY = position.y;
 				AdjustPosVel(&dNewY, &m_dVertVel, dSeconds);
 				// Check the height to see if it hit the ground
-				sHeight = realm()->GetHeight(int16_t(dNewX), int16_t(dNewZ));
+				sHeight = realm()->GetHeight(int32_t(dNewX), int32_t(dNewZ));
 
 				// If its lower than the last and current height, assume it
 				// hit the ground.
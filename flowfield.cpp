@@ -0,0 +1,359 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2016 RWS Inc, All Rights Reserved
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of version 2 of the GNU General Public License as published by
+// the Free Software Foundation
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+//
+// flowfield.cpp
+// Project: Postal
+//
+// This module implements the flow fields the enemy guys can follow toward a
+// CDude instead of the bouy network.  See flowfield.h.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include "flowfield.h"
+
+#include "realm.h"
+#include "Thing3d.h"
+
+#include <algorithm>
+
+////////////////////////////////////////////////////////////////////////////////
+// Macros/types/etc.
+////////////////////////////////////////////////////////////////////////////////
+
+// Neighbor offsets, sides first so ties go to straight steps.
+static const int32_t	ms_alNeighborX[8]		= { 1, 0, -1, 0, 1, -1, -1, 1 };
+static const int32_t	ms_alNeighborZ[8]		= { 0, 1, 0, -1, 1, 1, -1, -1 };
+static const uint32_t	ms_aulNeighborCost[8]	=
+	{
+	FLOWFIELD_STRAIGHT_COST, FLOWFIELD_STRAIGHT_COST, FLOWFIELD_STRAIGHT_COST, FLOWFIELD_STRAIGHT_COST,
+	FLOWFIELD_DIAGONAL_COST, FLOWFIELD_DIAGONAL_COST, FLOWFIELD_DIAGONAL_COST, FLOWFIELD_DIAGONAL_COST
+	};
+
+////////////////////////////////////////////////////////////////////////////////
+// Constructor/Destructor
+////////////////////////////////////////////////////////////////////////////////
+
+CFlowFields::CFlowFields(void)
+	{
+	m_lCellsW	= 0;
+	m_lCellsH	= 0;
+	m_ulUpdate	= 0;
+	m_u16NextBuild	= 0;
+	}
+
+CFlowFields::~CFlowFields(void)
+	{
+	Reset();
+	}
+
+////////////////////////////////////////////////////////////////////////////////
+// Sample the walkable cells of the realm's hood.
+////////////////////////////////////////////////////////////////////////////////
+int16_t CFlowFields::Setup(	// Returns 0 if successfull, non-zero otherwise
+	CRealm* prealm)				// In:  Realm with a loaded hood
+	{
+	Reset();
+
+	m_lCellsW	= (prealm->GetRealmWidth() + (1 << FLOWFIELD_CELL_SHIFT) - 1) >> FLOWFIELD_CELL_SHIFT;
+	m_lCellsH	= (prealm->GetRealmHeight() + (1 << FLOWFIELD_CELL_SHIFT) - 1) >> FLOWFIELD_CELL_SHIFT;
+	if (m_lCellsW <= 0 || m_lCellsH <= 0)
+		{
+		TRACE("CFlowFields::Setup(): Realm has no size!\n");
+		m_lCellsW = m_lCellsH = 0;
+		return FAILURE;
+		}
+
+	size_t	numCells	= size_t(m_lCellsW) * m_lCellsH;
+	m_asHeight.resize(numCells);
+	m_aucWalk.resize(numCells);
+
+	for (int32_t lZ = 0; lZ < m_lCellsH; lZ++)
+		{
+		for (int32_t lX = 0; lX < m_lCellsW; lX++)
+			{
+			bool	bNoWalk;
+			size_t	cell	= size_t(lZ) * m_lCellsW + lX;
+			m_asHeight[cell]	= prealm->GetHeightAndNoWalk(
+				(lX << FLOWFIELD_CELL_SHIFT) + (1 << FLOWFIELD_CELL_SHIFT) / 2,
+				(lZ << FLOWFIELD_CELL_SHIFT) + (1 << FLOWFIELD_CELL_SHIFT) / 2,
+				&bNoWalk);
+			m_aucWalk[cell]	= bNoWalk ? 0 : 1;
+			}
+		}
+
+	return SUCCESS;
+	}
+
+////////////////////////////////////////////////////////////////////////////////
+// Free all fields and the walk grid.
+////////////////////////////////////////////////////////////////////////////////
+void CFlowFields::Reset(void)
+	{
+	m_fields.clear();
+	m_asHeight.clear();
+	m_aucWalk.clear();
+	m_lCellsW	= 0;
+	m_lCellsH	= 0;
+	}
+
+////////////////////////////////////////////////////////////////////////////////
+// Keep a field toward this target.
+////////////////////////////////////////////////////////////////////////////////
+void CFlowFields::SetTarget(
+	uint16_t u16Target,			// In:  Instance ID of target
+	int32_t lX,						// In:  Target's X position
+	int32_t lZ)						// In:  Target's Z position
+	{
+	if (!IsSetup())
+		return;
+
+	lX	= std::max(0, std::min(m_lCellsW - 1, lX >> FLOWFIELD_CELL_SHIFT));
+	lZ	= std::max(0, std::min(m_lCellsH - 1, lZ >> FLOWFIELD_CELL_SHIFT));
+
+	auto	iter	= m_fields.find(u16Target);
+	if (iter == m_fields.end())
+		{
+		Field	field;
+		field.lTargetCell	= -1;
+		field.lBuildCell	= -1;
+		iter	= m_fields.emplace(u16Target, field).first;
+		}
+
+	iter->second.lWantCell	= lZ * m_lCellsW + lX;
+	iter->second.ulUpdate	= m_ulUpdate;
+	}
+
+////////////////////////////////////////////////////////////////////////////////
+// Drop stale fields and advance rebuilds.
+////////////////////////////////////////////////////////////////////////////////
+void CFlowFields::Update(void)
+	{
+	auto	iter	= m_fields.begin();
+	while (iter != m_fields.end())
+		{
+		Field*	pfield	= &iter->second;
+
+		// If the target wasn't set this time, it's gone.
+		if (pfield->ulUpdate != m_ulUpdate)
+			{
+			iter	= m_fields.erase(iter);
+			continue;
+			}
+
+		// Start a rebuild if the target has changed cells since the last one.
+		if (pfield->lBuildCell < 0 && pfield->lWantCell != pfield->lTargetCell)
+			{
+			pfield->lBuildCell	= pfield->lWantCell;
+			pfield->aulBuild.assign(m_aucWalk.size(), FLOWFIELD_NO_ROUTE);
+			pfield->aulBuild[pfield->lBuildCell]	= 0;
+			pfield->aOpen.clear();
+			pfield->aOpen.push_back({ 0, uint32_t(pfield->lBuildCell) });
+			}
+
+		++iter;
+		}
+
+	// Share the budget out round robin, starting after the field served
+	// last, so one busy field can't keep the others from ever finishing.
+	int32_t	lBudget	= FLOWFIELD_CELLS_PER_UPDATE;
+	iter	= m_fields.lower_bound(m_u16NextBuild);
+	for (size_t i = 0; i < m_fields.size() && lBudget > 0; i++, ++iter)
+		{
+		if (iter == m_fields.end())
+			iter	= m_fields.begin();
+
+		if (iter->second.lBuildCell >= 0)
+			{
+			Build(&iter->second, &lBudget);
+			m_u16NextBuild	= uint16_t(iter->first + 1);
+			}
+		}
+
+	m_ulUpdate++;
+	}
+
+////////////////////////////////////////////////////////////////////////////////
+// Get a point a few cells further down the field toward the target.
+////////////////////////////////////////////////////////////////////////////////
+bool CFlowFields::GetWaypoint(	// Returns false if there is no route.
+	uint16_t u16Target,				// In:  Instance ID of target
+	int32_t lX,							// In:  X position to start from
+	int32_t lZ,							// In:  Z position to start from
+	int32_t* plX,						// Out: X position to head for
+	int32_t* plZ,						// Out: Z position to head for
+	uint32_t* pulCost)				// Out: Cost from start to target
+	{
+	auto	iter	= m_fields.find(u16Target);
+	if (iter == m_fields.end() || iter->second.lTargetCell < 0)
+		return false;
+
+	const Field&	field	= iter->second;
+	int32_t	lCellX	= lX >> FLOWFIELD_CELL_SHIFT;
+	int32_t	lCellZ	= lZ >> FLOWFIELD_CELL_SHIFT;
+	if (lX < 0 || lZ < 0 || lCellX >= m_lCellsW || lCellZ >= m_lCellsH)
+		return false;
+
+	int32_t	lCell	= lCellZ * m_lCellsW + lCellX;
+	int16_t	i;
+
+	// Standing right against a wall can put the center of our cell inside it,
+	// so start from the best neighbor instead.
+	if (field.aulCost[lCell] == FLOWFIELD_NO_ROUTE)
+		{
+		int32_t	lBest	= -1;
+		for (i = 0; i < 8; i++)
+			{
+			int32_t	lNX	= lCellX + ms_alNeighborX[i];
+			int32_t	lNZ	= lCellZ + ms_alNeighborZ[i];
+			if (lNX >= 0 && lNX < m_lCellsW && lNZ >= 0 && lNZ < m_lCellsH)
+				{
+				int32_t	lN	= lNZ * m_lCellsW + lNX;
+				if (field.aulCost[lN] != FLOWFIELD_NO_ROUTE &&
+					(lBest < 0 || field.aulCost[lN] < field.aulCost[lBest]))
+					lBest	= lN;
+				}
+			}
+
+		if (lBest < 0)
+			return false;
+
+		lCell	= lBest;
+		}
+
+	*pulCost	= field.aulCost[lCell];
+
+	// Go downhill for a few cells.
+	int16_t	sStep;
+	for (sStep = 0; sStep < FLOWFIELD_LOOKAHEAD && field.aulCost[lCell] > 0; sStep++)
+		{
+		int32_t	lBest	= -1;
+		lCellX	= lCell % m_lCellsW;
+		lCellZ	= lCell / m_lCellsW;
+		for (i = 0; i < 8; i++)
+			{
+			int32_t	lNX	= lCellX + ms_alNeighborX[i];
+			int32_t	lNZ	= lCellZ + ms_alNeighborZ[i];
+			if (lNX >= 0 && lNX < m_lCellsW && lNZ >= 0 && lNZ < m_lCellsH)
+				{
+				int32_t	lN	= lNZ * m_lCellsW + lNX;
+				if (field.aulCost[lN] < field.aulCost[lBest < 0 ? lCell : lBest] &&
+					CanStep(lCell, lN, field.lTargetCell) )
+					lBest	= lN;
+				}
+			}
+
+		if (lBest < 0)
+			break;
+
+		lCell	= lBest;
+		}
+
+	*plX	= ((lCell % m_lCellsW) << FLOWFIELD_CELL_SHIFT) + (1 << FLOWFIELD_CELL_SHIFT) / 2;
+	*plZ	= ((lCell / m_lCellsW) << FLOWFIELD_CELL_SHIFT) + (1 << FLOWFIELD_CELL_SHIFT) / 2;
+
+	return true;
+	}
+
+////////////////////////////////////////////////////////////////////////////////
+// Can something walk from cell lFrom to its neighbor lTo?
+////////////////////////////////////////////////////////////////////////////////
+bool CFlowFields::CanStep(	// Returns true if the step is allowed
+	int32_t lFrom,				// In:  Cell stepping from
+	int32_t lTo,				// In:  Neighboring cell stepping to
+	int32_t lTarget)			// In:  Target cell (always walkable)
+	{
+	if (m_aucWalk[lTo] == 0 && lTo != lTarget)
+		return false;
+
+	// Same limit on stepping up as CThing3d uses.  Stepping down is free.
+	if (m_asHeight[lTo] - m_asHeight[lFrom] > CThing3d::MaxStepUpThreshold)
+		return false;
+
+	// Don't cut corners.
+	int32_t	lFromX	= lFrom % m_lCellsW;
+	int32_t	lToX		= lTo % m_lCellsW;
+	if (lFromX != lToX && lFrom / m_lCellsW != lTo / m_lCellsW)
+		{
+		if (m_aucWalk[lFrom - lFromX + lToX] == 0 || m_aucWalk[lTo - lToX + lFromX] == 0)
+			return false;
+		}
+
+	return true;
+	}
+
+////////////////////////////////////////////////////////////////////////////////
+// Settle up to *plBudget cells of a field's rebuild.
+////////////////////////////////////////////////////////////////////////////////
+void CFlowFields::Build(
+	Field* pfield,				// In:  Field to work on
+	int32_t* plBudget)		// In/Out: Cells left this update
+	{
+	while (!pfield->aOpen.empty() && *plBudget > 0)
+		{
+		std::pop_heap(pfield->aOpen.begin(), pfield->aOpen.end(), OpenCellGreater);
+		OpenCell	open	= pfield->aOpen.back();
+		pfield->aOpen.pop_back();
+		(*plBudget)--;
+
+		// Skip entries that were improved on after they were queued.
+		if (open.ulCost > pfield->aulBuild[open.ulCell])
+			continue;
+
+		// Costs run backwards from the target, so look for neighbors that
+		// could step into this cell.
+		int32_t	lCellX	= open.ulCell % m_lCellsW;
+		int32_t	lCellZ	= open.ulCell / m_lCellsW;
+		for (int16_t i = 0; i < 8; i++)
+			{
+			int32_t	lNX	= lCellX + ms_alNeighborX[i];
+			int32_t	lNZ	= lCellZ + ms_alNeighborZ[i];
+			if (lNX >= 0 && lNX < m_lCellsW && lNZ >= 0 && lNZ < m_lCellsH)
+				{
+				int32_t	lN			= lNZ * m_lCellsW + lNX;
+				uint32_t	ulCost	= open.ulCost + ms_aulNeighborCost[i];
+				if (ulCost < pfield->aulBuild[lN] &&
+					m_aucWalk[lN] != 0 &&
+					CanStep(lN, open.ulCell, pfield->lBuildCell) )
+					{
+					pfield->aulBuild[lN]	= ulCost;
+					pfield->aOpen.push_back({ ulCost, uint32_t(lN) });
+					std::push_heap(pfield->aOpen.begin(), pfield->aOpen.end(), OpenCellGreater);
+					}
+				}
+			}
+		}
+
+	// If the rebuild is done, start using it.
+	if (pfield->aOpen.empty())
+		{
+		pfield->aulCost.swap(pfield->aulBuild);
+		pfield->lTargetCell	= pfield->lBuildCell;
+		pfield->lBuildCell	= -1;
+		}
+	}
+
+////////////////////////////////////////////////////////////////////////////////
+// Heap order for the open list (smallest cost on top, ties by cell).
+////////////////////////////////////////////////////////////////////////////////
+bool CFlowFields::OpenCellGreater(const OpenCell& a, const OpenCell& b)
+	{
+	return a.ulCost > b.ulCost || (a.ulCost == b.ulCost && a.ulCell > b.ulCell);
+	}
+
+////////////////////////////////////////////////////////////////////////////////
+// EOF
+////////////////////////////////////////////////////////////////////////////////
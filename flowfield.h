@@ -0,0 +1,157 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2016 RWS Inc, All Rights Reserved
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of version 2 of the GNU General Public License as published by
+// the Free Software Foundation
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+//
+// flowfield.h
+// Project: Postal
+//
+// Flow fields over the hood's walkable attribute grid.  Each field holds the
+// walking cost from every cell of the hood to one target (a CDude), so any
+// number of enemies hunting that target can look up which way to go from
+// where they stand instead of each finding its own way along the bouys.
+//
+// Fields are rebuilt when their target moves to another cell.  The rebuild
+// is a Dijkstra search spread over as many realm updates as it takes at
+// FLOWFIELD_CELLS_PER_UPDATE cells per update, shared round robin by the
+// fields being rebuilt, and the old field stays in use until the new one is
+// finished.  Each rebuild starts over from the new cell; it is time sliced,
+// not incremental, so it costs a whole search however little the target
+// moved.
+//
+////////////////////////////////////////////////////////////////////////////////
+#ifndef FLOWFIELD_H
+#define FLOWFIELD_H
+
+#include <RSPiX.h>
+
+#include <map>
+#include <vector>
+
+class CRealm;
+
+// Cells are this many bits of realm units on a side (8).
+#define FLOWFIELD_CELL_SHIFT			3
+
+// Walking costs to a side and to a corner neighbor.
+#define FLOWFIELD_STRAIGHT_COST		10
+#define FLOWFIELD_DIAGONAL_COST		14
+
+// Cells the rebuilds may settle, in total, per realm update.
+#define FLOWFIELD_CELLS_PER_UPDATE	8192
+
+// GetWaypoint() looks this many cells down the field.
+#define FLOWFIELD_LOOKAHEAD			6
+
+// Cost of cells with no route to the target.
+#define FLOWFIELD_NO_ROUTE				UINT32_MAX
+
+class CFlowFields
+	{
+	//---------------------------------------------------------------------------
+	// Types, enums, etc.
+	//---------------------------------------------------------------------------
+	protected:
+		typedef struct
+			{
+			uint32_t	ulCost;					// Cost to target when this entry was queued
+			uint32_t	ulCell;					// Cell index
+			} OpenCell;
+
+		typedef struct
+			{
+			std::vector<uint32_t> aulCost;	// Cost to the target from each cell
+			std::vector<uint32_t> aulBuild;	// Costs for the rebuild in progress
+			std::vector<OpenCell> aOpen;		// Open list of the rebuild (a heap)
+			int32_t	lTargetCell;				// Target cell of aulCost (-1 until built)
+			int32_t	lBuildCell;					// Target cell being built (-1 if idle)
+			int32_t	lWantCell;					// Cell the target is in now
+			uint32_t	ulUpdate;					// Last update the target was set in
+			} Field;
+
+	//---------------------------------------------------------------------------
+	// Variables
+	//---------------------------------------------------------------------------
+	protected:
+		std::map<uint16_t, Field> m_fields;	// Fields by target instance ID
+		std::vector<int16_t> m_asHeight;		// Height at each cell's center
+		std::vector<uint8_t> m_aucWalk;		// Non-zero for walkable cells
+		int32_t	m_lCellsW;						// Width in cells
+		int32_t	m_lCellsH;						// Height in cells
+		uint32_t	m_ulUpdate;						// Update counter
+		uint16_t	m_u16NextBuild;				// Target to offer the budget to first
+
+	//---------------------------------------------------------------------------
+	// Constructor(s) / destructor
+	//---------------------------------------------------------------------------
+	public:
+		CFlowFields(void);
+		~CFlowFields(void);
+
+	//---------------------------------------------------------------------------
+	// Functions
+	//---------------------------------------------------------------------------
+	public:
+		// Sample the walkable cells of the realm's hood.
+		int16_t Setup(								// Returns 0 if successfull, non-zero otherwise
+			CRealm* prealm);						// In:  Realm with a loaded hood
+
+		// Free all fields and the walk grid.
+		void Reset(void);
+
+		// true once Setup() has been done.
+		bool IsSetup(void)
+			{ return !m_aucWalk.empty(); }
+
+		// Keep a field toward this target.  Call every update for every target
+		// that should keep its field; Update() drops the others.
+		void SetTarget(
+			uint16_t u16Target,					// In:  Instance ID of target
+			int32_t lX,								// In:  Target's X position
+			int32_t lZ);							// In:  Target's Z position
+
+		// Drop fields whose target wasn't set since the last call and advance
+		// any rebuilds.
+		void Update(void);
+
+		// Get a point a few cells further down the field toward the target.
+		bool GetWaypoint(							// Returns false if there is no route.
+			uint16_t u16Target,					// In:  Instance ID of target
+			int32_t lX,								// In:  X position to start from
+			int32_t lZ,								// In:  Z position to start from
+			int32_t* plX,							// Out: X position to head for
+			int32_t* plZ,							// Out: Z position to head for
+			uint32_t* pulCost);					// Out: Cost from start to target
+
+	protected:
+		// Can something walk from cell lFrom to its neighbor lTo?
+		bool CanStep(								// Returns true if the step is allowed
+			int32_t lFrom,							// In:  Cell stepping from
+			int32_t lTo,							// In:  Neighboring cell stepping to
+			int32_t lTarget);						// In:  Target cell (always walkable)
+
+		// Heap order for the open list (smallest cost on top, ties by cell).
+		static bool OpenCellGreater(const OpenCell& a, const OpenCell& b);
+
+		// Settle up to *plBudget cells of a field's rebuild.
+		void Build(
+			Field* pfield,							// In:  Field to work on
+			int32_t* plBudget);					// In/Out: Cells left this update
+	};
+
+#endif // FLOWFIELD_H
+////////////////////////////////////////////////////////////////////////////////
+// EOF
+////////////////////////////////////////////////////////////////////////////////
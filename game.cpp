@@ -1204,6 +1204,10 @@ extern void TheGame(void)
 			// Set the gamma level to value indicated by settings.
 			SetGammaLevel(g_GameSettings.m_sGammaVal);
 
+			// Pace and present frames as indicated by settings.
+			rspSetFramePacing(g_GameSettings.m_sFrameRate);
+			rspSetPresentPipeline(g_GameSettings.m_sPresentPipeline);
+
 			// If trickier quit specified . . .
 			if (g_GameSettings.m_sTrickySystemQuit != FALSE)
 				{
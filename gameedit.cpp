@@ -5502,8 +5502,7 @@ static void ThingHotCall(	// Returns nothing.
                else if (m_pBouyLink0 && !m_pBouyLink1)
 					{
                   m_pBouyLink1 = ms_pthingSel;
-						m_pBouyLink0->AddLink(m_pBouyLink1);
-						m_pBouyLink1->AddLink(m_pBouyLink0);
+						m_pBouyLink0->realm()->NavNet()->LinkBouys(m_pBouyLink0, m_pBouyLink1);
 						AddNewLine(m_pBouyLink0->GetX(),
 									  m_pBouyLink0->GetZ(),
 									  m_pBouyLink1->GetX(),
@@ -6690,10 +6689,10 @@ static void DelThing(	// Returns nothing.
 			case CBouyID:
 				// If it is a Bouy, unlink the bouy from the network and
 				// update the network.
+            // Unlink() removes it from the net and rebuilds the routing
+            // tables it affected.
             managed_ptr<CBouy>(ms_pthingSel)->Unlink();
             pNavNet = prealm->NavNet();
-            pNavNet->RemoveBouy(managed_ptr<CBouy>(ms_pthingSel)->m_ucID);
-				pNavNet->UpdateRoutingTables();
 				// If you deleted one that the connection line was being
 				// drawn to, then clear the connection line.
             if (ms_pthingSel == m_pBouyLink0 ||
@@ -7108,19 +7107,19 @@ static void AttribBlit(			// Returns nothing.
 	uint8_t*	pu8Dst;
 	int32_t	lPitch;
 
-	int16_t	sGridW, sGridH;
-	pmg->GetGridDimensions(&sGridW, &sGridH);
+	int32_t	lGridW, lGridH;
+	pmg->GetGridDimensions(&lGridW, &lGridH);
 
-	int16_t	sIterX;
+	int32_t	lIterX;
 
 	while (sH--)
 		{
 		lPitch	= pimDst->m_lPitch;
-		sIterX	= sSrcX;
+		lIterX	= sSrcX;
 		pu8Dst	= pu8RowDst;
 		while (lPitch--)
 			{
-			if (pmg->GetVal(sIterX++, sSrcY, 0x0000) & u16Mask)
+			if (pmg->GetVal(lIterX++, sSrcY, 0x0000) & u16Mask)
 				{
 				*pu8Dst	= SHOW_ATTRIBS_DRAW_INDEX;
 				}
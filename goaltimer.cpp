@@ -172,7 +172,7 @@ int16_t CGoalTimer::Save(										// Returns 0 if successfull, non-zero otherwi
 void CGoalTimer::Startup(void)								// Returns 0 if successfull, non-zero otherwise
 {
 	// At this point we can assume the CHood was loaded, so we init our height
-   position.y = realm()->GetHeight((int16_t) position.x, (int16_t) position.z);
+   position.y = realm()->GetHeight((int32_t) position.x, (int32_t) position.z);
 }
 
 
@@ -384,7 +384,7 @@ void CGoalTimer::EditRender(void)
    m_sY2	-= m_pImage->m_sHeight;
 
 	// Layer should be based on info we get from attribute map.
-   m_sLayer = CRealm::GetLayerViaAttrib(realm()->GetLayer((int16_t) position.x, (int16_t) position.z));
+   m_sLayer = CRealm::GetLayerViaAttrib(realm()->GetLayer((int32_t) position.x, (int32_t) position.z));
 
    Object::enqueue(SpriteUpdate); // Update sprite in scene
 }
@@ -362,8 +362,8 @@ void CUnguidedMissile::Update(void)
 				break;
 
 			case CWeapon::State_Fire:
-            sHeight = realm()->GetHeight((int16_t) position.x, (int16_t) position.z);
-            usAttrib = realm()->GetFloorAttribute((int16_t) position.x, (int16_t) position.z);
+            sHeight = realm()->GetHeight((int32_t) position.x, (int32_t) position.z);
+            usAttrib = realm()->GetFloorAttribute((int32_t) position.x, (int32_t) position.z);
 				// If it starts at an invalid position like inside a wall, kill it
             if (position.y < sHeight)
 				{
@@ -387,7 +387,7 @@ void CUnguidedMissile::Update(void)
 				dPrevVertVel = m_dVertVel;
 				AdjustPosVel(&dNewY, &m_dVertVel, dSeconds/*, dAccelerationDueToGravity*/);
 				// Check the height to see if it hit the ground
-				sHeight = realm()->GetHeight(int16_t(dNewX), int16_t(dNewZ));
+				sHeight = realm()->GetHeight(int32_t(dNewX), int32_t(dNewZ));
 
 				// Adjust apparent rotation.
 				m_dAnimRotY	= rspMod360(m_dAnimRotY + m_dAnimRotVelY * dSeconds); 
@@ -507,8 +507,8 @@ void CUnguidedMissile::Update(void)
             dNewX = position.x + COSQ[(int16_t)rotation.y] * (m_dHorizVel * dSeconds);
             dNewZ = position.z - SINQ[(int16_t)rotation.y] * (m_dHorizVel * dSeconds);
 				// Check for obstacles
-				usAttrib = realm()->GetFloorAttribute((int16_t) dNewX, (int16_t) dNewZ);
-				sHeight = realm()->GetHeight(int16_t(dNewX), int16_t(dNewZ));
+				usAttrib = realm()->GetFloorAttribute((int32_t) dNewX, (int32_t) dNewZ);
+				sHeight = realm()->GetHeight(int32_t(dNewX), int32_t(dNewZ));
 
 				// If it hit any obstacles, make it bounce off
             if (usAttrib & REALM_ATTR_NOT_WALKABLE || sHeight > position.y)
@@ -612,7 +612,7 @@ void CUnguidedMissile::Render(void)
       m_sPriority = position.z;
 
 		// Layer should be based on info we get from attribute map.
-      m_sLayer = CRealm::GetLayerViaAttrib(realm()->GetLayer((int16_t) position.x, (int16_t) position.z));
+      m_sLayer = CRealm::GetLayerViaAttrib(realm()->GetLayer((int32_t) position.x, (int32_t) position.z));
 
 		// Adjust transformation based current rotations.
 		m_trans.makeIdentity();
@@ -359,22 +359,22 @@ void CHeatseeker::Update(void)
             dNewZ = position.z - rspSin(rotation.y) * (m_dHorizVel * dSeconds);
 
 				// Check for obstacles
-				sHeight = realm()->GetHeight(int16_t(dNewX), int16_t(dNewZ));
+				sHeight = realm()->GetHeight(int32_t(dNewX), int32_t(dNewZ));
 #ifdef UNUSED_VARIABLES
-            usAttrib = realm()->GetFloorAttribute((int16_t) dNewX, (int16_t) dNewZ);
+            usAttrib = realm()->GetFloorAttribute((int32_t) dNewX, (int32_t) dNewZ);
 #endif
-				int16_t	sRealmH	= realm()->GetRealmHeight();
-				int16_t	sRealmW	= realm()->GetRealmWidth();
+				int32_t	lRealmH	= realm()->GetRealmHeight();
+				int32_t	lRealmW	= realm()->GetRealmWidth();
 
 				// Once a bit off screen, it should start turning back towards
 				// the center of the hood.
-            if (position.z > ms_sOffScreenDist + sRealmH ||
+            if (position.z > ms_sOffScreenDist + lRealmH ||
                 position.z < -ms_sOffScreenDist ||
-                position.x > ms_sOffScreenDist + sRealmW ||
+                position.x > ms_sOffScreenDist + lRealmW ||
                 position.x < -ms_sOffScreenDist)
 				{
-					int16_t sTargetAngle = FindAngleTo(sRealmW / 2, 
-																sRealmH / 2);
+					int16_t sTargetAngle = FindAngleTo(lRealmW / 2, 
+																lRealmH / 2);
                int16_t sAngleCCL = rspMod360(sTargetAngle - rotation.y);
                int16_t sAngleCL  = rspMod360((360 - sTargetAngle) + rotation.y);
 					int16_t sAngleDistance = MIN(sAngleCCL, sAngleCL);
@@ -439,7 +439,7 @@ void CHeatseeker::Update(void)
 																				  m_u32SeekBitsExclude, &pSmashed))
 					// Find the angle to the closest thing
 					{
-                  if (realm()->IsPathClear((int16_t) position.x, (int16_t) position.y, (int16_t) position.z, ms_dLineCheckRate,
+                  if (realm()->IsPathClear((int32_t) position.x, (int32_t) position.y, (int32_t) position.z, ms_dLineCheckRate,
 						                (int16_t) pSmashed->m_sphere.sphere.X, (int16_t) pSmashed->m_sphere.sphere.Z) )
 						{
 							int16_t sTargetAngle = FindAngleTo(pSmashed->m_sphere.sphere.X, pSmashed->m_sphere.sphere.Z);
@@ -636,7 +636,7 @@ void CHeatseeker::Render(void)
       m_sPriority = position.z;
 
 		// Layer should be based on info we get from the attribute map
-      m_sLayer = CRealm::GetLayerViaAttrib(realm()->GetLayer((int16_t) position.x, (int16_t) position.z));
+      m_sLayer = CRealm::GetLayerViaAttrib(realm()->GetLayer((int32_t) position.x, (int32_t) position.z));
 
       m_ptrans		= &m_trans;
 
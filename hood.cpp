@@ -819,6 +819,7 @@ int16_t CHood::Init(void)									// Returns 0 if successfull, non-zero otherwis
 			pSprite2->m_sLayer = CRealm::LayerBg;
          pSprite2->flags.DeleteOnClear = true;
          pSprite2->flags.BlitOpaque = true;
+         pSprite2->flags.Static = true;
 			realm()->Scene()->UpdateSprite(pSprite2);
 
 			// Attempt to load all layers . . .
@@ -842,6 +843,7 @@ int16_t CHood::Init(void)									// Returns 0 if successfull, non-zero otherwis
 						pSprite2->m_sLayer = CRealm::LayerAlpha1 + (int16_t)lIndex * (CRealm::LayerAlpha2 - CRealm::LayerAlpha1);
                   pSprite2->flags.DeleteOnClear = true;
                   pSprite2->flags.Alpha = true;
+                  pSprite2->flags.Static = true;
 						realm()->Scene()->UpdateSprite(pSprite2);
 
 						p = m_apspryAlphas[lIndex]->m_listSprites.GetNext(p);
@@ -864,6 +866,7 @@ int16_t CHood::Init(void)									// Returns 0 if successfull, non-zero otherwis
 						pSprite2->m_sLayer = CRealm::LayerOpaque1 + (int16_t)lIndex * (CRealm::LayerOpaque2 - CRealm::LayerOpaque1);
                   pSprite2->flags.DeleteOnClear = true;
                   pSprite2->flags.Opaque = true;
+                  pSprite2->flags.Static = true;
 						realm()->Scene()->UpdateSprite(pSprite2);
 						
 						p = m_apspryOpaques[lIndex]->m_listSprites.GetNext(p);
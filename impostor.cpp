@@ -0,0 +1,151 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2016 RWS Inc, All Rights Reserved
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of version 2 of the GNU General Public License as published by
+// the Free Software Foundation
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+//
+// impostor.cpp
+// Project: Postal
+//
+// This module implements the cache of pre-rendered 3D sprite trees.  See
+// impostor.h.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include "impostor.h"
+
+////////////////////////////////////////////////////////////////////////////////
+// Constructor / destructor.
+////////////////////////////////////////////////////////////////////////////////
+CImpostorCache::CImpostorCache(void)
+	{
+	m_ulRenders		= 0;
+	m_lBytes			= 0;
+	m_ulHits			= 0;
+	m_ulMisses		= 0;
+	m_ulEvictions	= 0;
+	}
+
+CImpostorCache::~CImpostorCache(void)
+	{
+	Reset();
+	}
+
+////////////////////////////////////////////////////////////////////////////////
+// Drop all entries.
+////////////////////////////////////////////////////////////////////////////////
+void CImpostorCache::Reset(void)
+	{
+	if (m_ulHits + m_ulMisses > 0)
+		{
+		TRACE("CImpostorCache::Reset(): %u hits, %u misses, %u evictions, %u entries in %u bytes.\n",
+			m_ulHits, m_ulMisses, m_ulEvictions, (uint32_t)m_entries.size(), (uint32_t)m_lBytes);
+		}
+
+	m_lruKeys.clear();
+	m_entries.clear();
+	m_lBytes			= 0;
+	m_ulHits			= 0;
+	m_ulMisses		= 0;
+	m_ulEvictions	= 0;
+	}
+
+////////////////////////////////////////////////////////////////////////////////
+// Find an entry and make it the most recently used.
+////////////////////////////////////////////////////////////////////////////////
+CImpostorCache::Entry* CImpostorCache::Find(	// Returns nullptr if there is none
+	const std::string& strKey)						// In:  Key of tree
+	{
+	auto	iEntry	= m_entries.find(strKey);
+	if (iEntry == m_entries.end())
+		{
+		m_ulMisses++;
+		return nullptr;
+		}
+
+	m_ulHits++;
+	Entry*	pentry	= &iEntry->second;
+	m_lruKeys.splice(m_lruKeys.begin(), m_lruKeys, pentry->iLru);
+	pentry->ulLastUsed	= m_ulRenders;
+	return pentry;
+	}
+
+////////////////////////////////////////////////////////////////////////////////
+// Add an entry, taking the job's contents.
+////////////////////////////////////////////////////////////////////////////////
+CImpostorCache::Entry* CImpostorCache::Add(	// Returns the new entry
+	const std::string& strKey,						// In:  Key of tree
+	CScene::Render3DJob* pjob,						// In:  Rendered tree (emptied)
+	std::vector<SpriteInfo>* paSprites)			// In:  Its sprites (emptied)
+	{
+	auto	iEntry	= m_entries.find(strKey);
+	if (iEntry != m_entries.end())
+		Evict(iEntry);
+
+	iEntry	= m_entries.emplace(strKey, Entry()).first;
+	Entry*	pentry	= &iEntry->second;
+	pentry->aSprites.swap(*paSprites);
+	pentry->job.pTree	= nullptr;
+	pentry->job.aPieces.swap(pjob->aPieces);
+	pentry->job.au8Pixels.swap(pjob->au8Pixels);
+	pentry->job.au8Written.swap(pjob->au8Written);
+	pentry->lBytes		= strKey.size()
+		+ pentry->aSprites.size() * sizeof(SpriteInfo)
+		+ pentry->job.aPieces.size() * sizeof(CScene::Render3DPiece)
+		+ pentry->job.au8Pixels.size()
+		+ pentry->job.au8Written.size();
+	pentry->ulLastUsed	= m_ulRenders;
+	m_lruKeys.push_front(&iEntry->first);
+	pentry->iLru	= m_lruKeys.begin();
+	m_lBytes	+= pentry->lBytes;
+
+	return pentry;
+	}
+
+////////////////////////////////////////////////////////////////////////////////
+// Count a render and drop entries over the budget or too old.  The least
+// recently used are at the back, so both only ever look there.
+////////////////////////////////////////////////////////////////////////////////
+void CImpostorCache::Trim(
+	size_t lMaxBytes,					// In:  Memory budget
+	uint32_t ulMaxAge)				// In:  Renders an entry may go unused (0 for no limit)
+	{
+	m_ulRenders++;
+
+	while (m_lruKeys.empty() == false)
+		{
+		auto	iEntry	= m_entries.find(*m_lruKeys.back());
+		ASSERT(iEntry != m_entries.end());
+		if (m_lBytes <= lMaxBytes && (ulMaxAge == 0 || m_ulRenders - iEntry->second.ulLastUsed <= ulMaxAge))
+			break;
+
+		Evict(iEntry);
+		}
+	}
+
+////////////////////////////////////////////////////////////////////////////////
+// Drop an entry.
+////////////////////////////////////////////////////////////////////////////////
+void CImpostorCache::Evict(
+	std::unordered_map<std::string, Entry>::iterator iEntry)
+	{
+	m_lBytes	-= iEntry->second.lBytes;
+	m_lruKeys.erase(iEntry->second.iLru);
+	m_entries.erase(iEntry);
+	m_ulEvictions++;
+	}
+
+////////////////////////////////////////////////////////////////////////////////
+// EOF
+////////////////////////////////////////////////////////////////////////////////
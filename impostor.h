@@ -0,0 +1,126 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2016 RWS Inc, All Rights Reserved
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of version 2 of the GNU General Public License as published by
+// the Free Software Foundation
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+//
+// impostor.h
+// Project: Postal
+//
+// A cache of pre-rendered trees of 3D sprites (impostors).  The view never
+// changes and characters turn in whole degrees through a limited set of
+// animation frames, so the same pose is drawn over and over.  CScene keys
+// each tree by everything its rasterization depends on (frame, transform,
+// textures, brightness, lighting) and, when the key has been seen before,
+// draws the stored pixels instead of transforming and rasterizing again.
+//
+// Entries are dropped least recently used first to stay under a memory
+// budget, and optionally when they haven't been used for a number of
+// renders.
+//
+////////////////////////////////////////////////////////////////////////////////
+#ifndef IMPOSTOR_H
+#define IMPOSTOR_H
+
+#include "scene.h"
+
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class CImpostorCache
+	{
+	//---------------------------------------------------------------------------
+	// Types, enums, etc.
+	//---------------------------------------------------------------------------
+	public:
+		// What Render3D() leaves in each sprite of the tree, whether or not it
+		// draws it.
+		typedef struct
+			{
+			int16_t	sCenOffX;					// CSprite3::m_sCenX less m_sX2
+			int16_t	sCenOffY;					// CSprite3::m_sCenY less m_sY2
+			int16_t	sRadius;						// CSprite3::m_sRadius
+			int32_t	lPiece;						// Its piece in the job (-1 if none)
+			} SpriteInfo;
+
+		// A rendered tree.  Pieces are positioned relative to the tree's hotspot.
+		typedef struct
+			{
+			std::vector<SpriteInfo> aSprites;	// Sprites, in the order Render() visits them
+			CScene::Render3DJob job;			// Pieces and pixels
+			size_t	lBytes;						// Memory used
+			uint32_t	ulLastUsed;					// Render count when last drawn
+			std::list<const std::string*>::iterator iLru;	// Place in m_lruKeys
+			} Entry;
+
+	//---------------------------------------------------------------------------
+	// Variables
+	//---------------------------------------------------------------------------
+	protected:
+		std::unordered_map<std::string, Entry> m_entries;	// Entries by key
+		std::list<const std::string*> m_lruKeys;				// Keys, most recently used first
+		uint32_t	m_ulRenders;					// Render count
+
+	public:
+		size_t	m_lBytes;						// Memory used by all entries
+		uint32_t	m_ulHits;						// Lookups found
+		uint32_t	m_ulMisses;						// Lookups not found
+		uint32_t	m_ulEvictions;					// Entries dropped to make room or for age
+
+	//---------------------------------------------------------------------------
+	// Constructor(s) / destructor
+	//---------------------------------------------------------------------------
+	public:
+		CImpostorCache(void);
+		~CImpostorCache(void);
+
+	//---------------------------------------------------------------------------
+	// Functions
+	//---------------------------------------------------------------------------
+	public:
+		// Drop all entries (when what keys point at may be freed).
+		void Reset(void);
+
+		// Number of entries.
+		size_t GetNumEntries(void)
+			{ return m_entries.size(); }
+
+		// Find an entry.
+		Entry* Find(								// Returns nullptr if there is none
+			const std::string& strKey);		// In:  Key of tree
+
+		// Add an entry, taking the job's contents.
+		Entry* Add(									// Returns the new entry
+			const std::string& strKey,			// In:  Key of tree
+			CScene::Render3DJob* pjob,			// In:  Rendered tree (emptied)
+			std::vector<SpriteInfo>* paSprites);	// In:  Its sprites (emptied)
+
+		// Count a render and drop entries over the budget or too old.
+		void Trim(
+			size_t lMaxBytes,						// In:  Memory budget
+			uint32_t ulMaxAge);					// In:  Renders an entry may go unused
+														// (0 for no limit)
+
+	protected:
+		// Drop an entry.
+		void Evict(
+			std::unordered_map<std::string, Entry>::iterator iEntry);
+	};
+
+#endif // IMPOSTOR_H
+////////////////////////////////////////////////////////////////////////////////
+// EOF
+////////////////////////////////////////////////////////////////////////////////
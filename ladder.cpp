@@ -374,7 +374,7 @@ void CLadder::EditRender(void)
 	m_sprite.m_sPriority = m_dZ + m_sprite.m_pImage->m_sHeight / 2;
 		
 	// Layer should be based on info we get from attribute map.
-	m_sprite.m_sLayer = CRealm::GetLayerViaAttrib(m_pRealm->GetLayer((int16_t) m_dX, (int16_t) m_dZ));
+	m_sprite.m_sLayer = CRealm::GetLayerViaAttrib(m_pRealm->GetLayer((int32_t) m_dX, (int32_t) m_dZ));
 
 	// Update sprite in scene
 	m_pRealm->m_scene.UpdateSprite(&m_sprite);
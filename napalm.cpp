@@ -292,7 +292,7 @@ void CNapalm::Update(void)
 			case CWeapon::State_Fire:
 				// Make sure it starts in a valid location.  If it is inside
 				// a wall, delete it now.
-            sHeight = realm()->GetHeight((int16_t) position.x, (int16_t) position.z);
+            sHeight = realm()->GetHeight((int32_t) position.x, (int32_t) position.z);
             if (position.y < sHeight)
 				{
                Object::enqueue(SelfDestruct);
@@ -320,7 +320,7 @@ void CNapalm::Update(void)
 				AdjustPosVel(&dNewY, &m_dVertVel, dSeconds);
 
 				// Check the height to see if it hit the ground
-				sHeight = realm()->GetHeight(int16_t(dNewX), int16_t(dNewZ));
+				sHeight = realm()->GetHeight(int32_t(dNewX), int32_t(dNewZ));
 
 				// If its lower than the last and current height, assume it
 				// hit the ground.
@@ -408,7 +408,7 @@ void CNapalm::Update(void)
             dNewX = position.x + COSQ[(int16_t)rotation.y] * (m_dHorizVel * dSeconds);
             dNewZ = position.z - SINQ[(int16_t)rotation.y] * (m_dHorizVel * dSeconds);
 				// Check for obstacles
-				sHeight = realm()->GetHeight(int16_t(dNewX), int16_t(dNewZ));
+				sHeight = realm()->GetHeight(int32_t(dNewX), int32_t(dNewZ));
 				// If it hit any obstacles, make it bounce off
             if (sHeight > position.y)
 				{
@@ -485,7 +485,7 @@ void CNapalm::Render(void)
       m_sPriority = position.z;
 
 		// Layer should be based on info we get from attribute map
-      m_sLayer = CRealm::GetLayerViaAttrib(realm()->GetLayer((int16_t) position.x, (int16_t) position.z));
+      m_sLayer = CRealm::GetLayerViaAttrib(realm()->GetLayer((int32_t) position.x, (int32_t) position.z));
 
       m_ptrans		= &m_trans;
 
@@ -143,6 +143,16 @@
 #include "realm.h"
 #include "bouy.h"
 #include "gameedit.h"
+#include "Thing3d.h"
+#include "game.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
+#include <functional>
+#include <queue>
+#include <thread>
 
 ////////////////////////////////////////////////////////////////////////////////
 // Macros/types/etc.
@@ -167,26 +177,31 @@ int16_t CNavigationNet::ms_sFileCount;
 CNavigationNet::CNavigationNet(void)
 {
   m_sSuspend = 0;
-  m_ucNextID = 1;
+  m_u16NextID = 1;
+  m_u16NumSavedBouys = 0;
   // Set yourself to be the new current Nav Net in the realm
   //pRealm->m_pCurrentNavNet = this; // TODO: REPLACE
   // Set default name as NavNetxx where xx is CThing ID
   m_rstrNetName = "Untitled NavNet";
-  // Initialize the dummy nodes for the sorted tree/list
-  m_BouyTreeListHead.m_powner = nullptr;
-  m_BouyTreeListHead.m_pnPrev = nullptr;
-  m_BouyTreeListHead.m_pnRight = nullptr;
-  m_BouyTreeListHead.m_pnLeft = nullptr;
-  m_BouyTreeListHead.m_pnNext = &m_BouyTreeListTail;
-  m_BouyTreeListTail.m_powner = nullptr;
-  m_BouyTreeListTail.m_pnPrev = &m_BouyTreeListHead;
-  m_BouyTreeListTail.m_pnNext = nullptr;
-  m_BouyTreeListTail.m_pnRight = nullptr;
-  m_BouyTreeListTail.m_pnLeft = nullptr;
+  // The grid is built by the first FindNearestBouy()
+  m_lGridX0 = m_lGridZ0 = 0;
+  m_lGridW = m_lGridH = 0;
+  m_bGridDirty = true;
+  m_bGridBaked = false;
+  m_ulRouteQueries = 0;
+  m_ulRouteHits = 0;
 }
 
 CNavigationNet::~CNavigationNet(void)
 {
+  // Report how well the route cache did (in release builds too).
+  if (m_ulRouteQueries > 0)
+  {
+    rspTrace("CNavigationNet::~CNavigationNet(): %s: routes: %u queries, %u hits (%u%%).\n",
+      (const char*)m_rstrNetName, m_ulRouteQueries, m_ulRouteHits,
+      uint32_t(uint64_t(m_ulRouteHits) * 100 / m_ulRouteQueries));
+  }
+
   // Free resources
   FreeResources();
 }
@@ -228,7 +243,7 @@ int16_t CNavigationNet::Load(							// Returns 0 if successfull, non-zero otherw
             pFile->Read(&position.z);
 
 				// Load the number of bouys that were saved
-				pFile->Read(&m_ucNumSavedBouys);
+				CBouy::ReadID(pFile, ulFileVersion, &m_u16NumSavedBouys);
 
 				m_rstrNetName.Load(pFile);
 				
@@ -282,8 +297,8 @@ int16_t CNavigationNet::Save(										// Returns 0 if successfull, non-zero oth
 	// Save the number of nodes so we can check after load to see if all
 	// of the Bouys have been loaded yet.
 //	pFile->Write(&m_ucNextID);
-	uint8_t ucNumNodes = m_NodeMap.size();
-	pFile->Write(&ucNumNodes);
+	uint16_t u16NumNodes = m_NodeMap.size();
+	pFile->Write(&u16NumNodes);
 
 	m_rstrNetName.Save(pFile);
 
@@ -297,13 +312,17 @@ int16_t CNavigationNet::Save(										// Returns 0 if successfull, non-zero oth
 void CNavigationNet::Startup(void)								// Returns 0 if successfull, non-zero otherwise
    {
 	// At this point we can assume the CHood was loaded, so we init our height
-   position.y = realm()->GetHeight((int16_t) position.x, (int16_t) position.z);
+   position.y = realm()->GetHeight((int32_t) position.x, (int32_t) position.z);
 	// Set yourself to be the new current Nav Net
    realm()->setNavNet(this);
 
 	// Init other stuff
-   if (m_ucNextID > m_ucNumSavedBouys)
+   if (m_u16NextID > m_u16NumSavedBouys)
       UpdateRoutingTables();
+
+	// Bake bouy visibility for play (the editor moves bouys around too much).
+	if (g_GameSettings.m_sNavNetVisibility != FALSE && realm()->m_flags.bEditing == false)
+		BakeVisibility();
 	}
 
 
@@ -518,7 +537,7 @@ void CNavigationNet::EditRender(void)
   m_sY2	-= m_pImage->m_sHeight;
 
   // Layer should be based on info we get from attribute map.
-  m_sLayer = CRealm::GetLayerViaAttrib(realm()->GetLayer((int16_t) position.x, (int16_t) position.z));
+  m_sLayer = CRealm::GetLayerViaAttrib(realm()->GetLayer((int32_t) position.x, (int32_t) position.z));
 
   // Image would normally animate, but doesn't for now
   m_pImage = m_pImage;
@@ -607,41 +626,44 @@ int16_t CNavigationNet::FreeResources(void)						// Returns 0 if successfull, no
 // AddBouy - Returns zero if there are no bouys left.
 ////////////////////////////////////////////////////////////////////////////////
 
-uint8_t CNavigationNet::AddBouy(CBouy* pBouy)
+uint16_t CNavigationNet::AddBouy(CBouy* pBouy)
 {
-	uint8_t ucID = 0;
+	uint16_t u16ID = 0;
 
-	if (m_ucNextID < 254)
+	if (m_u16NextID < BOUY_MAX_ID)
 	{
-		pBouy->m_ucID = m_ucNextID;
+		pBouy->m_u16ID = m_u16NextID;
       pBouy->m_pParentNavNet = this;
-      m_NodeMap.emplace(m_ucNextID, pBouy);
-		m_ucNextID++;
-		ucID = pBouy->m_ucID;
+      m_NodeMap.emplace(m_u16NextID, pBouy);
+		m_u16NextID++;
+		u16ID = pBouy->m_u16ID;
+		m_bGridDirty = true;
+		InvalidateRoutes();
 	}
 
-	return ucID;
+	return u16ID;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 // RemoveBouy
 ////////////////////////////////////////////////////////////////////////////////
 
-void CNavigationNet::RemoveBouy(uint8_t ucBouyID)
+void CNavigationNet::RemoveBouy(uint16_t u16BouyID)
 {
-	m_NodeMap.erase(ucBouyID);
-	UpdateRoutingTables();
+	m_NodeMap.erase(u16BouyID);
+	m_bGridDirty = true;
+	InvalidateRoutes();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 // GetBouy
 ////////////////////////////////////////////////////////////////////////////////
 
-managed_ptr<CBouy> CNavigationNet::GetBouy(uint8_t ucBouyID)
+managed_ptr<CBouy> CNavigationNet::GetBouy(uint16_t u16BouyID)
 {
    managed_ptr<CBouy> pBouy;
 
-   auto iter = m_NodeMap.find(ucBouyID);
+   auto iter = m_NodeMap.find(u16BouyID);
    if (iter != m_NodeMap.end())
       pBouy = iter->second;
 
@@ -649,75 +671,212 @@ managed_ptr<CBouy> CNavigationNet::GetBouy(uint8_t ucBouyID)
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-// FindNearestBouy - Go through the list and get the ID of the nearest
-//							bouy to the given x, z position
+// GridCoord - Cell coordinate of a world coordinate
+////////////////////////////////////////////////////////////////////////////////
+
+inline int32_t GridCoord(double d)
+{
+	return int32_t(std::floor(d)) >> NAVNET_GRID_CELL_SHIFT;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// BuildGrid - Sort the bouys into the cells of the spatial grid
+////////////////////////////////////////////////////////////////////////////////
+
+void CNavigationNet::BuildGrid(void)
+{
+	m_aGridCells.clear();
+	m_aGridVisible.clear();
+	m_lGridW = m_lGridH = 0;
+	m_bGridDirty = false;
+
+	if (m_NodeMap.empty())
+		return;
+
+	int32_t lMinX = INT32_MAX;
+	int32_t lMinZ = INT32_MAX;
+	int32_t lMaxX = INT32_MIN;
+	int32_t lMaxZ = INT32_MIN;
+	for (auto iter = m_NodeMap.begin(); iter != m_NodeMap.end(); ++iter)
+	{
+		int32_t lCellX = GridCoord(iter->second->position.x);
+		int32_t lCellZ = GridCoord(iter->second->position.z);
+		lMinX = std::min(lMinX, lCellX);
+		lMinZ = std::min(lMinZ, lCellZ);
+		lMaxX = std::max(lMaxX, lCellX);
+		lMaxZ = std::max(lMaxZ, lCellZ);
+	}
+
+	m_lGridX0 = lMinX - NAVNET_VIS_RADIUS;
+	m_lGridZ0 = lMinZ - NAVNET_VIS_RADIUS;
+	m_lGridW = lMaxX - lMinX + 1 + 2 * NAVNET_VIS_RADIUS;
+	m_lGridH = lMaxZ - lMinZ + 1 + 2 * NAVNET_VIS_RADIUS;
+	m_aGridCells.resize(size_t(m_lGridW) * m_lGridH);
+
+	// The map is in ID order, so each cell's list is too.
+	for (auto iter = m_NodeMap.begin(); iter != m_NodeMap.end(); ++iter)
+	{
+		int32_t lCellX = GridCoord(iter->second->position.x) - m_lGridX0;
+		int32_t lCellZ = GridCoord(iter->second->position.z) - m_lGridZ0;
+		m_aGridCells[size_t(lCellZ) * m_lGridW + lCellX].push_back(iter->first);
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// BakeVisibility - For each grid cell, find the nearby bouys that have a clear
+//						  path from the cell's corners and center.  This is an
+//						  approximation: a small obstacle can sit between the sample
+//						  points, so it is only used when enabled in the settings.
+////////////////////////////////////////////////////////////////////////////////
+
+void CNavigationNet::BakeVisibility(void)
+{
+	if (m_bGridDirty)
+		BuildGrid();
+
+	m_bGridBaked = true;
+	m_aGridVisible.assign(m_aGridCells.size(), std::vector<uint16_t>());
+
+	const int32_t lCellSize = 1 << NAVNET_GRID_CELL_SHIFT;
+	uint32_t ulVisible = 0;
+	for (int32_t lCellZ = 0; lCellZ < m_lGridH; lCellZ++)
+	{
+		for (int32_t lCellX = 0; lCellX < m_lGridW; lCellX++)
+		{
+			int32_t lX0 = (m_lGridX0 + lCellX) << NAVNET_GRID_CELL_SHIFT;
+			int32_t lZ0 = (m_lGridZ0 + lCellZ) << NAVNET_GRID_CELL_SHIFT;
+			const int32_t alSampleX[] = { lX0, lX0 + lCellSize - 1, lX0, lX0 + lCellSize - 1, lX0 + lCellSize / 2 };
+			const int32_t alSampleZ[] = { lZ0, lZ0, lZ0 + lCellSize - 1, lZ0 + lCellSize - 1, lZ0 + lCellSize / 2 };
+			std::vector<uint16_t>& visible = m_aGridVisible[size_t(lCellZ) * m_lGridW + lCellX];
+
+			for (int32_t lNearZ = std::max(0, lCellZ - NAVNET_VIS_RADIUS); lNearZ <= std::min(m_lGridH - 1, lCellZ + NAVNET_VIS_RADIUS); lNearZ++)
+			{
+				for (int32_t lNearX = std::max(0, lCellX - NAVNET_VIS_RADIUS); lNearX <= std::min(m_lGridW - 1, lCellX + NAVNET_VIS_RADIUS); lNearX++)
+				{
+					for (uint16_t u16ID : m_aGridCells[size_t(lNearZ) * m_lGridW + lNearX])
+					{
+						managed_ptr<CBouy> pBouy = GetBouy(u16ID);
+						bool bClear = true;
+						for (size_t i = 0; i < sizeof(alSampleX) / sizeof(alSampleX[0]) && bClear; i++)
+						{
+							int32_t lY = realm()->GetHeight(alSampleX[i], alSampleZ[i]);
+							bClear = realm()->IsPathClear(alSampleX[i], lY, alSampleZ[i], 4.0, (int32_t) pBouy->GetX(), (int32_t) pBouy->GetZ());
+						}
+
+						if (bClear)
+							visible.push_back(u16ID);
+					}
+				}
+			}
+
+			std::sort(visible.begin(), visible.end());
+			ulVisible += visible.size();
+		}
+	}
+
+	TRACE("CNavigationNet::BakeVisibility(): %d x %d cells, %u visible bouy entries.\n",
+		m_lGridW, m_lGridH, ulVisible);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// FindNearestBouy - Get the ID of the nearest bouy to the given x, z position
 //
 //							This has been modified to return the closest available
 //							bouy - one that is not blocked by terrain.
+//
+//							Bouys are gathered from the spatial grid one ring of
+//							cells at a time.  A bouy is only tested once every bouy
+//							still ungathered is farther away, so they are tested in
+//							the same order (nearest first, ties by ID) as a full
+//							sort would give.
 ////////////////////////////////////////////////////////////////////////////////
 
-uint8_t CNavigationNet::FindNearestBouy(int16_t sX, int16_t sZ)
+uint16_t CNavigationNet::FindNearestBouy(int32_t lX, int32_t lZ)
 {
-	double dSqDist;
-	double dX;
-	double dZ;
-   managed_ptr<CBouy> pBouy;
-	TreeListNode* pRoot = nullptr;
-	TreeListNode* pCurrent = nullptr;
-	uint8_t	ucNode = 0;
+	// Rebuilding drops the baked visibility, so bake it again if it was.
+	if (m_bGridDirty)
+	{
+		if (m_bGridBaked)
+			BakeVisibility();
+		else
+			BuildGrid();
+	}
 
-	// Build the sorted list of bouys
-   for (auto iter = m_NodeMap.begin(); iter != m_NodeMap.end(); ++iter)
+	if (m_aGridCells.empty())
+		return 0;
+
+	// Squared distance and ID, smallest first.
+	typedef std::pair<double, uint16_t> Candidate;
+	std::priority_queue<Candidate, std::vector<Candidate>, std::greater<Candidate>> candidates;
+
+	int32_t lCellX = GridCoord(lX) - m_lGridX0;
+	int32_t lCellZ = GridCoord(lZ) - m_lGridZ0;
+
+	// Bouys known to be visible from this cell, if visibility was baked.
+	const std::vector<uint16_t>* pVisible = nullptr;
+	if (!m_aGridVisible.empty() &&
+		 lCellX >= 0 && lCellX < m_lGridW && lCellZ >= 0 && lCellZ < m_lGridH)
+		pVisible = &m_aGridVisible[size_t(lCellZ) * m_lGridW + lCellX];
+
+	// Number of rings it takes to cover the whole grid from here.
+	int32_t lMaxRing = std::max(
+		std::max(std::abs(lCellX), std::abs(m_lGridW - 1 - lCellX)),
+		std::max(std::abs(lCellZ), std::abs(m_lGridH - 1 - lCellZ)));
+
+	auto AddCell = [&](int32_t lCol, int32_t lRow)
 	{
-      pBouy = iter->second;
-      dX = pBouy->position.x - sX;
-      dZ = pBouy->position.z - sZ;
-		dSqDist = (dX * dX) + (dZ * dZ);
-		pBouy->m_TreeNode.m_sortkey = dSqDist;
-      pBouy->m_TreeNode.m_powner = pBouy.pointer();
-		if (pRoot == nullptr)
+		for (uint16_t u16ID : m_aGridCells[size_t(lRow) * m_lGridW + lCol])
 		{
-			pRoot = &pBouy->m_TreeNode;
-			//m_BouyTreeListHead.AddAfter(&pBouy->m_TreeNode);
-			pBouy->m_TreeNode.AddAfter(&m_BouyTreeListHead);
+			managed_ptr<CBouy> pBouy = GetBouy(u16ID);
+			double dX = pBouy->position.x - lX;
+			double dZ = pBouy->position.z - lZ;
+			candidates.push(Candidate((dX * dX) + (dZ * dZ), u16ID));
 		}
-		else
-			pRoot->Add(&pBouy->m_TreeNode);
-	}
+	};
 
-	pCurrent = m_BouyTreeListHead.m_pnNext;
-	bool bSearching = true;
 	// Get the height at the startling location for path checking
-   int16_t sY = realm()->GetHeight(sX, sZ);
+   int16_t sY = realm()->GetHeight(lX, lZ);
 
-	// Go through the sorted list of bouys and check to see if you could
-	// get to it from where you are standing.  If not, check the next one.
-	while (pCurrent && bSearching)
+	for (int32_t lRing = 0; lRing <= lMaxRing; lRing++)
 	{
-		pBouy = pCurrent->m_powner;
-//		ASSERT(pBouy != nullptr);
-		if (pBouy)
+		// Gather the ring of cells lRing away, clipped to the grid.
+		for (int32_t lRow = std::max(0, lCellZ - lRing); lRow <= std::min(m_lGridH - 1, lCellZ + lRing); lRow++)
 		{
-         if (realm()->IsPathClear(sX, sY, sZ, 4.0, (int16_t) pBouy->GetX(), (int16_t) pBouy->GetZ()))
+			if (lRow == lCellZ - lRing || lRow == lCellZ + lRing)
 			{
-				ucNode = pBouy->m_ucID;
-				bSearching = false;
+				for (int32_t lCol = std::max(0, lCellX - lRing); lCol <= std::min(m_lGridW - 1, lCellX + lRing); lCol++)
+					AddCell(lCol, lRow);
 			}
 			else
-				pCurrent = pCurrent->m_pnNext;
+			{
+				if (lCellX - lRing >= 0 && lCellX - lRing < m_lGridW)
+					AddCell(lCellX - lRing, lRow);
+				if (lCellX + lRing >= 0 && lCellX + lRing < m_lGridW)
+					AddCell(lCellX + lRing, lRow);
+			}
 		}
-		else
-			pCurrent = pCurrent->m_pnNext;
-	}
 
-	// If we built a tree . . .
-	if (pRoot)
-	{
-		// Get rid of the tree, its useless now
-		pRoot->DeleteTree();
+		// Anything in a later ring is more than lRing cells away.
+		double dBound = double(lRing << NAVNET_GRID_CELL_SHIFT);
+		dBound = (lRing == lMaxRing) ? HUGE_VAL : dBound * dBound;
+
+		// Go through the candidates in order and check to see if you could
+		// get to it from where you are standing.  If not, check the next one.
+		while (!candidates.empty() && candidates.top().first <= dBound)
+		{
+			uint16_t u16ID = candidates.top().second;
+			candidates.pop();
+
+			if (pVisible != nullptr && std::binary_search(pVisible->begin(), pVisible->end(), u16ID))
+				return u16ID;
+
+			managed_ptr<CBouy> pBouy = GetBouy(u16ID);
+         if (realm()->IsPathClear(lX, sY, lZ, 4.0, (int32_t) pBouy->GetX(), (int32_t) pBouy->GetZ()))
+				return u16ID;
+		}
 	}
 
-	return ucNode;
+	return 0;
 }
 
 #if 0
@@ -748,6 +907,124 @@ uint8_t CNavigationNet::FindNearestBouy(short sX, short sZ)
 }
 #endif
 
+////////////////////////////////////////////////////////////////////////////////
+// GetLinkTable - Copy the links between the bouys into one flat table
+////////////////////////////////////////////////////////////////////////////////
+
+void CNavigationNet::GetLinkTable(BouyLinkTable* plinks)
+{
+	uint32_t ulNumNodes = GetNumNodes();
+	plinks->aulFirst.assign(ulNumNodes + 1, 0);
+	plinks->au16Links.clear();
+
+	uint32_t ulID = 0;
+   for (auto iter = m_NodeMap.begin(); iter != m_NodeMap.end(); ++iter)
+	{
+		while (ulID <= iter->first)
+			plinks->aulFirst[ulID++] = plinks->au16Links.size();
+
+      for(const managed_ptr<CBouy>& pLinkedBouy : iter->second->m_aplDirectLinks)
+			plinks->au16Links.push_back(pLinkedBouy->m_u16ID);
+
+		// The link sets are ordered by address, so sort each bouy's links by
+		// ID to make the routes the same every time the realm is loaded.
+		std::sort(plinks->au16Links.begin() + plinks->aulFirst[iter->first], plinks->au16Links.end());
+	}
+
+	while (ulID <= ulNumNodes)
+		plinks->aulFirst[ulID++] = plinks->au16Links.size();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// GetHopCounts - Breadth-First search out from one bouy
+////////////////////////////////////////////////////////////////////////////////
+
+void CNavigationNet::GetHopCounts(
+	const BouyLinkTable& links,							// In:  Links to follow
+	uint16_t u16Src,											// In:  Bouy to count from
+	std::vector<uint16_t>* pau16Hops)					// Out: Hops to each bouy ID
+{
+	size_t numNodes = links.aulFirst.size() - 1;
+	pau16Hops->assign(numNodes, BOUY_ID_UNREACHABLE);
+	if (u16Src >= numNodes)
+		return;
+
+	std::vector<uint16_t> bfsQueue;
+	bfsQueue.reserve(numNodes);
+	(*pau16Hops)[u16Src] = 0;
+	bfsQueue.push_back(u16Src);
+
+	for (size_t i = 0; i < bfsQueue.size(); i++)
+	{
+		uint16_t u16CurrentNode = bfsQueue[i];
+		for (uint32_t j = links.aulFirst[u16CurrentNode]; j < links.aulFirst[u16CurrentNode + 1]; j++)
+		{
+			uint16_t u16AdjNode = links.au16Links[j];
+			if ((*pau16Hops)[u16AdjNode] == BOUY_ID_UNREACHABLE)
+			{
+				(*pau16Hops)[u16AdjNode] = (*pau16Hops)[u16CurrentNode] + 1;
+				bfsQueue.push_back(u16AdjNode);
+			}
+		}
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// GetConnectedBouys - Get every bouy that has a route to this one
+////////////////////////////////////////////////////////////////////////////////
+
+void CNavigationNet::GetConnectedBouys(uint16_t u16Bouy, std::vector<uint16_t>* pau16IDs)
+{
+	BouyLinkTable links;
+	GetLinkTable(&links);
+
+	std::vector<uint16_t> au16Hops;
+	GetHopCounts(links, u16Bouy, &au16Hops);
+
+	pau16IDs->clear();
+	for (size_t i = 0; i < au16Hops.size(); i++)
+	{
+		if (au16Hops[i] != BOUY_ID_UNREACHABLE)
+			pau16IDs->push_back(i);
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// LinkBouys - Connect two bouys and update the routing tables that changed
+////////////////////////////////////////////////////////////////////////////////
+
+void CNavigationNet::LinkBouys(managed_ptr<CBouy> pBouy0, managed_ptr<CBouy> pBouy1)
+{
+	// Get the hop counts from each end before they are linked.
+	BouyLinkTable links;
+	GetLinkTable(&links);
+	std::vector<uint16_t> au16Hops0;
+	std::vector<uint16_t> au16Hops1;
+	GetHopCounts(links, pBouy0->m_u16ID, &au16Hops0);
+	GetHopCounts(links, pBouy1->m_u16ID, &au16Hops1);
+
+	pBouy0->AddLink(pBouy1);
+	pBouy1->AddLink(pBouy0);
+
+	// A route from some bouy can only get shorter through the new link if
+	// that bouy is at least two hops nearer to one end than to the other,
+	// or can reach only one end.  Every other bouy's routes are still as
+	// short as any route through the new link.
+	std::vector<uint16_t> au16Affected;
+   for (auto iter = m_NodeMap.begin(); iter != m_NodeMap.end(); ++iter)
+	{
+		uint16_t u16Hops0 = au16Hops0[iter->first];
+		uint16_t u16Hops1 = au16Hops1[iter->first];
+		if (u16Hops0 != u16Hops1 &&
+			 (u16Hops0 == BOUY_ID_UNREACHABLE ||
+			  u16Hops1 == BOUY_ID_UNREACHABLE ||
+			  std::abs(int32_t(u16Hops0) - int32_t(u16Hops1)) >= 2))
+			au16Affected.push_back(iter->first);
+	}
+
+	UpdateRoutingTables(au16Affected);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 // UpdateRoutingTables - Ping all of the bouys from the list in this network
 //								 which will force them all to build up complete
@@ -756,31 +1033,152 @@ uint8_t CNavigationNet::FindNearestBouy(short sX, short sZ)
 
 void CNavigationNet::UpdateRoutingTables(void)
 {
+	std::vector<uint16_t> au16IDs;
+	au16IDs.reserve(m_NodeMap.size());
    for (auto iter = m_NodeMap.begin(); iter != m_NodeMap.end(); ++iter)
-      iter->second->BuildRoutingTable();
+		au16IDs.push_back(iter->first);
 
-#if 0
-	char szLine[256];
-	FILE* fp;
-	fp = fopen("c:\\temp\\net.txt", "wt");
-	if (fp != nullptr)
+	UpdateRoutingTables(au16IDs);
+
+//	PrintRoutingTables();	
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// UpdateRoutingTables - Rebuild the routing tables of the given bouys.  Large
+//								 batches are shared out between worker threads.
+////////////////////////////////////////////////////////////////////////////////
+
+void CNavigationNet::UpdateRoutingTables(const std::vector<uint16_t>& au16IDs)
+{
+	microseconds_t ulStartTime = rspGetAppMicroseconds();
+
+	// Cached routes followed the old tables.
+	InvalidateRoutes();
+
+	BouyLinkTable links;
+	GetLinkTable(&links);
+
+	// Look the bouys up here so the workers only deal in plain pointers.
+	std::vector<CBouy*> apBouys;
+	apBouys.reserve(au16IDs.size());
+	for (uint16_t u16ID : au16IDs)
 	{
-		for (i = m_NodeMap.begin(); i != m_NodeMap.end(); i++)
-		{
-			sprintf(szLine, "Node %d\n", ((*i).second)->m_ucID);
-			fwrite(szLine, sizeof(char), strlen(szLine), fp);
-			((*i).second)->BuildRoutingTable();
-		}	 
-		fclose(fp);
+		auto iter = m_NodeMap.find(u16ID);
+		if (iter != m_NodeMap.end())
+			apBouys.push_back(&(*iter->second));
+	}
+
+	uint32_t ulNumThreads = 1;
+	if (apBouys.size() >= NAVNET_PARALLEL_MIN_BOUYS)
+		ulNumThreads = std::max(1u, std::min(std::thread::hardware_concurrency(), uint32_t(NAVNET_MAX_THREADS)));
+
+	std::atomic<size_t> nextBouy(0);
+	auto BuildTables = [&]()
+	{
+		for (size_t i = nextBouy++; i < apBouys.size(); i = nextBouy++)
+			apBouys[i]->BuildRoutingTable(links);
+	};
+
+	std::vector<std::thread> workers;
+	for (uint32_t i = 1; i < ulNumThreads; i++)
+		workers.emplace_back(BuildTables);
+	BuildTables();
+	for (std::thread& worker : workers)
+		worker.join();
+
+	// Report the rebuild time in release builds too, so not with TRACE.
+	rspTrace("CNavigationNet::UpdateRoutingTables(): %s: rebuilt %u of %u tables on %u thread(s) in %u us.\n",
+		(const char*)m_rstrNetName, (uint32_t)apBouys.size(), (uint32_t)m_NodeMap.size(), ulNumThreads,
+		(uint32_t)(rspGetAppMicroseconds() - ulStartTime));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// NextWaypoint - Get the next bouy to head for from the cached route
+////////////////////////////////////////////////////////////////////////////////
+
+uint16_t CNavigationNet::NextWaypoint(uint16_t u16From, uint16_t u16Dst)
+{
+	const std::vector<uint16_t>& au16Route = GetRoute(u16From, u16Dst);
+	return au16Route.empty() ? 0 : au16Route.front();
+}
 
+////////////////////////////////////////////////////////////////////////////////
+// GetRoute - Find a route in the cache, or follow the routing tables hop by hop
+//				  to make one.  With the SmoothRoutes setting, hops that can be
+//				  walked straight past are pulled out.  Every bouy left on the
+//				  route gets the rest of it cached as its own route, since the
+//				  tables would lead it the same way.
+////////////////////////////////////////////////////////////////////////////////
+
+const std::vector<uint16_t>& CNavigationNet::GetRoute(uint16_t u16From, uint16_t u16Dst)
+{
+	m_ulRouteQueries++;
+	auto found = m_routes.find((uint32_t(u16From) << 16) | u16Dst);
+	if (found != m_routes.end())
+	{
+		m_ulRouteHits++;
+		return found->second;
 	}
-	else
+
+	if (m_routes.size() >= NAVNET_ROUTE_CACHE_MAX)
 	{
-		TRACE("*********** Nav Net unable to open log file\n");
+		rspTrace("CNavigationNet::GetRoute(): %s: cache full after %u queries, %u hits.\n",
+			(const char*)m_rstrNetName, m_ulRouteQueries, m_ulRouteHits);
+		InvalidateRoutes();
 	}
-#endif
 
-//	PrintRoutingTables();	
+	// Follow the tables.  A route can't have more hops than there are bouys, so
+	// anything longer is a loop from half updated tables.
+	std::vector<CBouy*> apHops;
+	std::vector<uint16_t> au16Route;
+	auto iter = m_NodeMap.find(u16From);
+	CBouy* pBouy = (iter != m_NodeMap.end()) ? &(*iter->second) : nullptr;
+	apHops.push_back(pBouy);
+	while (pBouy != nullptr && pBouy->m_u16ID != u16Dst)
+	{
+		uint16_t u16Next = pBouy->NextRouteNode(u16Dst);
+		iter = m_NodeMap.find(u16Next);
+		pBouy = (iter != m_NodeMap.end() && apHops.size() <= m_NodeMap.size()) ? &(*iter->second) : nullptr;
+		apHops.push_back(pBouy);
+	}
+
+	if (pBouy == nullptr)
+	{
+		au16Route.push_back(BOUY_ID_UNREACHABLE);
+		return m_routes[(uint32_t(u16From) << 16) | u16Dst] = au16Route;
+	}
+
+	// Keep a hop only if you can't walk from the last kept one straight on to
+	// the hop after it.
+	std::vector<CBouy*> apRoute;
+	apRoute.push_back(apHops.front());
+	for (size_t i = 1; i < apHops.size(); i++)
+	{
+		if (i + 1 == apHops.size() || g_GameSettings.m_sSmoothRoutes == FALSE || !IsWalkClear(apRoute.back(), apHops[i + 1]))
+			apRoute.push_back(apHops[i]);
+	}
+
+	for (size_t i = apRoute.size(); i-- > 0; )
+	{
+		if (i + 1 < apRoute.size())
+			au16Route.insert(au16Route.begin(), apRoute[i + 1]->m_u16ID);
+		m_routes[(uint32_t(apRoute[i]->m_u16ID) << 16) | u16Dst] = au16Route;
+	}
+
+	return m_routes[(uint32_t(u16From) << 16) | u16Dst];
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// IsWalkClear - Check that the terrain lets you walk straight between bouys
+////////////////////////////////////////////////////////////////////////////////
+
+bool CNavigationNet::IsWalkClear(CBouy* pFrom, CBouy* pTo)
+{
+	return realm()->IsPathClear(
+		(int32_t) pFrom->GetX(), (int32_t) pFrom->GetY(), (int32_t) pFrom->GetZ(),
+		4.0,
+		(int32_t) pTo->GetX(), (int32_t) pTo->GetZ(),
+		CThing3d::MaxStepUpThreshold);
 }
 
 void CNavigationNet::PrintRoutingTables(void)
@@ -792,7 +1190,7 @@ void CNavigationNet::PrintRoutingTables(void)
 	{
       for (auto iter = m_NodeMap.begin(); iter != m_NodeMap.end(); ++iter)
 		{
-         sprintf(szLine, "\nNode %d\n----------------------\n", iter->second->m_ucID);
+         sprintf(szLine, "\nNode %d\n----------------------\n", iter->second->m_u16ID);
 			fwrite(szLine, sizeof(char), strlen(szLine), fp);
          iter->second->PrintRouteTable(fp);
 //			iter->second->PrintDirectLinks(fp);
@@ -827,6 +1225,8 @@ int16_t CNavigationNet::DeleteNetwork(void)
    int16_t sResult = SUCCESS;
 
 	m_NodeMap.erase(m_NodeMap.begin(), m_NodeMap.end());
+	m_bGridDirty = true;
+	InvalidateRoutes();
 
    return sResult;
 }
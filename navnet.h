@@ -39,11 +39,29 @@
 #define NAVIGATIONNET_H
 
 #include <map>
+#include <unordered_map>
+#include <vector>
 
 #include "thing.h"
 #include <newpix/sprite_base.h>
 
-#include "bouy.h" // remove when TreeListNode is no longer used
+#include "bouy.h"
+
+// FindNearestBouy() keeps the bouys in a grid of square cells this many
+// bits of world units wide (64).
+#define NAVNET_GRID_CELL_SHIFT	6
+
+// When visibility is baked, each cell records the bouys within this many
+// cells of it that can be reached from anywhere in the cell.
+#define NAVNET_VIS_RADIUS			4
+
+// Routing table rebuilds of at least this many bouys are spread across
+// worker threads (up to NAVNET_MAX_THREADS of them).
+#define NAVNET_PARALLEL_MIN_BOUYS	64
+#define NAVNET_MAX_THREADS			16
+
+// The route cache is emptied once it holds this many routes.
+#define NAVNET_ROUTE_CACHE_MAX	4096
 
 class CBouy;
 // CNavigationNet is the class for navigation
@@ -56,14 +74,33 @@ class CNavigationNet
 	// Variables
 	//---------------------------------------------------------------------------
 	public:
-      std::map<uint8_t, managed_ptr<CBouy>>	m_NodeMap;										// Map of ID's to CBouy nodes
+      std::map<uint16_t, managed_ptr<CBouy>>	m_NodeMap;										// Map of ID's to CBouy nodes
 
 	protected:
-		uint8_t	 m_ucNextID;
-      uint8_t	 m_ucNumSavedBouys;
+		uint16_t	 m_u16NextID;
+      uint16_t	 m_u16NumSavedBouys;
 		RString  m_rstrNetName;									// Name of Nav Net
-		TreeListNode m_BouyTreeListHead;						// Head of sorted list
-		TreeListNode m_BouyTreeListTail;						// Tail of sorted list
+
+		// Spatial grid of bouy IDs for FindNearestBouy().  It covers the
+		// bounding box of the bouys plus NAVNET_VIS_RADIUS cells on each side
+		// and is rebuilt (and its visibility baked again, if it was baked) by
+		// the next query after a bouy is added, removed or moved.
+		std::vector<std::vector<uint16_t>> m_aGridCells;	// IDs in each cell, ascending
+		std::vector<std::vector<uint16_t>> m_aGridVisible;	// Baked visible IDs per cell (may be empty)
+		int32_t	m_lGridX0;											// Cell X of the grid's left column
+		int32_t	m_lGridZ0;											// Cell Z of the grid's top row
+		int32_t	m_lGridW;											// Width of grid in cells
+		int32_t	m_lGridH;											// Height of grid in cells
+		bool		m_bGridDirty;										// true, if grid needs rebuilding
+		bool		m_bGridBaked;										// true, if rebuilds should bake visibility too
+
+		// Routes shared by everyone using this network, by (from << 16) | to.
+		// Each lists the bouys to head for in order, ending with the
+		// destination.  Empty means you're there; BOUY_ID_UNREACHABLE alone
+		// means you can't get there.
+		std::unordered_map<uint32_t, std::vector<uint16_t>> m_routes;
+		uint32_t	m_ulRouteQueries;									// NextWaypoint() calls
+		uint32_t	m_ulRouteHits;										// Calls answered by the cache
 
 		int16_t m_sSuspend;											// Suspend flag
 
@@ -147,29 +184,57 @@ class CNavigationNet
 #endif // !defined(EDITOR_REMOVED)
 
 		// Add a bouy to this network and assign it an ID
-		uint8_t AddBouy(CBouy* pBouy);
+		uint16_t AddBouy(CBouy* pBouy);
 
-		// Remove a bouy from the network
-		void RemoveBouy(uint8_t ucBouyID);
+		// Remove a bouy from the network.  Its links should already be gone
+		// (see CBouy::Unlink() which also updates the routing tables).
+		void RemoveBouy(uint16_t u16BouyID);
+
+		// Link two bouys in both directions and rebuild the routing tables of
+		// just the bouys whose shortest routes the new link changes.
+		void LinkBouys(managed_ptr<CBouy> pBouy0, managed_ptr<CBouy> pBouy1);
+
+		// Get the IDs of every bouy with a route to this one (itself included).
+		void GetConnectedBouys(uint16_t u16Bouy, std::vector<uint16_t>* pau16IDs);
 
 		// Get the address of the Bouy with this ID
-      managed_ptr<CBouy> GetBouy(uint8_t ucBouy);
+      managed_ptr<CBouy> GetBouy(uint16_t u16Bouy);
 
 		// Find the bouy closest to this location in the world
-		uint8_t FindNearestBouy(int16_t sX, int16_t sZ);
+		uint16_t FindNearestBouy(int32_t lX, int32_t lZ);
+
+		// Flag the spatial grid as stale after a bouy has moved.
+		void InvalidateGrid(void)
+			{ m_bGridDirty = true; }
+
+		// Record which bouys are visible from each grid cell so most
+		// FindNearestBouy() calls can skip the path check.
+		void BakeVisibility(void);
 
 		// Preprocess the routing tables by pinging all nodes
 		void UpdateRoutingTables(void);
 
+		// Rebuild the routing tables of just these bouys
+		void UpdateRoutingTables(const std::vector<uint16_t>& au16IDs);
+
+		// Like CBouy::NextRouteNode(), but through the route cache, and with the
+		// SmoothRoutes setting, skipping bouys that can be walked straight past.
+		uint16_t NextWaypoint(										// Returns 0 if there, BOUY_ID_UNREACHABLE if lost
+			uint16_t u16From,											// In:  Bouy you're at
+			uint16_t u16Dst);											// In:  Bouy you're going to
+
+		void InvalidateRoutes(void)
+			{ m_routes.clear(); }
+
 		// Print the routing tables for debugging purposes
 		void PrintRoutingTables(void);
 
 		// Ping - return minimum number of hops from source to destination nodes
 //		uint8_t Ping(uint8_t dst, uint8_t src, uint8_t depth, uint8_t maxdepth);
-		uint8_t Ping(uint8_t dst, uint8_t src, uint8_t depth);
+		uint16_t Ping(uint16_t dst, uint16_t src, uint16_t depth);
 
-		uint8_t GetNumNodes(void)
-			{ return m_ucNextID;}
+		uint16_t GetNumNodes(void)
+			{ return m_u16NextID;}
 
 		// Set this NavNet as the default one for the Realm.  
       int16_t SetAsDefault(void);
@@ -186,6 +251,27 @@ class CNavigationNet
 		
 		// Free all resources
 		int16_t FreeResources(void);						// Returns 0 if successfull, non-zero otherwise
+
+		// Sort the bouys into the spatial grid
+		void BuildGrid(void);
+
+		// Take a flat copy of the links between the bouys
+		void GetLinkTable(BouyLinkTable* plinks);
+
+		const std::vector<uint16_t>& GetRoute(				// Returns the cached route
+			uint16_t u16From,											// In:  Bouy you're at
+			uint16_t u16Dst);											// In:  Bouy you're going to
+
+		bool IsWalkClear(												// Returns true if you can walk straight there
+			CBouy* pFrom,												// In:  Bouy to walk from
+			CBouy* pTo);												// In:  Bouy to walk to
+
+		// Get the number of hops from u16Src to each bouy (BOUY_ID_UNREACHABLE
+		// if there is no route).
+		static void GetHopCounts(
+			const BouyLinkTable& links,						// In:  Links to follow
+			uint16_t u16Src,										// In:  Bouy to count from
+			std::vector<uint16_t>* pau16Hops);				// Out: Hops to each bouy ID
 	};
 
 
@@ -5,6 +5,14 @@
 
 #include <cstring>
 
+#if defined(__SSE__) || defined(_M_X64)
+  #include <xmmintrin.h>
+  #define THREEDTYPES_SSE
+#elif defined(__ARM_NEON__) || defined(__ARM_NEON)
+  #include <arm_neon.h>
+  #define THREEDTYPES_NEON
+#endif
+
 void RTexture::setSize(uint16_t cnt) noexcept
 {
   m_count = cnt;
@@ -186,13 +194,36 @@ bool RSop::operator ==(const RSop& other) const noexcept
 
 //==============================================================================
 
-inline void MatrixMultiply(real_t* matOut, real_t* matA, real_t* matB, uint8_t row, uint8_t col) noexcept
+// Row r of a 3/4 product: A[r][0] * B row 0 + ... + A[r][3] * B row 3, summed
+// in the same order as the scalar version.  The A values are read before the
+// row is written, and B rows after the rows before it are, so that a
+// PreMulBy() in place updates row by row as it always has.
+inline void MatrixMultiplyRow(real_t* matOut, const real_t* matA, const real_t* matB, uint8_t row) noexcept
 {
-  matOut[rowcol(row, col)] =
-      matA[rowcol(row, 0)] * matB[rowcol(0, col)] +
-      matA[rowcol(row, 1)] * matB[rowcol(1, col)] +
-      matA[rowcol(row, 2)] * matB[rowcol(2, col)] +
-      matA[rowcol(row, 3)] * matB[rowcol(3, col)];
+  real_t a0 = matA[rowcol(row, 0)];
+  real_t a1 = matA[rowcol(row, 1)];
+  real_t a2 = matA[rowcol(row, 2)];
+  real_t a3 = matA[rowcol(row, 3)];
+#if defined(THREEDTYPES_SSE)
+  __m128 vRow = _mm_mul_ps(_mm_set1_ps(a0), _mm_loadu_ps(matB + rowcol(0, 0)));
+  vRow = _mm_add_ps(vRow, _mm_mul_ps(_mm_set1_ps(a1), _mm_loadu_ps(matB + rowcol(1, 0))));
+  vRow = _mm_add_ps(vRow, _mm_mul_ps(_mm_set1_ps(a2), _mm_loadu_ps(matB + rowcol(2, 0))));
+  vRow = _mm_add_ps(vRow, _mm_mul_ps(_mm_set1_ps(a3), _mm_loadu_ps(matB + rowcol(3, 0))));
+  _mm_storeu_ps(matOut + rowcol(row, 0), vRow);
+#elif defined(THREEDTYPES_NEON)
+  float32x4_t vRow = vmulq_n_f32(vld1q_f32(matB + rowcol(0, 0)), a0);
+  vRow = vaddq_f32(vRow, vmulq_n_f32(vld1q_f32(matB + rowcol(1, 0)), a1));
+  vRow = vaddq_f32(vRow, vmulq_n_f32(vld1q_f32(matB + rowcol(2, 0)), a2));
+  vRow = vaddq_f32(vRow, vmulq_n_f32(vld1q_f32(matB + rowcol(3, 0)), a3));
+  vst1q_f32(matOut + rowcol(row, 0), vRow);
+#else
+  for (uint8_t col = 0; col < 4; ++col)
+    matOut[rowcol(row, col)] =
+        a0 * matB[rowcol(0, col)] +
+        a1 * matB[rowcol(1, col)] +
+        a2 * matB[rowcol(2, col)] +
+        a3 * matB[rowcol(3, col)];
+#endif
 }
 
 inline void MatrixScale(real_t* mat, real_t x, real_t y, real_t z, uint8_t col) noexcept
@@ -209,22 +240,13 @@ inline void MatrixScale(real_t* mat, real_t x, real_t y, real_t z, uint8_t col)
   op(__VA_ARGS__, 3)
 
 
-#define ExecOp3x4(op, ...) \
-  op(__VA_ARGS__, 0, 0); \
-  op(__VA_ARGS__, 0, 1); \
-  op(__VA_ARGS__, 0, 2); \
-  op(__VA_ARGS__, 0, 3); \
-  op(__VA_ARGS__, 1, 0); \
-  op(__VA_ARGS__, 1, 1); \
-  op(__VA_ARGS__, 1, 2); \
-  op(__VA_ARGS__, 1, 3); \
-  op(__VA_ARGS__, 2, 0); \
-  op(__VA_ARGS__, 2, 1); \
-  op(__VA_ARGS__, 2, 2); \
-  op(__VA_ARGS__, 2, 3)
+#define ExecOp3(op, ...) \
+  op(__VA_ARGS__, 0); \
+  op(__VA_ARGS__, 1); \
+  op(__VA_ARGS__, 2)
 
 #define setRow(row, val) \
-  reinterpret_cast<Vector3D*>(matdata.get())[row] = val;
+  reinterpret_cast<Vector3D*>(matdata)[row] = val;
 
 #define setColumn(col, val) \
   matdata[rowcol(0, col)] = val.x(); \
@@ -243,28 +265,23 @@ real_t identity_data[16] = { 1.0, 0.0, 0.0, 0.0,
 RTransform::RTransform(uint32_t sz) noexcept  // init to an identity transform
   : filedata_t(sz)
 {
-  if(!data)
-    matdata.allocate(16);
   makeIdentity();
 }
 
 void RTransform::load(void) noexcept
 {
   data.setSize(16 * sizeof(real_t));
-  matdata = reinterpret_cast<real_t*>(data.get());
-  matdata.setSize(16);
+  std::memcpy(matdata, data.get(), sizeof(real_t) * 16);
   setLoaded();
 }
 
 void RTransform::makeIdentity(void) noexcept // identity matrix
 {
-  ASSERT(matdata.size() >= 16);
   std::memcpy(matdata, identity_data, sizeof(real_t) * 16);
 }
 
 void RTransform::makeNull(void) noexcept // null matrix
 {
-  ASSERT(matdata.size() >= 16);
   std::memset(matdata, 0, sizeof(real_t) * 15);
   matdata[15] = 1;
 }
@@ -272,13 +289,13 @@ void RTransform::makeNull(void) noexcept // null matrix
 // A Partial transform, assuming R3 = {0,0,0,1};
 void RTransform::PreMulBy(const RTransform& M) noexcept
 {
-  ExecOp3x4(MatrixMultiply, matdata, M.matdata, matdata);
+  ExecOp3(MatrixMultiplyRow, matdata, M.matdata, matdata);
 }
 
 // Oversets the current data with the result!
 void RTransform::Mul(const RTransform& A, const RTransform& B) noexcept // 4x4 transforms:
 {
-  ExecOp3x4(MatrixMultiply, matdata, A.matdata, B.matdata);
+  ExecOp3(MatrixMultiplyRow, matdata, A.matdata, B.matdata);
 }
 
 void RTransform::Scale(real_t x,real_t y, real_t z) noexcept
@@ -322,7 +339,7 @@ void RTransform::MakeRotFrom(Vector3D point, Vector3D up) noexcept
 // Transform an actual point ( overwrites old point )
 void RTransform::Transform(Vector3D& p) const noexcept
 {
-  Vector3D* d = reinterpret_cast<Vector3D*>(matdata.get());
+  const Vector3D* d = reinterpret_cast<const Vector3D*>(matdata);
   p = Vector3D(p.dot(d[0]), p.dot(d[1]), p.dot(d[2]));
   p.setW(1.0);
 }
@@ -330,7 +347,7 @@ void RTransform::Transform(Vector3D& p) const noexcept
 // Transform an actual point, and places the answer into a different pt
 void RTransform::TransformInto(const Vector3D& src, Vector3D& dest) const noexcept
 {
-  Vector3D* d = reinterpret_cast<Vector3D*>(matdata.get());
+  const Vector3D* d = reinterpret_cast<const Vector3D*>(matdata);
   dest.setX(src.dot(d[0]));
   dest.setY(src.dot(d[1]));
   dest.setZ(src.dot(d[2]));
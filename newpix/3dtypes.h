@@ -320,17 +320,23 @@ public:
 // 2 matrices together.  This prevents a malloc
 // nightmare:
 //
+// The matrix is held by value (loaded ones are copied out of the file data)
+// so temporary transforms on the stack never touch the heap.
+//
 class RTransform : public filedata_t
 {
   friend class RPipeLine; // allow encapsulation to be violated for speed
 private:
-  shared_arr<real_t> matdata; // This is compatible with the aggregate transform
+  alignas(16) real_t matdata[16]; // This is compatible with the aggregate transform
 
 public:
   RTransform(uint32_t sz = 0) noexcept;
 
   void load(void) noexcept;
 
+  // The 16 matrix values.
+  const real_t* matrix(void) const noexcept { return matdata; }
+
   void makeIdentity(void) noexcept; // identity matrix
   void makeNull(void) noexcept; // null matrix
 
@@ -377,6 +377,9 @@ void COstrich::Update(void)
 						else
                      rotation.y = rspMod360(rotation.y + 20);
 					}
+
+					// Steer clear of the rest of the flock.
+					AvoidCrowd(dSeconds);
 				}
 		
 				break;
@@ -438,6 +441,8 @@ void COstrich::Update(void)
                   rotation.y = rspMod360(rotation.y + 20);
 				}
 
+				// Steer clear of anyone in the way before running into them.
+				AvoidCrowd(dSeconds);
 
 				break;
 
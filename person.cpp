@@ -575,6 +575,16 @@ int16_t CPerson::Init(void)
 }
 
 
+////////////////////////////////////////////////////////////////////////////////
+// Think - Evaluate the logic table to get a suggested action.
+////////////////////////////////////////////////////////////////////////////////
+void CPerson::Think(void)
+{
+	CDoofus::Think();
+	m_pLogicTable->Evaluate(this, ms_u16IdLogAI == GetInstanceID());
+}
+
+
 ////////////////////////////////////////////////////////////////////////////////
 // Update object
 ////////////////////////////////////////////////////////////////////////////////
@@ -588,9 +598,13 @@ void CPerson::Update(void)
 		if (lThisTime > m_lEvalTimer)
 		{
 			m_lEvalTimer = lThisTime + 500 + (GetRandom() % 500);
-			m_pLogicTable->Evaluate(this, ms_u16IdLogAI == GetInstanceID());
+			m_bThinkPending = true;
 		}
 
+		// Think now, or when the realm has time for it.
+		if (m_bThinkPending)
+			RequestThink();
+
 		// Check for new messages that may change the state
 		ProcessMessages();
 
@@ -1152,11 +1166,11 @@ int16_t CPerson::EditModify(void)
 			peditLogicFile->Compose();
 
 			// Set current start bouy
-			peditStartBouy->SetText("%d", m_ucSpecialBouy0ID);
+			peditStartBouy->SetText("%d", m_u16SpecialBouy0ID);
 			peditStartBouy->Compose();
 
 			// Set current end bouy
-			peditEndBouy->SetText("%d", m_ucSpecialBouy1ID);
+			peditEndBouy->SetText("%d", m_u16SpecialBouy1ID);
 			peditEndBouy->Compose();
 
 			// Set callback for logic browser button.
@@ -1215,8 +1229,8 @@ int16_t CPerson::EditModify(void)
 					m_rstrLogicFile.Update();
 
 					// Get the bouy settings
-					m_ucSpecialBouy0ID = peditStartBouy->GetVal();
-					m_ucSpecialBouy1ID = peditEndBouy->GetVal();
+					m_u16SpecialBouy0ID = peditStartBouy->GetVal();
+					m_u16SpecialBouy1ID = peditEndBouy->GetVal();
 
 					if (sResult == ID_GUI_EDIT_TEXTURES)
 						{
@@ -190,6 +190,9 @@ class CPerson : public CDoofus
 		// Update object
 		void Update(void);
 
+		// Evaluate the logic table
+		void Think(void);
+
 		// Render object.
 		void Render(void);
 
@@ -2615,10 +2615,21 @@ class CPlayStatus : public CPlay
 
                      if (m_lSumFrameTimes && m_bUpdateRealm)
 								{
+								// How evenly frames reach the screen, where the display
+								// keeps track of it.
+								char	szFrameTimes[64]	= "";
+								RFrameTimes	ft;
+								if (rspGetFrameTimes(&ft) == SUCCESS)
+									{
+									snprintf(szFrameTimes, sizeof(szFrameTimes), " p95: %u.%ums Late: %u",
+										ft.ulP95US / 1000, (ft.ulP95US / 100) % 10, ft.ulMissed);
+									}
+
 								m_print.print(
 									m_rectInfo.sX, m_rectInfo.sY,
-									"FPS: %i Video H/W Update: %i%% %s", 
+									"FPS: %i%s Video H/W Update: %i%% %s", 
 									m_lFramePerSecond,
+									szFrameTimes,
 									(pinfo->m_lSumUpdateDisplayTimes * 100) / m_lSumFrameTimes,
 									m_szFileDescriptor);
 
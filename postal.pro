@@ -1,6 +1,7 @@
 QT=
 CONFIG += c++14
 CONFIG += strict_c++
+CONFIG += thread
 
 QMAKE_CXXFLAGS_DEBUG += -O0 -g3
 QMAKE_CXXFLAGS_RELEASE += -Os
@@ -137,6 +138,7 @@ HEADERS += \
     collision.h \
     crawler.h \
     credits.h \
+    crowd.h \
     CtrlBuf.h \
     cutscene.h \
     deathWad.h \
@@ -153,6 +155,7 @@ HEADERS += \
     firebomb.h \
     flag.h \
     flagbase.h \
+    flowfield.h \
     game.h \
     gameedit.h \
     GameSettings.h \
@@ -165,6 +168,7 @@ HEADERS += \
     heatseeker.h \
     hood.h \
     Hskirts.h \
+    impostor.h \
     input.h \
     InputSettings.h \
     InputSettingsDlg.h \
@@ -319,6 +323,7 @@ SOURCES += \
     chunk.cpp \
     crawler.cpp \
     credits.cpp \
+    crowd.cpp \
     cutscene.cpp \
     deathWad.cpp \
     demon.cpp \
@@ -332,6 +337,7 @@ SOURCES += \
     firebomb.cpp \
     flag.cpp \
     flagbase.cpp \
+    flowfield.cpp \
     game.cpp \
     gameedit.cpp \
     GameSettings.cpp \
@@ -340,6 +346,7 @@ SOURCES += \
     grip.cpp \
     heatseeker.cpp \
     hood.cpp \
+    impostor.cpp \
     input.cpp \
     InputSettings.cpp \
     InputSettingsDlg.cpp \
@@ -231,7 +231,7 @@ int16_t CPylon::Save(										// Returns 0 if successfull, non-zero otherwise
 void CPylon::Startup(void)								// Returns 0 if successfull, non-zero otherwise
 {
 	// At this point we can assume the CHood was loaded, so we init our height
-   position.y = realm()->GetHeight((int16_t) position.x, (int16_t) position.z);
+   position.y = realm()->GetHeight((int32_t) position.x, (int32_t) position.z);
 
 	// Init other stuff
    GetResources();
@@ -538,7 +538,7 @@ void CPylon::EditRender(void)
    m_sY2	-= m_pImage->m_sHeight;
 
 	// Layer should be based on info we get from attribute map.
-   m_sLayer = CRealm::GetLayerViaAttrib(realm()->GetLayer((int16_t) position.x, (int16_t) position.z));
+   m_sLayer = CRealm::GetLayerViaAttrib(realm()->GetLayer((int32_t) position.x, (int32_t) position.z));
 
    Object::enqueue(SpriteUpdate); // Update sprite in scene
 }
@@ -341,6 +341,7 @@
 #include <RSPiX.h>
 
 #include <ctime>
+#include <algorithm>
 
 #include "game.h"
 #include "reality.h"
@@ -620,6 +621,18 @@ void CRealm::Init(void)		// Returns nothing.  Cannot fail.
 		m_asPylonUIDs[i] = 0; // clear the Pylon UIDs!
 	m_sNumPylons = 0;
 	m_ucNextPylonID = 1;
+
+	// Line of sight cache.
+	std::memset(m_aLOSCache, 0, sizeof(m_aLOSCache));
+	m_ulLOSFrame	= 1;
+	m_ulLOSQueries	= 0;
+	m_ulLOSHits		= 0;
+
+	// Think scheduler.
+	m_aThinkQueue.clear();
+	m_ulThinks				= 0;
+	m_ulThinksDeferred	= 0;
+	m_ulThinkOverruns		= 0;
 	}
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -630,6 +643,22 @@ void CRealm::Clear()
 	// Shutdown the realm (in case this hasn't been done yet)
 //	Shutdown();
 
+	// Report how much crawling the line of sight cache saved (in release
+	// builds too, so not with TRACE).
+	if (m_ulLOSQueries > 0)
+		{
+		rspTrace("CRealm::Clear(): LOS cache: %u queries, %u hits (%u%%).\n",
+			m_ulLOSQueries, m_ulLOSHits, 
+			uint32_t(uint64_t(m_ulLOSHits) * 100 / m_ulLOSQueries) );
+		}
+
+	// Report how the think scheduler kept up (in release builds too).
+	if (m_ulThinks > 0)
+		{
+		rspTrace("CRealm::Clear(): Thinks: %u run, %u deferred, %u updates over budget.\n",
+			m_ulThinks, m_ulThinksDeferred, m_ulThinkOverruns);
+		}
+
    m_thing_by_type.clear();
    m_thing_by_id.clear();
    m_id_by_thing.clear();
@@ -645,6 +674,10 @@ void CRealm::Clear()
 	m_smashatorium.Reset();
 #endif
 
+	// Drop the flow fields; they are for this realm's hood.
+	m_flowfields.Reset();
+	m_crowd.Reset();
+
 	// Re-Initialize.
 	Init();
 	}
@@ -976,15 +1009,15 @@ int16_t CRealm::Load(										// Returns 0 if successfull, non-zero otherwise
 
 		// Allocate the Smashatorium:
 		// Kill old...*
-		short	sOldW = m_smashatorium.m_sWorldW;
-		short	sOldH = m_smashatorium.m_sWorldH;
-		short sOldTileW = m_smashatorium.m_sTileW;
-		short sOldTileH = m_smashatorium.m_sTileH;
+		int32_t	lOldW = m_smashatorium.m_lWorldW;
+		int32_t	lOldH = m_smashatorium.m_lWorldH;
+		int32_t lOldTileW = m_smashatorium.m_lTileW;
+		int32_t lOldTileH = m_smashatorium.m_lTileH;
 
 
 		if (m_smashatorium.m_pGrid) m_smashatorium.Destroy();
 
-		if (m_smashatorium.Alloc(sOldW,sOldH,sOldTileW,sOldTileH) != SUCCESS)
+		if (m_smashatorium.Alloc(lOldW,lOldH,lOldTileW,lOldTileH) != SUCCESS)
 			{
 			TRACE("CRealm::Load(): Error reallocating the smashatorium!\n");
 			sResult = FAILURE;
@@ -1320,10 +1353,10 @@ bool CRealm::IsEndOfLevelGoalMet(bool bEndLevelKey)
 ////////////////////////////////////////////////////////////////////////////////
 bool CRealm::IsPathClear(			// Returns true, if the entire path is clear.
 											// Returns false, if only a portion of the path is clear.
-											// (see *psX, *psY, *psZ).
-	int16_t sX,							// In:  Starting X.
-	int16_t	sY,							// In:  Starting Y.
-	int16_t sZ,							// In:  Starting Z.
+											// (see *plX, *plY, *plZ).
+	int32_t lX,							// In:  Starting X.
+	int32_t	lY,							// In:  Starting Y.
+	int32_t lZ,							// In:  Starting Z.
 	int16_t sRotY,						// In:  Rotation around y axis (direction on X/Z plane).
 	double dCrawlRate,				// In:  Rate at which to scan ('crawl') path in pixels per
 											// iteration.
@@ -1332,11 +1365,11 @@ bool CRealm::IsPathClear(			// Returns true, if the entire path is clear.
 											// at only one pixel.
 											// NOTE: We could change this to a speed in pixels per second
 											// where we'd assume a certain frame rate.
-	int16_t	sDistanceXZ,				// In:  Distance on X/Z plane.
+	int32_t	lDistanceXZ,				// In:  Distance on X/Z plane.
 	int16_t sVerticalTolerance /*= 0*/,	// In:  Max traverser can step up.
-	int16_t* psX /*= nullptr*/,			// Out: If not nullptr, last clear point on path.
-	int16_t* psY /*= nullptr*/,			// Out: If not nullptr, last clear point on path.
-	int16_t* psZ /*= nullptr*/,			// Out: If not nullptr, last clear point on path.
+	int32_t* plX /*= nullptr*/,			// Out: If not nullptr, last clear point on path.
+	int32_t* plY /*= nullptr*/,			// Out: If not nullptr, last clear point on path.
+	int32_t* plZ /*= nullptr*/,			// Out: If not nullptr, last clear point on path.
 	bool bCheckExtents /*= true*/)	// In:  If true, will consider the edge of the realm a path
 												// inhibitor.  If false, reaching the edge of the realm
 												// indicates a clear path.
@@ -1353,14 +1386,53 @@ bool CRealm::IsPathClear(			// Returns true, if the entire path is clear.
 	// sAngle must be between 0 and 359.
 	sRotY	= rspMod360(sRotY);
 
+	// If enabled, see if this exact path was already crawled this frame.
+	// Many CDoofuses check the same lines (e.g., to the same CDude).
+	LOSCacheEntry*	pentry	= nullptr;
+	if (g_GameSettings.m_sLOSCache != FALSE)
+		{
+		int32_t	lQX	= lX >> REALM_LOS_CACHE_QUANT_SHIFT;
+		int32_t	lQY	= lY >> REALM_LOS_CACHE_QUANT_SHIFT;
+		int32_t	lQZ	= lZ >> REALM_LOS_CACHE_QUANT_SHIFT;
+
+		uint32_t	ulHash	= uint32_t(lQX) * 73856093U 
+								^ uint32_t(lQZ) * 19349663U 
+								^ uint32_t(lQY) * 83492791U
+								^ uint32_t(sRotY) * 2654435761U 
+								^ uint32_t(lDistanceXZ) * 40503U;
+		ulHash	^= ulHash >> 16;
+
+		pentry	= &m_aLOSCache[ulHash & (REALM_LOS_CACHE_SIZE - 1)];
+		m_ulLOSQueries++;
+
+		if (pentry->ulFrame == m_ulLOSFrame
+			&& pentry->lX == lQX
+			&& pentry->lY == lQY
+			&& pentry->lZ == lQZ
+			&& pentry->sRotY == sRotY
+			&& pentry->lDistanceXZ == lDistanceXZ
+			&& pentry->dCrawlRate == dCrawlRate
+			&& pentry->sVerticalTolerance == sVerticalTolerance
+			&& pentry->bCheckExtents == bCheckExtents)
+			{
+			m_ulLOSHits++;
+
+			SET(plX, pentry->lEndX);
+			SET(plY, pentry->lEndY);
+			SET(plZ, pentry->lEndZ);
+
+			return pentry->bClear;
+			}
+		}
+
 	float	fRateX		= COSQ[sRotY] * dCrawlRate;
 	float	fRateZ		= -SINQ[sRotY] * dCrawlRate;
 	float	fRateY		= 0.0;	// If we ever want vertical movement . . .
 
 	// Set initial position to first point to check (NEVER checks original position).
-	float	fPosX			= sX + fRateX;
-	float	fPosY			= sY + fRateY;
-	float	fPosZ			= sZ + fRateZ;
+	float	fPosX			= lX + fRateX;
+	float	fPosY			= lY + fRateY;
+	float	fPosZ			= lZ + fRateZ;
 
 	// Determine amount traveled per iteration on X/Z plane just once.
 	float	fIterDistXZ		= rspSqrt(ABS2(fRateX, fRateZ) );
@@ -1368,11 +1440,11 @@ bool CRealm::IsPathClear(			// Returns true, if the entire path is clear.
 	float	fTotalDistXZ	= 0.0F;
 
 	// Store extents.
-	int16_t	sMaxX			= GetRealmWidth();
-	int16_t	sMaxZ			= GetRealmHeight();
+	int32_t	lMaxX			= GetRealmWidth();
+	int32_t	lMaxZ			= GetRealmHeight();
 
-	int16_t	sMinX			= 0;
-	int16_t	sMinZ			= 0;
+	int32_t	lMinX			= 0;
+	int32_t	lMinZ			= 0;
 
 	int16_t	sCurH;
 
@@ -1380,13 +1452,13 @@ bool CRealm::IsPathClear(			// Returns true, if the entire path is clear.
 
 	// Scan while in realm.
 	while (
-			fPosX > sMinX 
-		&& fPosZ > sMinZ 
-		&& fPosX < sMaxX 
-		&& fPosZ < sMaxZ
-		&& fTotalDistXZ < sDistanceXZ)
+			fPosX > lMinX 
+		&& fPosZ > lMinZ 
+		&& fPosX < lMaxX 
+		&& fPosZ < lMaxZ
+		&& fTotalDistXZ < lDistanceXZ)
 		{
-		sCurH	= GetHeight((int16_t)fPosX, (int16_t)fPosZ);
+		sCurH	= GetHeight((int32_t)fPosX, (int32_t)fPosZ);
 		// If too big a height difference . . .
 		if (sCurH - fPosY > sVerticalTolerance)
 			{
@@ -1403,12 +1475,12 @@ bool CRealm::IsPathClear(			// Returns true, if the entire path is clear.
 		}
 
 	// Set end pt.
-	SET(psX, fPosX);
-	SET(psY, fPosY);
-	SET(psZ, fPosZ);
+	SET(plX, fPosX);
+	SET(plY, fPosY);
+	SET(plZ, fPosZ);
 
 	// If we made it the whole way . . .
-	if (fTotalDistXZ >= sDistanceXZ)
+	if (fTotalDistXZ >= lDistanceXZ)
 		{
 		bEntirelyClear	= true;
 		}
@@ -1419,6 +1491,24 @@ bool CRealm::IsPathClear(			// Returns true, if the entire path is clear.
 		bEntirelyClear	= !bCheckExtents;
 		}
 
+	// Remember the answer for the rest of this frame.
+	if (pentry != nullptr)
+		{
+		pentry->lX						= lX >> REALM_LOS_CACHE_QUANT_SHIFT;
+		pentry->lY						= lY >> REALM_LOS_CACHE_QUANT_SHIFT;
+		pentry->lZ						= lZ >> REALM_LOS_CACHE_QUANT_SHIFT;
+		pentry->lDistanceXZ			= lDistanceXZ;
+		pentry->dCrawlRate			= dCrawlRate;
+		pentry->sRotY					= sRotY;
+		pentry->sVerticalTolerance	= sVerticalTolerance;
+		pentry->bCheckExtents		= bCheckExtents;
+		pentry->bClear					= bEntirelyClear;
+		pentry->lEndX					= fPosX;
+		pentry->lEndY					= fPosY;
+		pentry->lEndZ					= fPosZ;
+		pentry->ulFrame				= m_ulLOSFrame;
+		}
+
 #if 0
 	// FEEDBACK.
 	// Create a line sprite.
@@ -1426,9 +1516,9 @@ bool CRealm::IsPathClear(			// Returns true, if the entire path is clear.
 	if (psl2d != nullptr)
 		{
 		Map3Dto2D(
-			sX, 
-			sY, 
-			sZ, 
+			lX, 
+			lY, 
+			lZ, 
 			&(psl2d->m_sX2), 
 			&(psl2d->m_sY2) );
 		Map3Dto2D(
@@ -1437,8 +1527,8 @@ bool CRealm::IsPathClear(			// Returns true, if the entire path is clear.
 			fPosZ, 
 			&(psl2d->m_sX2End), 
 			&(psl2d->m_sY2End) );
-		psl2d->m_sPriority	= sZ;
-		psl2d->m_sLayer		= GetLayerViaAttrib(GetLayer(sX, sZ));
+		psl2d->m_sPriority	= lZ;
+		psl2d->m_sLayer		= GetLayerViaAttrib(GetLayer(lX, lZ));
 		psl2d->m_u8Color		= (bEntirelyClear == false) ? 249 : 250;
 		// Destroy when done.
       psl2d->flags.DeleteOnRender = true;
@@ -1455,10 +1545,10 @@ bool CRealm::IsPathClear(			// Returns true, if the entire path is clear.
 ////////////////////////////////////////////////////////////////////////////////
 bool CRealm::IsPathClear(			// Returns true, if the entire path is clear.
 											// Returns false, if only a portion of the path is clear.
-											// (see *psX, *psY, *psZ).
-	int16_t sX,							// In:  Starting X.
-	int16_t	sY,							// In:  Starting Y.
-	int16_t sZ,							// In:  Starting Z.
+											// (see *plX, *plY, *plZ).
+	int32_t lX,							// In:  Starting X.
+	int32_t	lY,							// In:  Starting Y.
+	int32_t lZ,							// In:  Starting Z.
 	double dCrawlRate,				// In:  Rate at which to scan ('crawl') path in pixels per
 											// iteration.
 											// NOTE: Values less than 1.0 are inefficient.
@@ -1466,25 +1556,25 @@ bool CRealm::IsPathClear(			// Returns true, if the entire path is clear.
 											// at only one pixel.
 											// NOTE: We could change this to a speed in pixels per second
 											// where we'd assume a certain frame rate.
-	int16_t	sDstX,						// In:  Destination X.
-	int16_t	sDstZ,						// In:  Destination Z.
+	int32_t	lDstX,						// In:  Destination X.
+	int32_t	lDstZ,						// In:  Destination Z.
 	int16_t sVerticalTolerance /*= 0*/,	// In:  Max traverser can step up.
-	int16_t* psX /*= nullptr*/,			// Out: If not nullptr, last clear point on path.
-	int16_t* psY /*= nullptr*/,			// Out: If not nullptr, last clear point on path.
-	int16_t* psZ /*= nullptr*/,			// Out: If not nullptr, last clear point on path.
+	int32_t* plX /*= nullptr*/,			// Out: If not nullptr, last clear point on path.
+	int32_t* plY /*= nullptr*/,			// Out: If not nullptr, last clear point on path.
+	int32_t* plZ /*= nullptr*/,			// Out: If not nullptr, last clear point on path.
 	bool bCheckExtents /*= true*/)	// In:  If true, will consider the edge of the realm a path
 												// inhibitor.  If false, reaching the edge of the realm
 												// indicates a clear path.
 	{
-	int16_t	sDistanceXZ	= rspSqrt(ABS2(sDstX - sX, sZ - sDstZ) );
-	int16_t	sRotY			= rspATan(sZ - sDstZ, sDstX - sX);
+	int32_t	lDistanceXZ	= rspSqrt(ABS2(lDstX - lX, lZ - lDstZ) );
+	int16_t	sRotY			= rspATan(lZ - lDstZ, lDstX - lX);
 
 	return IsPathClear(		// Returns true, if the entire path is clear.
 									// Returns false, if only a portion of the path is clear.
-									// (see *psX, *psY, *psZ).
-		sX,						// In:  Starting X.
-		sY,						// In:  Starting Y.
-		sZ,						// In:  Starting Z.
+									// (see *plX, *plY, *plZ).
+		lX,						// In:  Starting X.
+		lY,						// In:  Starting Y.
+		lZ,						// In:  Starting Z.
 		sRotY,					// In:  Rotation around y axis (direction on X/Z plane).
 		dCrawlRate,				// In:  Rate at which to scan ('crawl') path in pixels per
 									// iteration.
@@ -1493,16 +1583,88 @@ bool CRealm::IsPathClear(			// Returns true, if the entire path is clear.
 									// at only one pixel.
 									// NOTE: We could change this to a speed in pixels per second
 									// where we'd assume a certain frame rate.
-		sDistanceXZ,			// In:  Distance on X/Z plane.
+		lDistanceXZ,			// In:  Distance on X/Z plane.
 		sVerticalTolerance,	// In:  Max traverser can step up.
-		psX,						// Out: If not nullptr, last clear point on path.
-		psY,						// Out: If not nullptr, last clear point on path.
-		psZ,						// Out: If not nullptr, last clear point on path.
+		plX,						// Out: If not nullptr, last clear point on path.
+		plY,						// Out: If not nullptr, last clear point on path.
+		plZ,						// Out: If not nullptr, last clear point on path.
 		bCheckExtents);		// In:  If true, will consider the edge of the realm a path
 									// inhibitor.  If false, reaching the edge of the realm
 									// indicates a clear path.
 	}
 
+////////////////////////////////////////////////////////////////////////////////
+// Run queued thinks, most urgent first, until the ThinkBudget is spent.
+////////////////////////////////////////////////////////////////////////////////
+void CRealm::RunThinks(void)
+	{
+	if (m_aThinkQueue.empty())
+		return;
+
+	std::sort(m_aThinkQueue.begin(), m_aThinkQueue.end(),
+		[](const ThinkRequest& a, const ThinkRequest& b)
+			{
+			// Ties go by ID so the order doesn't depend on the update order.
+			return a.ulPriority != b.ulPriority ? a.ulPriority > b.ulPriority : a.u16ID < b.u16ID;
+			});
+
+	microseconds_t ulBudget = g_GameSettings.m_sThinkBudget;
+	microseconds_t ulStartTime = rspGetAppMicroseconds();
+	microseconds_t ulElapsed = 0;
+	size_t i;
+	// The most urgent think always runs so nothing waits forever on a slow
+	// machine.
+	for (i = 0; i < m_aThinkQueue.size() && (i == 0 || ulElapsed < ulBudget); i++)
+		{
+		managed_ptr<CDoofus> pdoofus = GetThingById<CDoofus>(m_aThinkQueue[i].u16ID);
+		if (pdoofus)
+			pdoofus->Think();
+		ulElapsed = rspGetAppMicroseconds() - ulStartTime;
+		}
+
+	m_ulThinks += i;
+	m_ulThinksDeferred += m_aThinkQueue.size() - i;
+	if (ulElapsed > ulBudget)
+		m_ulThinkOverruns++;
+
+	m_aThinkQueue.clear();
+	}
+
+////////////////////////////////////////////////////////////////////////////////
+// Keep a flow field toward each living dude and advance their rebuilds.
+////////////////////////////////////////////////////////////////////////////////
+void CRealm::UpdateFlowFields(void)
+	{
+	if (g_GameSettings.m_sFlowFields == FALSE || m_flags.bEditing)
+		return;
+
+	if (!m_flowfields.IsSetup())
+		{
+		if (!m_hood || m_flowfields.Setup(this) != SUCCESS)
+			return;
+		}
+
+	for (const managed_ptr<CThing>& pThing : GetThingsByType(CDudeID))
+		{
+		managed_ptr<CDude> pdude = pThing;
+		if (pdude->m_state != CThing3d::State_Dead)
+			m_flowfields.SetTarget(pdude->GetInstanceID(), int32_t(pdude->position.x), int32_t(pdude->position.z));
+		}
+
+	m_flowfields.Update();
+	}
+
+////////////////////////////////////////////////////////////////////////////////
+// Rebuild the crowd's spatial hash.
+////////////////////////////////////////////////////////////////////////////////
+void CRealm::UpdateCrowd(void)
+	{
+	if (g_GameSettings.m_sCrowdAvoidance == FALSE || m_flags.bEditing)
+		return;
+
+	m_crowd.Build(this);
+	}
+
 ////////////////////////////////////////////////////////////////////////////////
 // Gives this realm an opportunity and drawing surface to display its 
 // current status.
@@ -1568,13 +1730,13 @@ void CRealm::MapAttribHeight(	// Returns nothing.
 
 // Get the terrain height at an x/z position.
 // Zero, if off map.
-int16_t CRealm::GetHeight(int16_t sX, int16_t sZ)
+int16_t CRealm::GetHeight(int32_t lX, int32_t lZ)
 	{
    int16_t	sRotX	= m_hood->GetRealmRotX();
 	// Scale the Z based on the view angle.
-   ::MapZ3DtoY2D(sZ, sZ, sRotX);
+   ::MapZ3DtoY2D(lZ, lZ, sRotX);
 
-	int16_t	sH = 4 * (m_pTerrainMap->GetVal(sX, sZ, 0x0000) & REALM_ATTR_HEIGHT_MASK); 
+	int16_t	sH = 4 * (m_pTerrainMap->GetVal(lX, lZ, 0x0000) & REALM_ATTR_HEIGHT_MASK); 
 
 	// Scale into realm.
    MapAttribHeight(sH, sH);
@@ -1585,15 +1747,15 @@ int16_t CRealm::GetHeight(int16_t sX, int16_t sZ)
 // Get the height and 'not walkable' status at the specified location.
 // 'No walk', if off map.
 int16_t CRealm::GetHeightAndNoWalk(	// Returns height at new location.
-	int16_t sX,								// In:  X position to check on map.
-	int16_t	sZ,								// In:  Z position to check on map.
+	int32_t lX,								// In:  X position to check on map.
+	int32_t	lZ,								// In:  Z position to check on map.
 	bool* pbNoWalk)						// Out: true, if 'no walk'.
 	{
    int16_t	sRotX	= m_hood->GetRealmRotX();
 	// Scale the Z based on the view angle.
-   ::MapZ3DtoY2D(sZ, sZ, sRotX);
+   ::MapZ3DtoY2D(lZ, lZ, sRotX);
 
-	uint16_t	u16Attrib	= m_pTerrainMap->GetVal(sX, sZ, REALM_ATTR_NOT_WALKABLE);
+	uint16_t	u16Attrib	= m_pTerrainMap->GetVal(lX, lZ, REALM_ATTR_NOT_WALKABLE);
 
 	int16_t	sH = 4 * (u16Attrib & REALM_ATTR_HEIGHT_MASK); 
 
@@ -1615,62 +1777,62 @@ int16_t CRealm::GetHeightAndNoWalk(	// Returns height at new location.
 
 // Get the terrain attributes at an x/z position.
 // 'No walk', if off map.
-int16_t CRealm::GetTerrainAttributes(int16_t sX, int16_t sZ)
+int16_t CRealm::GetTerrainAttributes(int32_t lX, int32_t lZ)
 	{
 	// Scale the Z based on the view angle.
-   ::MapZ3DtoY2D(sZ, sZ, m_hood->GetRealmRotX());
+   ::MapZ3DtoY2D(lZ, lZ, m_hood->GetRealmRotX());
 
-	return m_pTerrainMap->GetVal(sX, sZ, REALM_ATTR_NOT_WALKABLE); 
+	return m_pTerrainMap->GetVal(lX, lZ, REALM_ATTR_NOT_WALKABLE); 
 	}
 
 // Get the floor attributes at an x/z position.
 // Zero, if off map.
-int16_t CRealm::GetFloorAttribute(int16_t sX, int16_t sZ)
+int16_t CRealm::GetFloorAttribute(int32_t lX, int32_t lZ)
 	{
 	// Scale the Z based on the view angle.
-   ::MapZ3DtoY2D(sZ, sZ, m_hood->GetRealmRotX());
+   ::MapZ3DtoY2D(lZ, lZ, m_hood->GetRealmRotX());
 
-	return m_pTerrainMap->GetVal(sX, sZ, 0) & REALM_ATTR_FLOOR_MASK; 
+	return m_pTerrainMap->GetVal(lX, lZ, 0) & REALM_ATTR_FLOOR_MASK; 
 	}
 
 // Get the floor value at an x/z position.
 // sMask, if off map.
-int16_t CRealm::GetFloorMapValue(int16_t sX, int16_t sZ, int16_t sMask/* = 0x007F*/)
+int16_t CRealm::GetFloorMapValue(int32_t lX, int32_t lZ, int16_t sMask/* = 0x007F*/)
 	{
 	// Scale the Z based on the view angle.
-   ::MapZ3DtoY2D(sZ, sZ, m_hood->GetRealmRotX());
+   ::MapZ3DtoY2D(lZ, lZ, m_hood->GetRealmRotX());
 
-	return m_pTerrainMap->GetVal(sX, sZ, sMask); 
+	return m_pTerrainMap->GetVal(lX, lZ, sMask); 
 	}
 
 // Get the all alpha and opaque layer bits at an x/z position.
 // Zero, if off map.
-int16_t CRealm::GetLayer(int16_t sX, int16_t sZ)
+int16_t CRealm::GetLayer(int32_t lX, int32_t lZ)
 	{
 	// Scale the Z based on the view angle.
-   ::MapZ3DtoY2D(sZ, sZ, m_hood->GetRealmRotX());
+   ::MapZ3DtoY2D(lZ, lZ, m_hood->GetRealmRotX());
 
-	return m_pLayerMap->GetVal(sX, sZ, 0) & REALM_ATTR_LAYER_MASK; 
+	return m_pLayerMap->GetVal(lX, lZ, 0) & REALM_ATTR_LAYER_MASK; 
 	}
 
 // Get effect attributes at an x/z position.
 // Zero, if off map.
-int16_t CRealm::GetEffectAttribute(int16_t sX, int16_t sZ)
+int16_t CRealm::GetEffectAttribute(int32_t lX, int32_t lZ)
 	{
 	// Scale the Z based on the view angle.
-   ::MapZ3DtoY2D(sZ, sZ, m_hood->GetRealmRotX());
+   ::MapZ3DtoY2D(lZ, lZ, m_hood->GetRealmRotX());
 
-	return m_pTerrainMap->GetVal(sX, sZ, 0) & REALM_ATTR_EFFECT_MASK; 
+	return m_pTerrainMap->GetVal(lX, lZ, 0) & REALM_ATTR_EFFECT_MASK; 
 	}
 
 // Get effect value at an x/z position.
 // Zero, if off map.
-int16_t CRealm::GetEffectMapValue(int16_t sX, int16_t sZ)
+int16_t CRealm::GetEffectMapValue(int32_t lX, int32_t lZ)
 	{
 	// Scale the Z based on the view angle.
-   ::MapZ3DtoY2D(sZ, sZ, m_hood->GetRealmRotX());
+   ::MapZ3DtoY2D(lZ, lZ, m_hood->GetRealmRotX());
 
-	return m_pTerrainMap->GetVal(sX, sZ, 0); 
+	return m_pTerrainMap->GetVal(lX, lZ, 0); 
 	}
 	
 ////////////////////////////////////////////////////////////////////////////////
@@ -376,6 +376,8 @@ class CSndRelay;
 #include "hood.h"
 #include "yatime.h"
 #include "smash.h"
+#include "flowfield.h"
+#include "crowd.h"
 #include "trigger.h"
 
 #include <newpix/managedpointer.h>
@@ -383,6 +385,9 @@ class CSndRelay;
 //#include <put/object.h>
 #include <newpix/halfobject.h>
 
+#include <cstring>
+#include <vector>
+
 
 // The overall "universe" in which a game takes place is represented by one or
 // more CRealm's.  A realm is basically a collection of objects plus a handfull
@@ -458,6 +463,13 @@ class CSndRelay;
 // The attribute map contains only the layer bits.
 #define REALM_ATTR_LAYER_MASK		0x7FFF
 
+// Size of the per-frame IsPathClear() cache.  Must be a power of 2.
+#define REALM_LOS_CACHE_SIZE		1024
+
+// Number of low bits dropped from the start point before it is used as a
+// cache key.  0 only shares exact repeats, so no decision can change.
+#define REALM_LOS_CACHE_QUANT_SHIFT	0
+
 extern uint64_t g_things_added;
 extern uint64_t g_things_removed;
 
@@ -474,7 +486,7 @@ class CRealm : public Object
 		enum
 			{
 			FileID = 0x44434241,									// File ID
-			FileVersion = 49,										// File version
+			FileVersion = 50,										// File version
 			Num2dPaths	= 3										// Number of 2D res paths
 			};
 
@@ -578,6 +590,31 @@ class CRealm : public Object
 			int16_t		sDifficulty;				// Difficulty level.
 			} Flags;
 
+		// Entry in the per-frame line of sight cache.  See IsPathClear().
+		typedef struct
+			{
+			int32_t	lX;							// Quantized start.
+			int32_t	lY;
+			int32_t	lZ;
+			int32_t	lDistanceXZ;				// Crawl parameters.
+			double	dCrawlRate;
+			int16_t	sRotY;
+			int16_t	sVerticalTolerance;
+			bool		bCheckExtents;
+			bool		bClear;						// Result.
+			int32_t	lEndX;						// Last clear point on path.
+			int32_t	lEndY;
+			int32_t	lEndZ;
+			uint32_t	ulFrame;						// Frame this entry is valid for.
+			} LOSCacheEntry;
+
+		// A think waiting for RunThinks().
+		typedef struct
+			{
+			uint32_t	ulPriority;					// Higher thinks first.
+			uint16_t	u16ID;						// Instance ID of the CDoofus.
+			} ThinkRequest;
+
 		// Callback called by various processes in Realm (such as Load and Save)
 		// to indicate current progress and allow a hook that can abort the process.
 		typedef bool (*ProgressCall)(			// Returns true to continue; false to
@@ -640,6 +677,31 @@ class CRealm : public Object
 		// CSmashitorium to be included in collision detection for this CRealm.
 		CSmashatorium	m_smashatorium;
 
+		// Line of sight cache for IsPathClear(), enabled by the LOSCache
+		// setting.  Terrain doesn't change within a frame, so entries stamped
+		// with an older frame are simply ignored; that is how it is cleared.
+		LOSCacheEntry	m_aLOSCache[REALM_LOS_CACHE_SIZE];
+		uint32_t			m_ulLOSFrame;		// Current frame stamp (never 0).
+		uint32_t			m_ulLOSQueries;		// IsPathClear() calls while enabled.
+		uint32_t			m_ulLOSHits;			// Calls answered by the cache.
+
+		// Flow fields toward each living dude, kept up to date by
+		// UpdateFlowFields() when the FlowFields setting is enabled.
+		CFlowFields		m_flowfields;
+
+		// Where the characters are, rebuilt every update by UpdateCrowd() when
+		// the CrowdAvoidance setting is enabled.
+		CCrowd			m_crowd;
+
+		// Thinks queued by CDoofus::RequestThink() when the ThinkBudget setting
+		// is non-zero.  RunThinks() runs the most urgent at the start of the
+		// next update until the budget is spent; the rest are put off and asked
+		// for again by their doofus.
+		std::vector<ThinkRequest> m_aThinkQueue;
+		uint32_t			m_ulThinks;				// Thinks run by RunThinks().
+		uint32_t			m_ulThinksDeferred;	// Thinks put off to a later update.
+		uint32_t			m_ulThinkOverruns;	// Updates whose thinks went over budget.
+
 		// Number of Suspend() calls that have occurred without corresponding 
 		// Resume() calls.
 		// If 0, we are not suspended.
@@ -799,6 +861,19 @@ private:
 
   void updated(void)
   {
+    // Start a new frame for the line of sight cache.
+    if (++m_ulLOSFrame == 0)
+    {
+      std::memset(m_aLOSCache, 0, sizeof(m_aLOSCache));
+      m_ulLOSFrame = 1;
+    }
+
+    RunThinks();
+
+    UpdateFlowFields();
+
+    UpdateCrowd();
+
     // Update the display timer
     m_lThisTime = m_time.GetGameTime();
     m_lElapsedTime = m_lThisTime - m_lPrevTime;
@@ -1023,32 +1098,32 @@ public:
       void EditModify(void);
 #endif // !defined(EDITOR_REMOVED)
 
-		int16_t GetHeight(int16_t sX, int16_t sZ);
+		int16_t GetHeight(int32_t lX, int32_t lZ);
 
 		int16_t GetHeightAndNoWalk(	// Returns height at new location.
-			int16_t sX,					// In:  X position to check on map.
-			int16_t	sZ,					// In:  Z position to check on map.
+			int32_t lX,					// In:  X position to check on map.
+			int32_t	lZ,					// In:  Z position to check on map.
 			bool* pbNoWalk);			// Out: true, if 'no walk'.
 
-		int16_t GetTerrainAttributes(int16_t sX, int16_t sZ);
+		int16_t GetTerrainAttributes(int32_t lX, int32_t lZ);
 
-		int16_t GetFloorAttribute(int16_t sX, int16_t sZ);
+		int16_t GetFloorAttribute(int32_t lX, int32_t lZ);
 
-      int16_t GetFloorMapValue(int16_t sX, int16_t sZ, int16_t sMask = 0x007F);
+      int16_t GetFloorMapValue(int32_t lX, int32_t lZ, int16_t sMask = 0x007F);
 
-		int16_t GetLayer(int16_t sX, int16_t sZ);
+		int16_t GetLayer(int32_t lX, int32_t lZ);
 
-		int16_t GetEffectAttribute(int16_t sX, int16_t sZ);
+		int16_t GetEffectAttribute(int32_t lX, int32_t lZ);
 
-		int16_t GetEffectMapValue(int16_t sX, int16_t sZ);
+		int16_t GetEffectMapValue(int32_t lX, int32_t lZ);
 			
 		// Determine if a path is clear of terrain.
 		bool IsPathClear(						// Returns true, if the entire path is clear.
 													// Returns false, if only a portion of the path is clear.
-													// (see *psX, *psY, *psZ).
-			int16_t sX,							// In:  Starting X.
-			int16_t	sY,							// In:  Starting Y.
-			int16_t sZ,							// In:  Starting Z.
+													// (see *plX, *plY, *plZ).
+			int32_t lX,							// In:  Starting X.
+			int32_t	lY,							// In:  Starting Y.
+			int32_t lZ,							// In:  Starting Z.
 			int16_t sRotY,						// In:  Rotation around y axis (direction on X/Z plane).
 			double dCrawlRate,				// In:  Rate at which to scan ('crawl') path in pixels per
 													// iteration.
@@ -1057,11 +1132,11 @@ public:
 													// at only one pixel.
 													// NOTE: We could change this to a speed in pixels per second
 													// where we'd assume a certain frame rate.
-			int16_t	sDistanceXZ,				// In:  Distance on X/Z plane.
+			int32_t	lDistanceXZ,				// In:  Distance on X/Z plane.
 			int16_t sVerticalTolerance = 0,	// In:  Max traverser can step up.
-			int16_t* psX = nullptr,				// Out: If not nullptr, last clear point on path.
-			int16_t* psY = nullptr,				// Out: If not nullptr, last clear point on path.
-			int16_t* psZ = nullptr,				// Out: If not nullptr, last clear point on path.
+			int32_t* plX = nullptr,				// Out: If not nullptr, last clear point on path.
+			int32_t* plY = nullptr,				// Out: If not nullptr, last clear point on path.
+			int32_t* plZ = nullptr,				// Out: If not nullptr, last clear point on path.
 			bool bCheckExtents = true);	// In:  If true, will consider the edge of the realm a path
 													// inhibitor.  If false, reaching the edge of the realm
 													// indicates a clear path.
@@ -1070,10 +1145,10 @@ public:
 		// Determine if a path is clear of terrain.
 		bool IsPathClear(						// Returns true, if the entire path is clear.
 													// Returns false, if only a portion of the path is clear.
-													// (see *psX, *psY, *psZ).
-			int16_t sX,							// In:  Starting X.
-			int16_t	sY,							// In:  Starting Y.
-			int16_t sZ,							// In:  Starting Z.
+													// (see *plX, *plY, *plZ).
+			int32_t lX,							// In:  Starting X.
+			int32_t	lY,							// In:  Starting Y.
+			int32_t lZ,							// In:  Starting Z.
 			double dCrawlRate,				// In:  Rate at which to scan ('crawl') path in pixels per
 													// iteration.
 													// NOTE: Values less than 1.0 are inefficient.
@@ -1081,12 +1156,12 @@ public:
 													// at only one pixel.
 													// NOTE: We could change this to a speed in pixels per second
 													// where we'd assume a certain frame rate.
-			int16_t	sDstX,						// In:  Destination X.
-			int16_t	sDstZ,						// In:  Destination Z.
+			int32_t	lDstX,						// In:  Destination X.
+			int32_t	lDstZ,						// In:  Destination Z.
 			int16_t sVerticalTolerance = 0,	// In:  Max traverser can step up.
-			int16_t* psX = nullptr,				// Out: If not nullptr, last clear point on path.
-			int16_t* psY = nullptr,				// Out: If not nullptr, last clear point on path.
-			int16_t* psZ = nullptr,				// Out: If not nullptr, last clear point on path.
+			int32_t* plX = nullptr,				// Out: If not nullptr, last clear point on path.
+			int32_t* plY = nullptr,				// Out: If not nullptr, last clear point on path.
+			int32_t* plZ = nullptr,				// Out: If not nullptr, last clear point on path.
 			bool bCheckExtents = true);	// In:  If true, will consider the edge of the realm a path
 													// inhibitor.  If false, reaching the edge of the realm
 													// indicates a clear path.
@@ -1149,19 +1224,19 @@ public:
          int16_t&	sHOut);		// Out.
 
 		// Get dimension of realm on X/Z plane.
-		int16_t GetRealmWidth(void)	// Returns width of realm's X/Z plane.
+		int32_t GetRealmWidth(void)	// Returns width of realm's X/Z plane.
 			{
-			int16_t	sRealmW;
-         MapY2DtoZ3D(m_hood->GetWidth(), sRealmW);
-			return sRealmW;
+			int32_t	lRealmW;
+         MapY2DtoZ3D(m_hood->GetWidth(), lRealmW);
+			return lRealmW;
 			}
 
 		// Get dimension of realm on X/Z plane.
-		int16_t GetRealmHeight(void)	// Returns height of realm's X/Z plane.
+		int32_t GetRealmHeight(void)	// Returns height of realm's X/Z plane.
 			{
-			int16_t	sRealmH;
-         MapY2DtoZ3D(m_hood->GetHeight(), sRealmH);
-			return sRealmH;
+			int32_t	lRealmH;
+         MapY2DtoZ3D(m_hood->GetHeight(), lRealmH);
+			return lRealmH;
 			}
 
 		// Makes a 2D path based on the current hood setting for 'Use top-view 2Ds'.
@@ -1176,6 +1251,47 @@ public:
 												// on the current hood settings.
 			const char* pszResName);	// In:  Resource name to prepend path to.
 
+		// Line of sight cache use since the realm was last cleared.
+		void GetLOSStats(
+			uint32_t* pulQueries,				// Out: IsPathClear() calls while enabled
+			uint32_t* pulHits) const			// Out: Calls answered by the cache
+			{
+			*pulQueries	= m_ulLOSQueries;
+			*pulHits		= m_ulLOSHits;
+			}
+
+		// Keep m_flowfields pointed at every living dude and advance their
+		// rebuilds.  Does nothing unless the FlowFields setting is enabled.
+		void UpdateFlowFields(void);
+
+		// Rebuild m_crowd.  Does nothing unless the CrowdAvoidance setting is
+		// enabled.
+		void UpdateCrowd(void);
+
+		// Queue a think for RunThinks().  The queue is emptied every update, so a
+		// doofus whose think was put off must ask again.
+		void RequestThink(
+			uint16_t u16ID,						// In:  Instance ID of the CDoofus
+			uint32_t ulPriority)					// In:  Higher thinks first
+			{
+			ThinkRequest request = { ulPriority, u16ID };
+			m_aThinkQueue.push_back(request);
+			}
+
+		// Run queued thinks, most urgent first, until the ThinkBudget is spent.
+		void RunThinks(void);
+
+		// How the think scheduler kept up since the realm was last cleared.
+		void GetThinkStats(
+			uint32_t* pulThinks,					// Out: Thinks run by RunThinks()
+			uint32_t* pulDeferred,				// Out: Thinks put off to a later update
+			uint32_t* pulOverruns) const		// Out: Updates whose thinks went over budget
+			{
+			*pulThinks		= m_ulThinks;
+			*pulDeferred	= m_ulThinksDeferred;
+			*pulOverruns	= m_ulThinkOverruns;
+			}
+
 	//---------------------------------------------------------------------------
 	// Protected (Internal) functions
 	//---------------------------------------------------------------------------
@@ -384,9 +384,9 @@ void CRocket::Update(void)
             dNewZ = position.z - SINQ[(int16_t)rotation.y] * (m_dHorizVel * dSeconds);
 
 				// Check for obstacles
-				sHeight = realm()->GetHeight(int16_t(dNewX), int16_t(dNewZ));
+				sHeight = realm()->GetHeight(int32_t(dNewX), int32_t(dNewZ));
 #ifdef UNUSED_VARIABLES
-            usAttrib = realm()->GetFloorAttribute((int16_t) dNewX, (int16_t) dNewZ);
+            usAttrib = realm()->GetFloorAttribute((int32_t) dNewX, (int32_t) dNewZ);
 #endif
 
 				// If the new position's height is too high, the new position is a ways
@@ -654,7 +654,7 @@ void CRocket::Render(void)
       m_sPriority = position.z;
 
 		// Layer should be based on info we get from the attribute map
-      m_sLayer = CRealm::GetLayerViaAttrib(realm()->GetLayer((int16_t) position.x, (int16_t) position.z));
+      m_sLayer = CRealm::GetLayerViaAttrib(realm()->GetLayer((int32_t) position.x, (int32_t) position.z));
 
       m_ptrans		= &m_trans;
 
@@ -322,9 +322,14 @@
 #include "game.h"
 #include "alphablitforpostal.h"
 #include "reality.h"
+#include "impostor.h"
 
 #include <newpix/3dmath.h>
 
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
 
 ////////////////////////////////////////////////////////////////////////////////
 // Macros/types/etc.
@@ -361,6 +366,33 @@ bool	g_bSceneDontBlit;
 const double	c_dMaxScale		= 10.0;
 const double	c_dMinScale		= 0.2;
 
+// Extra room around the bounds of sprites binned for culling.
+#define SCENE_CULL_MARGIN			32
+
+// Key of a culling bin.
+inline uint32_t SceneBinKey(int16_t sBinX, int16_t sBinY)
+	{
+	return (uint32_t(uint16_t(sBinX)) << 16) | uint16_t(sBinY);
+	}
+
+// Bins covered by bounds (end exclusive).
+inline void SceneBinRange(
+	int16_t sX0, int16_t sY0, int16_t sX1, int16_t sY1,
+	int16_t* psBinX0, int16_t* psBinY0, int16_t* psBinX1, int16_t* psBinY1)
+	{
+	*psBinX0	= sX0 >> SCENE_BIN_SHIFT;
+	*psBinY0	= sY0 >> SCENE_BIN_SHIFT;
+	*psBinX1	= MAX(*psBinX0, int16_t((sX1 - 1) >> SCENE_BIN_SHIFT));
+	*psBinY1	= MAX(*psBinY0, int16_t((sY1 - 1) >> SCENE_BIN_SHIFT));
+	}
+
+// Where a scene coord goes in the background cache's ring.
+inline int16_t SceneRingPos(int32_t lPos, int16_t sRingSize)
+	{
+	int32_t	lRingPos	= lPos % sRingSize;
+	return int16_t(lRingPos < 0 ? lRingPos + sRingSize : lRingPos);
+	}
+
 ////////////////////////////////////////////////////////////////////////////////
 // Variables/data
 ////////////////////////////////////////////////////////////////////////////////
@@ -375,6 +407,33 @@ CScene::CScene()
 	// No array of layers yet
 	m_pLayers = 0;
 	m_sNumLayers = 0;
+
+	m_lSpritesVisible = 0;
+	m_lSpritesCulled = 0;
+	m_ulNextSceneSeq = 0;
+	m_ulCullStamp = 0;
+	m_lNumJobs = 0;
+	m_ulBatch = 0;
+	m_ulBatchThreads = 0;
+	m_ulWorkersBusy = 0;
+	m_bWorkersQuit = false;
+	m_lNextJob = 0;
+	m_phoodBatch = nullptr;
+	m_sBatchDstX = 0;
+	m_sBatchDstY = 0;
+	m_prcBatchClip = nullptr;
+	m_pimpostors.reset(new CImpostorCache);
+	m_lTrees3DAhead = 0;
+	m_lRenderThreads = 1;
+	m_ul3DAheadMicroseconds = 0;
+	m_bgcache.sLayers = 0;
+	m_bgcache.sX = 0;
+	m_bgcache.sY = 0;
+	m_bgcache.phood = nullptr;
+	m_bgcache.ulStaticChanges = 0;
+	m_bgcache.u64Hidden = 0;
+	m_bgcache.sAlphaBlend = 0;
+	m_ulStaticChanges = 0;
 	
 	// This can fail, so I had wanted to put it in SetupPipeline(), but there's
 	// not much difference really since that function does not return an error
@@ -402,6 +461,7 @@ CScene::CScene()
 ////////////////////////////////////////////////////////////////////////////////
 CScene::~CScene()
 	{
+	StopRender3DWorkers();
 	Clear();
 	}
 
@@ -418,6 +478,9 @@ void CScene::Clear(void)
  	delete []m_pLayers;
  	m_pLayers = 0;
  	m_sNumLayers = 0;
+
+	// The things impostors were made of may be going away.
+	m_pimpostors->Reset();
 	}
 
 
@@ -442,13 +505,14 @@ void CScene::RemoveSprites(
 	Layer* pLayer = &(m_pLayers[sLayer]);
 
 	// Go through layer's collection of sprites
-	for (msetSprites::iterator i = pLayer->m_sprites.begin(); i != pLayer->m_sprites.end(); i++)
+	for (vecSprites::iterator i = pLayer->m_sprites.begin(); i != pLayer->m_sprites.end(); i++)
 		{
 		// Get pointer to sprite
 		CSprite* pSprite = *i;
 
 		// Clear inserted flag
       pSprite->m_InScene = false;
+		pSprite->m_bBinned = false;
 
 		// Delete sprite if delete-on-clear flag is set
       if (pSprite->flags.DeleteOnClear)
@@ -461,6 +525,11 @@ void CScene::RemoveSprites(
 #else
 	pLayer->m_sprites.erase(pLayer->m_sprites.begin(), pLayer->m_sprites.end());
 #endif
+	pLayer->m_bins.clear();
+	pLayer->m_unbinned.clear();
+
+	// The background cache may have drawn some of them.
+	m_ulStaticChanges++;
 	}
 
 
@@ -490,6 +559,13 @@ void CScene::UpdateSprite(
 	{
 	ASSERT(pSprite != nullptr);
 
+	// The background cache may have drawn it where it was.
+	if (pSprite->flags.Static)
+		m_ulStaticChanges++;
+
+	// Remember where it's binned for culling, if anywhere.
+	int16_t sBinnedLayer = pSprite->m_InScene ? pSprite->m_sSavedLayer : -1;
+
 	// Check if it's already in the scene
    if (pSprite->m_InScene)
 		{
@@ -497,32 +573,31 @@ void CScene::UpdateSprite(
 		if (pSprite->m_sLayer != pSprite->m_sSavedLayer)
 			{
 			// Erase from old layer
-			m_pLayers[pSprite->m_sSavedLayer].m_sprites.erase(pSprite->m_iter);
+			RemoveFromLayer(pSprite, pSprite->m_sSavedLayer);
 
-			// Add to specified layer and save iterator for fast access later on
+			// Add to specified layer
 			ASSERT(pSprite->m_sLayer < m_sNumLayers);
 			ASSERT(pSprite->m_sLayer >= 0);
-         pSprite->m_iter = m_pLayers[pSprite->m_sLayer].m_sprites.insert(pSprite);
+			AddToLayer(pSprite, pSprite->m_sLayer);
 			pSprite->m_sSavedLayer = pSprite->m_sLayer;
+			pSprite->m_sSavedPriority = pSprite->m_sPriority;
 			}
 
 		// Check if priority has changed
 		if (pSprite->m_sPriority != pSprite->m_sSavedPriority)
 			{
-			// For now, just erase it and then re-insert it.  There is definitely
-			// a faster way to do this, but since we'll likely be revamping the
-			// entire draw-order logic, I'll leave it like this.
-			m_pLayers[pSprite->m_sSavedLayer].m_sprites.erase(pSprite->m_iter);
-         pSprite->m_iter = m_pLayers[pSprite->m_sLayer].m_sprites.insert(pSprite);
+			// Layers aren't sorted, so this just puts it after the sprites
+			// already at its new priority, as re-inserting it used to.
+			pSprite->m_ulSceneSeq = m_ulNextSceneSeq++;
 			pSprite->m_sSavedPriority = pSprite->m_sPriority;
 			}
 		}
 	else
 		{
-		// Add to specified layer and save iterator for fast access later on
+		// Add to specified layer
 		ASSERT(pSprite->m_sLayer < m_sNumLayers);
 		ASSERT(pSprite->m_sLayer >= 0);
-      pSprite->m_iter = m_pLayers[pSprite->m_sLayer].m_sprites.insert(pSprite);
+		AddToLayer(pSprite, pSprite->m_sLayer);
  
 		// Save layer and priority so we can detect changes to them
 		pSprite->m_sSavedLayer = pSprite->m_sLayer;
@@ -531,6 +606,8 @@ void CScene::UpdateSprite(
 		// Set inserted flag
       pSprite->m_InScene = true;
 		}
+
+	BinSprite(pSprite, sBinnedLayer);
 	}
 
 
@@ -548,15 +625,263 @@ void CScene::RemoveSprite(
 	// such as when someone else has called Clear() or some similar function.
    if(pSprite->m_InScene)
 		{
-		// Erase sprite from layer.  Knowing the iterator makes this very fast.
+		// Erase sprite from layer.  Knowing the index makes this very fast.
 		ASSERT(pSprite->m_sSavedLayer < m_sNumLayers);
-		m_pLayers[pSprite->m_sSavedLayer].m_sprites.erase(pSprite->m_iter);
+		RemoveFromLayer(pSprite, pSprite->m_sSavedLayer);
+		UnbinSprite(pSprite, pSprite->m_sSavedLayer);
+
+		if (pSprite->flags.Static)
+			m_ulStaticChanges++;
 
 		// Clear inserted flag
       pSprite->m_InScene = false;
 		}
 	}
 
+
+////////////////////////////////////////////////////////////////////////////////
+// Get the scene area a sprite tree can draw to.
+////////////////////////////////////////////////////////////////////////////////
+bool CScene::GetTreeBounds(	// Returns false if the area can't be known.
+	CSprite*	pSprite,				// In:  Tree of sprites.
+	int16_t	sOffX,				// In:  Position of the tree's parent.
+	int16_t	sOffY,
+	int16_t*	psX0,					// In/Out: Bounds to grow.
+	int16_t*	psY0,
+	int16_t*	psX1,
+	int16_t*	psY1)
+	{
+	// Text is printed as far as it goes.
+	if (pSprite->m_pszText != nullptr)
+		return false;
+
+	int16_t	sX	= sOffX + pSprite->m_sX2;
+	int16_t	sY	= sOffY + pSprite->m_sY2;
+	int16_t	sX0, sY0, sX1, sY1;
+
+	switch (pSprite->m_type)
+		{
+		case CSprite::Standard2d:
+			{
+			CSprite2*	ps2	= pSprite->GetTyped<CSprite2>();
+			if (ps2->m_pImage == nullptr)
+				return false;
+
+			sX0	= sX;
+			sY0	= sY;
+			sX1	= sX + ps2->m_pImage->m_sWidth;
+			sY1	= sY + ps2->m_pImage->m_sHeight;
+			break;
+			}
+
+		case CSprite::Standard3d:
+			{
+			// Render3D() keeps the model within SCREEN_DIAMETER_FOR_3D of the
+			// hotspot, wherever its bounding sphere is centered.
+			int16_t	sReach	= int16_t(SCREEN_DIAMETER_FOR_3D) + SCENE_CULL_MARGIN;
+			sX0	= sX - sReach;
+			sY0	= sY - sReach;
+			sX1	= sX + sReach;
+			sY1	= sY + sReach;
+			break;
+			}
+
+		case CSprite::Line2d:
+			{
+			CSpriteLine2d*	psl2	= pSprite->GetTyped<CSpriteLine2d>();
+			int16_t	sEndX	= sOffX + psl2->m_sX2End;
+			int16_t	sEndY	= sOffY + psl2->m_sY2End;
+			sX0	= MIN(sX, sEndX);
+			sY0	= MIN(sY, sEndY);
+			sX1	= MAX(sX, sEndX) + 1;
+			sY1	= MAX(sY, sEndY) + 1;
+			break;
+			}
+
+		default:
+			// Cylinders are editor only.
+			return false;
+		}
+
+	*psX0	= MIN(*psX0, sX0);
+	*psY0	= MIN(*psY0, sY0);
+	*psX1	= MAX(*psX1, sX1);
+	*psY1	= MAX(*psY1, sY1);
+
+	// Children are drawn relative to this sprite.
+	for (CSprite* psprChild = pSprite->m_psprHeadChild; psprChild != nullptr; psprChild = psprChild->m_psprNext)
+		{
+		if (GetTreeBounds(psprChild, sX, sY, psX0, psY0, psX1, psY1) == false)
+			return false;
+		}
+
+	return true;
+	}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// Put a sprite in the culling bins of its layer.  Sprites that can't be binned
+// go on the layer's unbinned list and are drawn every time.
+////////////////////////////////////////////////////////////////////////////////
+void CScene::BinSprite(
+	CSprite*	pSprite,				// In:  Sprite in the scene.
+	int16_t	sOldLayer)			// In:  Layer it was binned in (-1 if none).
+	{
+	int16_t	sX0	= INT16_MAX;
+	int16_t	sY0	= INT16_MAX;
+	int16_t	sX1	= INT16_MIN;
+	int16_t	sY1	= INT16_MIN;
+	int16_t	sBinX0, sBinY0, sBinX1, sBinY1;
+
+	// Siblings of a top-level sprite are drawn with it and sprites that
+	// delete themselves must be drawn to go away, so neither are culled.
+	bool	bBinnable	=
+		pSprite->m_psprNext == nullptr &&
+		!pSprite->flags.DeleteOnRender &&
+		GetTreeBounds(pSprite, 0, 0, &sX0, &sY0, &sX1, &sY1);
+
+	if (bBinnable)
+		{
+		sX0	-= SCENE_CULL_MARGIN;
+		sY0	-= SCENE_CULL_MARGIN;
+		sX1	+= SCENE_CULL_MARGIN;
+		sY1	+= SCENE_CULL_MARGIN;
+		SceneBinRange(sX0, sY0, sX1, sY1, &sBinX0, &sBinY0, &sBinX1, &sBinY1);
+		if (int32_t(sBinX1 - sBinX0 + 1) * (sBinY1 - sBinY0 + 1) > SCENE_MAX_SPRITE_BINS)
+			bBinnable	= false;
+		}
+
+	// If it's staying in the same layer . . .
+	if (sOldLayer == pSprite->m_sLayer)
+		{
+		// If it's staying unbinned, there's nothing to do.
+		if (!bBinnable && !pSprite->m_bBinned)
+			return;
+
+		// If it's staying in the same bins, just note its new bounds.
+		if (bBinnable && pSprite->m_bBinned)
+			{
+			int16_t	sOldBinX0, sOldBinY0, sOldBinX1, sOldBinY1;
+			SceneBinRange(pSprite->m_sBoundX0, pSprite->m_sBoundY0, pSprite->m_sBoundX1, pSprite->m_sBoundY1,
+				&sOldBinX0, &sOldBinY0, &sOldBinX1, &sOldBinY1);
+			if (sOldBinX0 == sBinX0 && sOldBinY0 == sBinY0 && sOldBinX1 == sBinX1 && sOldBinY1 == sBinY1)
+				{
+				pSprite->m_sBoundX0	= sX0;
+				pSprite->m_sBoundY0	= sY0;
+				pSprite->m_sBoundX1	= sX1;
+				pSprite->m_sBoundY1	= sY1;
+				return;
+				}
+			}
+		}
+
+	if (sOldLayer >= 0)
+		UnbinSprite(pSprite, sOldLayer);
+
+	Layer*	pLayer	= &m_pLayers[pSprite->m_sLayer];
+	if (bBinnable)
+		{
+		pSprite->m_sBoundX0	= sX0;
+		pSprite->m_sBoundY0	= sY0;
+		pSprite->m_sBoundX1	= sX1;
+		pSprite->m_sBoundY1	= sY1;
+		for (int16_t sBinY = sBinY0; sBinY <= sBinY1; sBinY++)
+			{
+			for (int16_t sBinX = sBinX0; sBinX <= sBinX1; sBinX++)
+				pLayer->m_bins[SceneBinKey(sBinX, sBinY)].push_back(pSprite);
+			}
+		pSprite->m_bBinned	= true;
+		}
+	else
+		{
+		pLayer->m_unbinned.push_back(pSprite);
+		pSprite->m_bBinned	= false;
+		}
+	}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// Take a sprite out of its layer's culling bins (or unbinned list).
+////////////////////////////////////////////////////////////////////////////////
+void CScene::UnbinSprite(
+	CSprite*	pSprite,				// In:  Sprite in the scene.
+	int16_t	sLayer)				// In:  Layer it was binned in.
+	{
+	ASSERT(sLayer >= 0 && sLayer < m_sNumLayers);
+	Layer*	pLayer	= &m_pLayers[sLayer];
+
+	if (pSprite->m_bBinned)
+		{
+		int16_t	sBinX0, sBinY0, sBinX1, sBinY1;
+		SceneBinRange(pSprite->m_sBoundX0, pSprite->m_sBoundY0, pSprite->m_sBoundX1, pSprite->m_sBoundY1,
+			&sBinX0, &sBinY0, &sBinX1, &sBinY1);
+		for (int16_t sBinY = sBinY0; sBinY <= sBinY1; sBinY++)
+			{
+			for (int16_t sBinX = sBinX0; sBinX <= sBinX1; sBinX++)
+				{
+				auto	iBin	= pLayer->m_bins.find(SceneBinKey(sBinX, sBinY));
+				ASSERT(iBin != pLayer->m_bins.end());
+				if (iBin != pLayer->m_bins.end())
+					{
+					std::vector<CSprite*>&	vBin	= iBin->second;
+					auto	iSprite	= std::find(vBin.begin(), vBin.end(), pSprite);
+					if (iSprite != vBin.end())
+						{
+						*iSprite	= vBin.back();
+						vBin.pop_back();
+						}
+					if (vBin.empty())
+						pLayer->m_bins.erase(iBin);
+					}
+				}
+			}
+		pSprite->m_bBinned	= false;
+		}
+	else
+		{
+		auto	iSprite	= std::find(pLayer->m_unbinned.begin(), pLayer->m_unbinned.end(), pSprite);
+		if (iSprite != pLayer->m_unbinned.end())
+			{
+			*iSprite	= pLayer->m_unbinned.back();
+			pLayer->m_unbinned.pop_back();
+			}
+		}
+	}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// Add a sprite to the end of a layer's container.  It draws after the sprites
+// already in the layer at its priority.
+////////////////////////////////////////////////////////////////////////////////
+void CScene::AddToLayer(
+	CSprite*	pSprite,				// In:  Sprite to add.
+	int16_t	sLayer)				// In:  Layer to add it to.
+	{
+	vecSprites&	vSprites	= m_pLayers[sLayer].m_sprites;
+	pSprite->m_ulLayerIndex	= vSprites.size();
+	pSprite->m_ulSceneSeq	= m_ulNextSceneSeq++;
+	vSprites.push_back(pSprite);
+	}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// Take a sprite out of a layer's container by moving the last one into its
+// place.
+////////////////////////////////////////////////////////////////////////////////
+void CScene::RemoveFromLayer(
+	CSprite*	pSprite,				// In:  Sprite to remove.
+	int16_t	sLayer)				// In:  Layer it's in.
+	{
+	vecSprites&	vSprites	= m_pLayers[sLayer].m_sprites;
+	ASSERT(pSprite->m_ulLayerIndex < vSprites.size());
+	ASSERT(vSprites[pSprite->m_ulLayerIndex] == pSprite);
+
+	CSprite*	psprLast	= vSprites.back();
+	vSprites[pSprite->m_ulLayerIndex]	= psprLast;
+	psprLast->m_ulLayerIndex	= pSprite->m_ulLayerIndex;
+	vSprites.pop_back();
+	}
+
 ////////////////////////////////////////////////////////////////////////////////
 // Render a 3D sprite.
 //
@@ -625,8 +950,14 @@ CScene::Render3D(
 	int16_t			sDstY,			// Destination 2D y coord.
 	CSprite3*	ps3Cur,			// 3D sprite to render.
 	RAlpha*		plight,			// Light to render with.
-	RRect*		prcDstClip)		// Dst clip rect.
+	RRect*		prcDstClip,		// Dst clip rect.
+	RPipeLine*	ppipe,			// Pipeline to use (m_pipeline if nullptr).
+	Render3DJob* pjob)			// Job to record into instead of drawing into
+										// pimDst, if not nullptr.
 	{
+	if (ppipe == nullptr)
+		ppipe	= &m_pipeline;
+
 	// This transform is the product of the parent and the
 	// child's transform used to determine the position of
 	// a child object absolutely.
@@ -688,7 +1019,7 @@ CScene::Render3D(
 		ptransRender	= ps3Cur->m_ptrans;
 		}
 
-	// Here's the deal with m_pipeline. :
+	// Here's the deal with ppipe-> :
 	// X == Origin.
 	// @ == Center of sphere of points.
 	//	 ________________m_pimClipBuf________________
@@ -727,11 +1058,11 @@ CScene::Render3D(
    pt3dSrcCenter.setW(1.0);
 
 	// Let the pipeline know of the bounding sphere.
-	m_pipeline.BoundingSphereToScreen(pt3dSrcCenter, pt3dSrcRadius, *ptransRender);
+	ppipe->BoundingSphereToScreen(pt3dSrcCenter, pt3dSrcRadius, *ptransRender);
 
 	// Check screen location:
 	// Get radius of sphere of points (SphOP).
-	sDiameter	= MAX(m_pipeline.m_sW, m_pipeline.m_sH);
+	sDiameter	= MAX(ppipe->m_sW, ppipe->m_sH);
 	sRadius		= sDiameter / 2;
 
 // ****TEMP****
@@ -744,8 +1075,8 @@ if (g_bSceneDontBlit == false)
 	sCurY		= ps3Cur->m_sY2 + sDstY;
 
 	// Determine center of sphere of points relative to origin.
-	int16_t	sOrgRelCenX	= (m_pipeline.m_sCenX - (int16_t)(SCREEN_DIAMETER_FOR_3D / 2));
-	int16_t	sOrgRelCenY	= (m_pipeline.m_sCenY - (int16_t)(SCREEN_DIAMETER_FOR_3D / 2));
+	int16_t	sOrgRelCenX	= (ppipe->m_sCenX - (int16_t)(SCREEN_DIAMETER_FOR_3D / 2));
+	int16_t	sOrgRelCenY	= (ppipe->m_sCenY - (int16_t)(SCREEN_DIAMETER_FOR_3D / 2));
 	// Determine center of sphere of points on screen.
 	sCenterX		= sCurX + sOrgRelCenX;
 	sCenterY		= sCurY + sOrgRelCenY;
@@ -758,7 +1089,7 @@ if (g_bSceneDontBlit == false)
 	if (sClipLeft < sDiameter && sClipTop < sDiameter && sClipRight < sDiameter && sClipBottom < sDiameter)
 		{
 		// Transform pts through *ptransRender, view, and finally screen transforms.
-		m_pipeline.Transform(
+		ppipe->Transform(
 			ps3Cur->m_psop,		// Sea of 3D points to form
 										// mesh around.
 			*ptransRender);		// The transformation.
@@ -767,7 +1098,7 @@ if (g_bSceneDontBlit == false)
 		if (ps3Cur->m_psprParent == nullptr)
 			{
 			// Clear Z buffer for new 3D tree.
-			m_pipeline.m_pZB->Clear();
+			ppipe->m_pZB->Clear();
 			}
 
 		// Determine destination for sprite on screen.
@@ -783,7 +1114,7 @@ if (g_bSceneDontBlit == false)
 		// *** RESTORING DO NON-ADJUSTMENT! ***
 		// re-attempting center adjustment level
 		int16_t sLightOffset = 0;	// Must be initialized here (the other assignments are +=).
-		//	- (m_pipeline.m_sCenZ + m_pipeline.m_sZ); 
+		//	- (ppipe->m_sCenZ + ppipe->m_sZ); 
 
 		// If no parent . . .
 		if (ps3Cur->m_psprParent == nullptr)
@@ -798,7 +1129,7 @@ if (g_bSceneDontBlit == false)
 			// up and to the left.
 			sDirectRenderX		= sCenterX - (int16_t)(SCREEN_DIAMETER_FOR_3D / 2);
 			sDirectRenderY		= sCenterY - (int16_t)(SCREEN_DIAMETER_FOR_3D / 2);
-			sDirectRenderZ		= m_pipeline.m_sCenZ; // don't need to know
+			sDirectRenderZ		= ppipe->m_sCenZ; // don't need to know
 			// Offset by the center relative to the origin.
 			sRenderOffX			= -sOrgRelCenX;
 			sRenderOffY			= -sOrgRelCenY;
@@ -841,9 +1172,9 @@ if (g_bSceneDontBlit == false)
 		// If only partially on screen . . .
 		if (sClipLeft > 0 || sClipTop > 0 || sClipRight > 0 || sClipBottom > 0)
 			{
-			ASSERT(m_pipeline.m_pimClipBuf != nullptr);
+			ASSERT(ppipe->m_pimClipBuf != nullptr);
 			// Use clip image.
-			pimRender			= m_pipeline.m_pimClipBuf;
+			pimRender			= ppipe->m_pimClipBuf;
 			// Remember to blit to composite.
 			bIndirectRender	= true;
 			// Use appropriate position.
@@ -861,30 +1192,60 @@ if (g_bSceneDontBlit == false)
 			sRenderY				= sDirectRenderY;
 			}
 
+		// If recording into a job, render into the clip buffer either way.  What
+		// a direct Render() would have written is told by the Z buffer.  Outside
+		// its dirty area the Z buffer still holds its clear value, so only that
+		// area needs saving.
+		RRect	rcZBefore(0, 0, 0, 0);
+		if (pjob != nullptr)
+			{
+			ASSERT(sIndirectRenderX == 0 && sIndirectRenderY == 0);
+			pimRender	= ppipe->m_pimClipBuf;
+			sRenderX		= sIndirectRenderX;
+			sRenderY		= sIndirectRenderY;
+			if (bIndirectRender == false)
+				{
+				RZBuffer*	pzb	= ppipe->m_pZB;
+				pjob->asZBefore.clear();
+				if (pzb->m_sDirtyX1 < pzb->m_sDirtyX2)
+					{
+					rcZBefore.sX	= pzb->m_sDirtyX1;
+					rcZBefore.sY	= pzb->m_sDirtyY1;
+					rcZBefore.sW	= pzb->m_sDirtyX2 - pzb->m_sDirtyX1;
+					rcZBefore.sH	= pzb->m_sDirtyY2 - pzb->m_sDirtyY1;
+					for (int16_t sY = 0; sY < rcZBefore.sH; sY++)
+						{
+						int16_t*	psRow	= pzb->GetZPtr(rcZBefore.sX, rcZBefore.sY + sY);
+						pjob->asZBefore.insert(pjob->asZBefore.end(), psRow, psRow + rcZBefore.sW);
+						}
+					}
+				}
+			}
+
 		// use either the current z center or parent to adjust:
 		// Note that we've already offset this by the parent and that is why
 		// we do a += (see above (search for sLightOffset) ).
 		sLightOffset += ps3Cur->m_sBrightness + gsGlobalLightingAdjustment - sDirectRenderZ;
 
 		// Make sure we don't overrun the Z buffer . . .
-		// Note that m_pipeline.m_sCen? are in image coords (i.e., (0, 0) is
+		// Note that ppipe->m_sCen? are in image coords (i.e., (0, 0) is
 		// the upper, left hand corner and (SCREEN_DIAMETER_FOR_3D, 
 		// SCREEN_DIAMETER_FOR_3D) is the lower, right hand corner).
-		if (	m_pipeline.m_sCenX - sRadius >= -sRenderOffX
-			&&	m_pipeline.m_sCenX + sRadius < SCREEN_DIAMETER_FOR_3D - sRenderOffX
-			&&	m_pipeline.m_sCenY - sRadius >= -sRenderOffY
-			&&	m_pipeline.m_sCenY + sRadius < SCREEN_DIAMETER_FOR_3D - sRenderOffY)
+		if (	ppipe->m_sCenX - sRadius >= -sRenderOffX
+			&&	ppipe->m_sCenX + sRadius < SCREEN_DIAMETER_FOR_3D - sRenderOffX
+			&&	ppipe->m_sCenY - sRadius >= -sRenderOffY
+			&&	ppipe->m_sCenY + sRadius < SCREEN_DIAMETER_FOR_3D - sRenderOffY)
 			{
 			// If fog enabled . . .
 			if (g_GameSettings.m_s3dFog != FALSE)
 				{
 				// Render with textures and fog.
-				m_pipeline.Render(
+				ppipe->Render(
 					pimRender,						// Dst image.
 					sRenderX,						// 2D Dst coord.
 					sRenderY,						// 2D Dst coord.
 					ps3Cur->m_pmesh,				// Src mesh.
-					m_pipeline.m_pZB,				// Z buffer (use its own for now).
+					ppipe->m_pZB,				// Z buffer (use its own for now).
 					ps3Cur->m_ptex,				// Textures.
 					sLightOffset,					// Fog offset.  Fogool?
 					plight,							// Ambient lighting schtuff.
@@ -894,35 +1255,110 @@ if (g_bSceneDontBlit == false)
 			else
 				{
 				// Render with textures, no fog.
-				m_pipeline.Render(
+				ppipe->Render(
 					pimRender,						// Dst image.
 					sRenderX,						// 2D Dst coord.
 					sRenderY,						// 2D Dst coord.
 					ps3Cur->m_pmesh,				// Src mesh.
-					m_pipeline.m_pZB,				// Z buffer (use its own for now).
+					ppipe->m_pZB,				// Z buffer (use its own for now).
 					ps3Cur->m_ptex,				// Textures.
 					sRenderOffX,					// Offset render/z-buffer to center of sphere of points.
 					sRenderOffY);					// Offset render/z-buffer to center of sphere of points.
 				}
 
+			// If recording into a job . . .
+			if (pjob != nullptr)
+				{
+				Render3DPiece	piece;
+				piece.bBlitT	= bIndirectRender;
+				piece.lOffset	= pjob->au8Pixels.size();
+				piece.ps3		= ps3Cur;
+				piece.sCenterX	= sCenterX;
+				piece.sCenterY	= sCenterY;
+				piece.sDiameter	= sDiameter;
+				piece.sBlitW	= ppipe->m_sW;
+				piece.sBlitH	= ppipe->m_sH;
+				RImage*	pimClip	= ppipe->m_pimClipBuf;
+				if (bIndirectRender == true)
+					{
+					// The area the rspBlitT() below would take, with any of it off
+					// the clip buffer left transparent.
+					int16_t	sSrcX	= ppipe->m_sCenX - sRadius + sRenderOffX;
+					int16_t	sSrcY	= ppipe->m_sCenY - sRadius + sRenderOffY;
+					piece.sDstX	= sBlitX;
+					piece.sDstY	= sBlitY;
+					piece.sW		= ppipe->m_sW;
+					piece.sH		= ppipe->m_sH;
+					pjob->au8Pixels.resize(piece.lOffset + size_t(piece.sW) * piece.sH, 0);
+					pjob->au8Written.resize(pjob->au8Pixels.size(), 0);
+					for (int16_t sY = 0; sY < piece.sH; sY++)
+						{
+						int16_t	sClipY	= sSrcY + sY;
+						if (sClipY < 0 || sClipY >= pimClip->m_sHeight)
+							continue;
+						for (int16_t sX = 0; sX < piece.sW; sX++)
+							{
+							int16_t	sClipX	= sSrcX + sX;
+							if (sClipX >= 0 && sClipX < pimClip->m_sWidth)
+								pjob->au8Pixels[piece.lOffset + size_t(sY) * piece.sW + sX]	= pimClip->m_pData[sClipY * pimClip->m_lPitch + sClipX];
+							}
+						}
+					}
+				else
+					{
+					// Everything that passed the Z test, where a direct Render() would
+					// have put it.  Only the Z buffer's dirty area can have changed.
+					RZBuffer*	pzb	= ppipe->m_pZB;
+					int16_t	sX1	= pzb->m_sDirtyX1;
+					int16_t	sY1	= pzb->m_sDirtyY1;
+					int16_t	sX2	= MIN(pzb->m_sDirtyX2, pimClip->m_sWidth);
+					int16_t	sY2	= MIN(pzb->m_sDirtyY2, pimClip->m_sHeight);
+					piece.sDstX	= sDirectRenderX + sX1;
+					piece.sDstY	= sDirectRenderY + sY1;
+					piece.sW		= MAX(int16_t(sX2 - sX1), int16_t(0));
+					piece.sH		= MAX(int16_t(sY2 - sY1), int16_t(0));
+					pjob->au8Pixels.resize(piece.lOffset + size_t(piece.sW) * piece.sH, 0);
+					pjob->au8Written.resize(pjob->au8Pixels.size(), 0);
+					for (int16_t sY = sY1; sY < sY2; sY++)
+						{
+						const int16_t*	psZ	= pzb->GetZPtr(0, sY);
+						bool	bSaved	= (sY >= rcZBefore.sY && sY < rcZBefore.sY + rcZBefore.sH);
+						for (int16_t sX = sX1; sX < sX2; sX++)
+							{
+							int16_t	sZBefore	= pzb->m_sClearVal;
+							if (bSaved && sX >= rcZBefore.sX && sX < rcZBefore.sX + rcZBefore.sW)
+								sZBefore	= pjob->asZBefore[size_t(sY - rcZBefore.sY) * rcZBefore.sW + (sX - rcZBefore.sX)];
+							if (psZ[sX] != sZBefore)
+								{
+								size_t	lPixel	= piece.lOffset + size_t(sY - sY1) * piece.sW + (sX - sX1);
+								pjob->au8Pixels[lPixel]		= pimClip->m_pData[sY * pimClip->m_lPitch + sX];
+								pjob->au8Written[lPixel]	= 1;
+								}
+							}
+						}
+					}
+
+				pjob->aPieces.push_back(piece);
+				ppipe->ClearClipBuffer();
+				}
 			// If we rendered into an intermediate buffer b/c of clipping . . .
-			if (bIndirectRender == true)
+			else if (bIndirectRender == true)
 				{
 				// Get it into destination.
 				rspBlitT(
 					0,																// Transparent index.
 					pimRender,													// Src.
 					pimDst,														// Dst.
-					m_pipeline.m_sCenX - sRadius + sRenderOffX,	// Src.
-					m_pipeline.m_sCenY - sRadius + sRenderOffY,	// Src.
+					ppipe->m_sCenX - sRadius + sRenderOffX,	// Src.
+					ppipe->m_sCenY - sRadius + sRenderOffY,	// Src.
 					sBlitX,														// Dst.
 					sBlitY,														// Dst.
-					m_pipeline.m_sW,											// Both.
-					m_pipeline.m_sH,											// Both.
+					ppipe->m_sW,											// Both.
+					ppipe->m_sH,											// Both.
 					prcDstClip,													// Dst.
 					nullptr);														// Src.
 
-				m_pipeline.ClearClipBuffer();
+				ppipe->ClearClipBuffer();
 				}
 			else
 				{
@@ -982,8 +1418,8 @@ if (g_bSceneDontBlit == false)
 			rspRect(1, RSP_WHITE_INDEX, pimDst, 
             sCenterX - (int16_t)(SCREEN_DIAMETER_FOR_3D / 2),
             sCenterY - (int16_t)(SCREEN_DIAMETER_FOR_3D / 2),
-				m_pipeline.m_pimClipBuf->m_sWidth, 
-				m_pipeline.m_pimClipBuf->m_sHeight,
+				ppipe->m_pimClipBuf->m_sWidth, 
+				ppipe->m_pimClipBuf->m_sHeight,
 				prcDstClip);
 
 			// Note whether clipping.
@@ -996,10 +1432,10 @@ if (g_bSceneDontBlit == false)
 		else
 			{
         /*
-        ASSERT(m_pipeline.m_sCenX - sRadius >= -sRenderOffX);
-        ASSERT(m_pipeline.m_sCenX + sRadius < SCREEN_DIAMETER_FOR_3D - sRenderOffX);
-        ASSERT(m_pipeline.m_sCenY - sRadius >= -sRenderOffY);
-        ASSERT(m_pipeline.m_sCenY + sRadius < SCREEN_DIAMETER_FOR_3D - sRenderOffY);
+        ASSERT(ppipe->m_sCenX - sRadius >= -sRenderOffX);
+        ASSERT(ppipe->m_sCenX + sRadius < SCREEN_DIAMETER_FOR_3D - sRenderOffX);
+        ASSERT(ppipe->m_sCenY - sRadius >= -sRenderOffY);
+        ASSERT(ppipe->m_sCenY + sRadius < SCREEN_DIAMETER_FOR_3D - sRenderOffY);
 */
 			char	szMsg[1024];
 #if defined (RELEASE)
@@ -1040,8 +1476,8 @@ if (g_bSceneDontBlit == false)
 // ****END TEMP****
 
 	// Store this location (it is used by Render() to do collision circle for XRay).
-	ps3Cur->m_sCenX	= ps3Cur->m_sX2 + m_pipeline.m_sCenX - (int16_t)(SCREEN_DIAMETER_FOR_3D / 2);
-	ps3Cur->m_sCenY	= ps3Cur->m_sY2 + m_pipeline.m_sCenY - (int16_t)(SCREEN_DIAMETER_FOR_3D / 2);
+	ps3Cur->m_sCenX	= ps3Cur->m_sX2 + ppipe->m_sCenX - (int16_t)(SCREEN_DIAMETER_FOR_3D / 2);
+	ps3Cur->m_sCenY	= ps3Cur->m_sY2 + ppipe->m_sCenY - (int16_t)(SCREEN_DIAMETER_FOR_3D / 2);
 	ps3Cur->m_sRadius	= sRadius;
 	}
 
@@ -1514,7 +1950,7 @@ void CScene::Render(			// Returns nothing.
 						pimDst,					// Destination image.
 						sDstX,					// Destination 2D x coord.
 						sDstY,					// Destination 2D y coord.
-                  dynamic_cast<CSprite2*>(pSprite),	// Tree of sprites to render.
+                  pSprite->GetTyped<CSprite2>(),	// Tree of sprites to render.
 						phood,					// Da hood, homey.
 						prcDstClip,				// Dst clip rect.
 						psprXRayee);			// XRayee, if not nullptr.
@@ -1530,7 +1966,7 @@ void CScene::Render(			// Returns nothing.
 						pimDst,					// Destination image.
 						sDstX,					// Destination 2D x coord.
 						sDstY,					// Destination 2D y coord.
-                  dynamic_cast<CSprite3*>(pSprite),	// Tree of 3D sprites to render.
+                  pSprite->GetTyped<CSprite3>(),	// Tree of 3D sprites to render.
 						phood,					// Da hood, homey.
 						prcDstClip);			// Dst clip rect.
 
@@ -1546,7 +1982,7 @@ void CScene::Render(			// Returns nothing.
 						pimDst,							// Destination image.
 						sDstX,							// Destination 2D x coord.
 						sDstY,							// Destination 2D y coord.
-                  dynamic_cast<CSpriteLine2d*>(pSprite),	// Tree of sprites to render.
+                  pSprite->GetTyped<CSpriteLine2d>(),	// Tree of sprites to render.
 						prcDstClip);					// Dst clip rect.
 
 		// ****TEMP****
@@ -1566,7 +2002,7 @@ void CScene::Render(			// Returns nothing.
 						pimDst,								// Destination image.
 						sDstX,								// Destination 2D x coord.
 						sDstY,								// Destination 2D y coord.
-                  dynamic_cast<CSpriteCylinder3d*>(pSprite),	// Cylinder sprite.
+                  pSprite->GetTyped<CSpriteCylinder3d>(),	// Cylinder sprite.
 						phood,								// Da hood, homey.
 						prcDstClip);						// Dst clip rect.
 
@@ -1660,6 +2096,19 @@ void CScene::Render(
 
 	CSprite*	psprXRayee	= nullptr;	// XRayee when not nullptr.
 
+	bool	bCull	= (g_GameSettings.m_sSceneCulling != FALSE);
+	int16_t	sBinX0, sBinY0, sBinX1, sBinY1;
+	if (bCull)
+		{
+		// New stamp so each sprite is collected once however many bins it's in.
+		m_ulCullStamp++;
+		SceneBinRange(sSrcX, sSrcY, sSrcX + sW, sSrcY + sH, &sBinX0, &sBinY0, &sBinX1, &sBinY1);
+		}
+
+	m_lSpritesVisible	= 0;
+	m_lSpritesCulled	= 0;
+	m_aCmds.clear();
+
 	// Go through all the layers, back to front
 	for (int16_t sLayer = 0; sLayer < m_sNumLayers; sLayer++)
 		{
@@ -1669,46 +2118,645 @@ void CScene::Render(
 		// Make sure layer isn't hidden (if it is, skip it)
 		if (!(pLayer->m_bHidden))
 			{
+			size_t	sizeBefore	= m_aCmds.size();
+			if (bCull)
+				{
+				// Collect the sprites in the bins this area covers that overlap it,
+				// and those that can't be binned.
+				for (int16_t sBinY = sBinY0; sBinY <= sBinY1; sBinY++)
+					{
+					for (int16_t sBinX = sBinX0; sBinX <= sBinX1; sBinX++)
+						{
+						auto	iBin	= pLayer->m_bins.find(SceneBinKey(sBinX, sBinY));
+						if (iBin == pLayer->m_bins.end())
+							continue;
+
+						for (CSprite* pSprite : iBin->second)
+							{
+							if (pSprite->m_ulCullStamp != m_ulCullStamp)
+								{
+								pSprite->m_ulCullStamp	= m_ulCullStamp;
+								if (pSprite->m_sBoundX0 < sSrcX + sW && pSprite->m_sBoundX1 > sSrcX &&
+									 pSprite->m_sBoundY0 < sSrcY + sH && pSprite->m_sBoundY1 > sSrcY)
+									AddRenderCmd(pSprite, sLayer);
+								}
+							}
+						}
+					}
+
+				for (CSprite* pSprite : pLayer->m_unbinned)
+					AddRenderCmd(pSprite, sLayer);
+				}
+			else
+				{
+				for (CSprite* pSprite : pLayer->m_sprites)
+					AddRenderCmd(pSprite, sLayer);
+				}
+
+			m_lSpritesVisible	+= m_aCmds.size() - sizeBefore;
+			m_lSpritesCulled	+= pLayer->m_sprites.size() - (m_aCmds.size() - sizeBefore);
+			}
+		}
+
+	// Into drawing order: layers back to front, then by priority.
+	SortRenderCmds();
+
+	// The static layers at the back can come from the background cache.
+	size_t	lFirstCmd	= 0;
+	if (g_GameSettings.m_sBackgroundCache != FALSE && g_bSceneDontBlit == false)
+		lFirstCmd	= RenderBackground(sSrcX, sSrcY, sW, sH, pimDst, sDstX, sDstY, &rDstClip, phood);
+
+	// Impostors take the place of rasterizing 3D trees ahead.
+	bool	bImpostors	= (g_GameSettings.m_sImpostorCacheMB > 0 && g_bSceneDontBlit == false);
+	if (bImpostors)
+		{
+		m_lNumJobs	= 0;
+		m_pimpostors->Trim(size_t(g_GameSettings.m_sImpostorCacheMB) << 20, uint32_t(MAX(g_GameSettings.m_sImpostorMaxAge, int16_t(0))));
+		}
+	else
+		{
+		// Get the 3D going on other threads, if that's wanted.
+		Render3DJobs(&(*phood), -sMapX, -sMapY, &rDstClip);
+		}
+	size_t	lNextJob	= 0;
+
+	// Go through all the sprites to draw
+	for (size_t i = lFirstCmd; i < m_aCmds.size(); i++)
+		{
+		CSprite* pSprite = m_aCmds[i].pSprite;
+
+		// If this tree was rasterized ahead . . .
+		if (lNextJob < m_lNumJobs && m_aJobs[lNextJob].pTree == pSprite)
+			{
+			DrawRender3DJob(pimDst, &m_aJobs[lNextJob], &rDstClip);
+			lNextJob++;
+			}
+		else if (bImpostors && pSprite->m_type == CSprite::Standard3d && pSprite->m_psprNext == nullptr && IsTree3D(pSprite))
+			{
+			RenderImpostor(pimDst, -sMapX, -sMapY, pSprite, &(*phood), &rDstClip);
+			}
+		else
+			{
+			Render(				// Returns nothing.
+				pimDst,			// Destination image.
+				-sMapX,			// Destination 2D x coord.
+				-sMapY,			// Destination 2D y coord.
+				pSprite,			// Tree of sprites to render.
+				phood,			// Da hood, homey.
+				&rDstClip,		// Dst clip rect.
+				psprXRayee);	// XRayee, if not nullptr.
+			}
+
+		// If this sprite wanted to be deleted after use . . .
+      if (pSprite->flags.DeleteOnRender)
+			{
+			RemoveSprite(pSprite);
+			// Be gone, vile weed.
+			delete pSprite;
+			}
+		else
+			{
+			// If this sprite is an xrayee, add it to the container
+         if (pSprite->flags.Xrayee)
+				{
+				psprXRayee	= pSprite;
+				}
+			}
+		}
+	}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// Add a sprite to m_aCmds.
+////////////////////////////////////////////////////////////////////////////////
+void CScene::AddRenderCmd(
+	CSprite*	pSprite,				// In:  Sprite to draw.
+	int16_t	sLayer)				// In:  Layer it's in.
+	{
+	RenderCmd	cmd;
+	// Flip the sign bit of the priority so it sorts unsigned.
+	cmd.u64Key	= (uint64_t(uint16_t(sLayer)) << 48) |
+		(uint64_t(uint16_t(pSprite->m_sSavedPriority) ^ 0x8000) << 32) |
+		pSprite->m_ulSceneSeq;
+	cmd.pSprite	= pSprite;
+	m_aCmds.push_back(cmd);
+	}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// true if a sprite tree is all 3D sprites.  Hidden sprites aren't drawn, so
+// anything goes under them.
+////////////////////////////////////////////////////////////////////////////////
+bool CScene::IsTree3D(
+	CSprite*	pSprite)				// In:  Tree of sprites.
+	{
+	for (; pSprite != nullptr; pSprite = pSprite->m_psprNext)
+		{
+		if (pSprite->flags.Hidden)
+			continue;
+
+		if (pSprite->m_type != CSprite::Standard3d || pSprite->m_pszText != nullptr)
+			return false;
+
+		if (IsTree3D(pSprite->m_psprHeadChild) == false)
+			return false;
+		}
+
+	return true;
+	}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// Rasterize the all-3D trees in m_aCmds ahead into m_aJobs.  Each thread has
+// its own pipeline, so its own point scratch, Z buffer and clip buffer, and
+// each tree is done by one thread as Render() would do it.  Render() puts the
+// results in the destination in drawing order, so the image is the same as
+// drawing everything on one thread.
+////////////////////////////////////////////////////////////////////////////////
+void CScene::Render3DJobs(
+	CHood*	phood,				// In:  Da hood.
+	int16_t	sDstX,				// In:  Destination 2D x coord of trees.
+	int16_t	sDstY,				// In:  Destination 2D y coord of trees.
+	RRect*	prcDstClip)			// In:  Dst clip rect.
+	{
+	m_lNumJobs	= 0;
+	m_lTrees3DAhead	= 0;
+	m_lRenderThreads	= 1;
+	m_ul3DAheadMicroseconds	= 0;
+
+	uint32_t	ulNumThreads	= MIN(int32_t(g_GameSettings.m_sRenderThreads), SCENE_MAX_RENDER_THREADS);
+	if (ulNumThreads < 2 || g_bSceneDontBlit == true)
+		return;
+
+	for (size_t i = 0; i < m_aCmds.size(); i++)
+		{
+		CSprite*	pSprite	= m_aCmds[i].pSprite;
+		if (pSprite->m_type == CSprite::Standard3d && IsTree3D(pSprite))
+			{
+			if (m_lNumJobs == m_aJobs.size())
+				m_aJobs.emplace_back();
+			Render3DJob*	pjob	= &m_aJobs[m_lNumJobs++];
+			pjob->pTree	= pSprite;
+			pjob->aPieces.clear();
+			pjob->au8Pixels.clear();
+			pjob->au8Written.clear();
+			}
+		}
+
+	// Not worth it for a few.
+	if (m_lNumJobs < SCENE_PARALLEL_MIN_TREES)
+		{
+		m_lNumJobs	= 0;
+		return;
+		}
+
+	microseconds_t	ulStartTime	= rspGetAppMicroseconds();
+
+	ulNumThreads	= MIN(ulNumThreads, uint32_t(m_lNumJobs));
+	while (m_apipeWorkers.size() < ulNumThreads)
+		m_apipeWorkers.emplace_back(new RPipeLine);
+
+	// The helpers are kept from one Render() to the next.  Start any more
+	// this batch needs.
+	while (m_athreadWorkers.size() + 1 < ulNumThreads)
+		m_athreadWorkers.emplace_back(&CScene::Render3DWorker, this, uint32_t(m_athreadWorkers.size() + 1), m_ulBatch);
+
+	m_phoodBatch		= phood;
+	m_sBatchDstX		= sDstX;
+	m_sBatchDstY		= sDstY;
+	m_prcBatchClip		= prcDstClip;
+	m_lNextJob			= 0;
+		{
+		std::lock_guard<std::mutex>	lock(m_mutexWorkers);
+		m_ulBatchThreads	= ulNumThreads;
+		m_ulWorkersBusy	= ulNumThreads - 1;
+		m_ulBatch++;
+		}
+	m_cvWork.notify_all();
+
+	Render3DBatch(m_apipeWorkers[0].get());
+
+		{
+		std::unique_lock<std::mutex>	lock(m_mutexWorkers);
+		m_cvDone.wait(lock, [this] { return m_ulWorkersBusy == 0; });
+		}
+
+	m_lTrees3DAhead	= int32_t(m_lNumJobs);
+	m_lRenderThreads	= int32_t(ulNumThreads);
+	m_ul3DAheadMicroseconds	= uint32_t(rspGetAppMicroseconds() - ulStartTime);
+	}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// Rasterize jobs of the current batch on a pipeline until there are none left.
+////////////////////////////////////////////////////////////////////////////////
+void CScene::Render3DBatch(
+	RPipeLine*	ppipe)			// In:  Pipeline to use.
+	{
+	// Same view as the scene's pipeline.  The buffers may be bigger.
+	ppipe->m_tView		= m_pipeline.m_tView;
+	ppipe->m_tScreen	= m_pipeline.m_tScreen;
+	ppipe->Create(1000, SCREEN_DIAMETER_FOR_3D);
+	ppipe->ClearClipBuffer();
+
+	for (size_t i = m_lNextJob++; i < m_lNumJobs; i = m_lNextJob++)
+		Render3DTree(ppipe, &m_aJobs[i], m_sBatchDstX, m_sBatchDstY, m_aJobs[i].pTree, m_phoodBatch, m_prcBatchClip);
+	}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// A helper thread of Render3DJobs().  It sleeps until a new batch is posted,
+// helps with it if it is one of the threads the batch wants, and goes back
+// to sleep, until told to quit.
+////////////////////////////////////////////////////////////////////////////////
+void CScene::Render3DWorker(
+	uint32_t	ulIndex,				// In:  Which helper (1 and up).
+	uint32_t	ulBatch)				// In:  Last batch posted before it started.
+	{
+	std::unique_lock<std::mutex>	lock(m_mutexWorkers);
+	for (;;)
+		{
+		m_cvWork.wait(lock, [&] { return m_bWorkersQuit || m_ulBatch != ulBatch; });
+		if (m_bWorkersQuit)
+			break;
+
+		ulBatch	= m_ulBatch;
+		if (ulIndex >= m_ulBatchThreads)
+			continue;
+
+		lock.unlock();
+		Render3DBatch(m_apipeWorkers[ulIndex].get());
+		lock.lock();
+
+		if (--m_ulWorkersBusy == 0)
+			m_cvDone.notify_one();
+		}
+	}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// Stop the helper threads of Render3DJobs().
+////////////////////////////////////////////////////////////////////////////////
+void CScene::StopRender3DWorkers(void)
+	{
+		{
+		std::lock_guard<std::mutex>	lock(m_mutexWorkers);
+		m_bWorkersQuit	= true;
+		}
+	m_cvWork.notify_all();
+
+	for (std::thread& worker : m_athreadWorkers)
+		worker.join();
+	m_athreadWorkers.clear();
+	m_bWorkersQuit	= false;
+	}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// Rasterize a tree of 3D sprites into a job, walking it the way Render() does.
+////////////////////////////////////////////////////////////////////////////////
+void CScene::Render3DTree(
+	RPipeLine*	ppipe,			// In:  Pipeline to use.
+	Render3DJob* pjob,			// In:  Job to record into.
+	int16_t		sDstX,			// In:  Destination 2D x coord.
+	int16_t		sDstY,			// In:  Destination 2D y coord.
+	CSprite*		pSprite,			// In:  Tree of sprites.
+	CHood*		phood,			// In:  Da hood.
+	RRect*		prcDstClip)		// In:  Dst clip rect.
+	{
+	while (pSprite != nullptr)
+		{
+		if (!pSprite->flags.Hidden)
+			{
+			Render3D(
+				nullptr,				// Nothing is drawn into the destination.
+				sDstX,
+				sDstY,
+				pSprite->GetTyped<CSprite3>(),
+				pSprite->flags.HighIntensity ? phood->m_pltSpot : phood->m_pltAmbient,
+				prcDstClip,
+				ppipe,
+				pjob);
 
-			// Go through all the sprites stored in this layer
-			for (msetSprites::iterator iSprite = pLayer->m_sprites.begin(); iSprite != pLayer->m_sprites.end(); )
+			if (pSprite->m_psprHeadChild != nullptr)
 				{
-				// Get pointer to sprite (more readable than iterator dereference and may optimize better)
-				CSprite* pSprite = *iSprite;
-
-				Render(				// Returns nothing.
-					pimDst,			// Destination image.
-					-sMapX,			// Destination 2D x coord.
-					-sMapY,			// Destination 2D y coord.
-					pSprite,			// Tree of sprites to render.
-					phood,			// Da hood, homey.
-					&rDstClip,		// Dst clip rect.
-					psprXRayee);	// XRayee, if not nullptr.
-
-				// Move to next item before deleting this one.
-				iSprite++;
-
-				// If this sprite wanted to be deleted after use . . .
-            if (pSprite->flags.DeleteOnRender)
+				Render3DTree(ppipe, pjob, sDstX + pSprite->m_sX2, sDstY + pSprite->m_sY2,
+					pSprite->m_psprHeadChild, phood, prcDstClip);
+				}
+			}
+
+		pSprite	= pSprite->m_psprNext;
+		}
+	}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// Put the pixels of a piece that fall in a clip area in the destination: those
+// that aren't 0 if blitting (as rspBlitT() from the clip buffer), otherwise
+// those that were written (as a direct Render()).
+////////////////////////////////////////////////////////////////////////////////
+static void DrawRender3DPiece(
+	RImage*								pimDst,		// In:  Destination image.
+	const CScene::Render3DJob*		pjob,			// In:  Job the piece is in.
+	const CScene::Render3DPiece*	ppiece,		// In:  Piece to draw.
+	int16_t								sX,			// In:  Where its area goes.
+	int16_t								sY,
+	int16_t								sClipX0,		// In:  Area to stay in (end exclusive).
+	int16_t								sClipY0,
+	int16_t								sClipX1,
+	int16_t								sClipY1,
+	bool									bBlitT)		// In:  true to blit.
+	{
+	sClipX0	= MAX(sClipX0, int16_t(0));
+	sClipY0	= MAX(sClipY0, int16_t(0));
+	sClipX1	= MIN(sClipX1, pimDst->m_sWidth);
+	sClipY1	= MIN(sClipY1, pimDst->m_sHeight);
+
+	for (int16_t sRow = 0; sRow < ppiece->sH; sRow++)
+		{
+		int16_t	sDstY	= sY + sRow;
+		if (sDstY < sClipY0 || sDstY >= sClipY1)
+			continue;
+
+		const uint8_t*	pu8Src		= &pjob->au8Pixels[ppiece->lOffset + size_t(sRow) * ppiece->sW];
+		const uint8_t*	pu8Written	= &pjob->au8Written[ppiece->lOffset + size_t(sRow) * ppiece->sW];
+		uint8_t*			pu8Dst		= pimDst->m_pData + sDstY * pimDst->m_lPitch;
+		for (int16_t sCol = 0; sCol < ppiece->sW; sCol++)
+			{
+			int16_t	sDstX	= sX + sCol;
+			if (sDstX < sClipX0 || sDstX >= sClipX1)
+				continue;
+
+			if (bBlitT ? (pu8Src[sCol] != 0) : (pu8Written[sCol] != 0))
+				pu8Dst[sDstX]	= pu8Src[sCol];
+			}
+		}
+	}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// Put a job's pieces in the destination image the way Render3D() would have.
+////////////////////////////////////////////////////////////////////////////////
+void CScene::DrawRender3DJob(
+	RImage*		pimDst,			// In:  Destination image.
+	Render3DJob* pjob,			// In:  Job to draw.
+	RRect*		prcDstClip)		// In:  Dst clip rect.
+	{
+	for (const Render3DPiece& piece : pjob->aPieces)
+		{
+		// Clipped blits stay in the clip rect.  Direct renders were only done
+		// for sprites in it, but stay in the image just in case.
+		if (piece.bBlitT)
+			{
+			DrawRender3DPiece(pimDst, pjob, &piece, piece.sDstX, piece.sDstY,
+				prcDstClip->sX, prcDstClip->sY, prcDstClip->sX + prcDstClip->sW, prcDstClip->sY + prcDstClip->sH, true);
+			}
+		else
+			{
+			DrawRender3DPiece(pimDst, pjob, &piece, piece.sDstX, piece.sDstY,
+				0, 0, pimDst->m_sWidth, pimDst->m_sHeight, false);
+			}
+		}
+	}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// Add the bytes of a value to an impostor key.
+////////////////////////////////////////////////////////////////////////////////
+template <class T>
+inline void AppendImpostorKey(std::string* pstrKey, const T& val)
+	{
+	pstrKey->append(reinterpret_cast<const char*>(&val), sizeof(val));
+	}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// Add everything Render3D() would take from a tree of 3D sprites to an
+// impostor key, except where the top of the tree is.
+////////////////////////////////////////////////////////////////////////////////
+static void AppendImpostorTreeKey(
+	std::string*	pstrKey,				// In/Out: Key.
+	CSprite*			pSprite,				// In:  Tree of 3D sprites.
+	bool				bTop)					// In:  true for the top level.
+	{
+	for (; pSprite != nullptr; pSprite = pSprite->m_psprNext)
+		{
+		AppendImpostorKey(pstrKey, uint8_t(pSprite->flags.Hidden));
+		if (pSprite->flags.Hidden)
+			continue;
+
+		CSprite3*	ps3	= pSprite->GetTyped<CSprite3>();
+		AppendImpostorKey(pstrKey, ps3->m_psop);
+		AppendImpostorKey(pstrKey, ps3->m_pmesh);
+		AppendImpostorKey(pstrKey, ps3->m_ptex);
+		AppendImpostorKey(pstrKey, ps3->m_psphere);
+		pstrKey->append(reinterpret_cast<const char*>(ps3->m_ptrans->matrix()), 16 * sizeof(real_t));
+		AppendImpostorKey(pstrKey, ps3->m_sBrightness);
+		AppendImpostorKey(pstrKey, uint8_t(ps3->flags.HighIntensity));
+		if (bTop == false)
+			{
+			AppendImpostorKey(pstrKey, ps3->m_sX2);
+			AppendImpostorKey(pstrKey, ps3->m_sY2);
+			}
+
+		// Bracket the children so different shapes of tree can't match.
+		pstrKey->push_back('(');
+		AppendImpostorTreeKey(pstrKey, ps3->m_psprHeadChild, false);
+		pstrKey->push_back(')');
+		}
+	}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// Note what Render3D() left in each sprite of a tree just rendered into a job,
+// and which piece each made.
+////////////////////////////////////////////////////////////////////////////////
+static void GatherImpostorSprites(
+	CSprite*										pSprite,		// In:  Tree of 3D sprites.
+	const CScene::Render3DJob*				pjob,			// In:  Job it was rendered into.
+	size_t*										plPiece,		// In/Out: Next piece of the job.
+	std::vector<CImpostorCache::SpriteInfo>* paSprites)	// Out: Sprites.
+	{
+	for (; pSprite != nullptr; pSprite = pSprite->m_psprNext)
+		{
+		if (pSprite->flags.Hidden)
+			continue;
+
+		CSprite3*	ps3	= pSprite->GetTyped<CSprite3>();
+		CImpostorCache::SpriteInfo	info;
+		info.sCenOffX	= ps3->m_sCenX - ps3->m_sX2;
+		info.sCenOffY	= ps3->m_sCenY - ps3->m_sY2;
+		info.sRadius	= ps3->m_sRadius;
+		info.lPiece		= -1;
+		if (*plPiece < pjob->aPieces.size() && pjob->aPieces[*plPiece].ps3 == ps3)
+			info.lPiece	= int32_t((*plPiece)++);
+		paSprites->push_back(info);
+
+		GatherImpostorSprites(ps3->m_psprHeadChild, pjob, plPiece, paSprites);
+		}
+	}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// Draw a tree of 3D sprites from an impostor, making the same choices
+// Render3D() would for where the tree is now.
+////////////////////////////////////////////////////////////////////////////////
+static void DrawImpostorTree(
+	RImage*						pimDst,			// In:  Destination image.
+	int16_t						sHotX,			// In:  Destination of the tree's hotspot.
+	int16_t						sHotY,
+	CSprite*						pSprite,			// In:  Tree of 3D sprites.
+	CImpostorCache::Entry*	pentry,			// In:  Its impostor.
+	size_t*						plSprite,		// In/Out: Next of pentry->aSprites.
+	RRect*						prcDstClip)		// In:  Dst clip rect.
+	{
+	for (; pSprite != nullptr; pSprite = pSprite->m_psprNext)
+		{
+		if (pSprite->flags.Hidden)
+			continue;
+
+		CSprite3*	ps3	= pSprite->GetTyped<CSprite3>();
+		ASSERT(*plSprite < pentry->aSprites.size());
+		const CImpostorCache::SpriteInfo&	info	= pentry->aSprites[(*plSprite)++];
+		ps3->m_sCenX		= ps3->m_sX2 + info.sCenOffX;
+		ps3->m_sCenY		= ps3->m_sY2 + info.sCenOffY;
+		ps3->m_sRadius		= info.sRadius;
+
+		if (info.lPiece >= 0)
+			{
+			const CScene::Render3DPiece&	piece	= pentry->job.aPieces[info.lPiece];
+			int16_t	sCenterX		= sHotX + piece.sCenterX;
+			int16_t	sCenterY		= sHotY + piece.sCenterY;
+			int16_t	sDiameter	= piece.sDiameter;
+			int16_t	sRadius		= sDiameter / 2;
+			int16_t	sClipLeft	= prcDstClip->sX - (sCenterX - sRadius);
+			int16_t	sClipTop		= prcDstClip->sY - (sCenterY - sRadius);
+			int16_t	sClipRight	= (sCenterX + sRadius) - (prcDstClip->sX + prcDstClip->sW);
+			int16_t	sClipBottom	= (sCenterY + sRadius) - (prcDstClip->sY + prcDstClip->sH);
+			// If on screen at all . . .
+			if (sClipLeft < sDiameter && sClipTop < sDiameter && sClipRight < sDiameter && sClipBottom < sDiameter)
+				{
+				// If only partially on screen, it would have been blitted from the
+				// clip buffer, otherwise rendered right into the destination.
+				if (sClipLeft > 0 || sClipTop > 0 || sClipRight > 0 || sClipBottom > 0)
 					{
-					RemoveSprite(pSprite);
-					// Be gone, vile weed.
-					delete pSprite;
+					int16_t	sBlitX	= sCenterX - sRadius;
+					int16_t	sBlitY	= sCenterY - sRadius;
+					DrawRender3DPiece(pimDst, &pentry->job, &piece, sHotX + piece.sDstX, sHotY + piece.sDstY,
+						MAX(sBlitX, prcDstClip->sX),
+						MAX(sBlitY, prcDstClip->sY),
+						MIN(int16_t(sBlitX + piece.sBlitW), int16_t(prcDstClip->sX + prcDstClip->sW)),
+						MIN(int16_t(sBlitY + piece.sBlitH), int16_t(prcDstClip->sY + prcDstClip->sH)),
+						true);
 					}
 				else
 					{
-					// If this sprite is an xrayee, add it to the container
-               if (pSprite->flags.Xrayee)
-						{
-						psprXRayee	= pSprite;
-						}
+					DrawRender3DPiece(pimDst, &pentry->job, &piece, sHotX + piece.sDstX, sHotY + piece.sDstY,
+						0, 0, pimDst->m_sWidth, pimDst->m_sHeight, false);
 					}
 				}
 			}
+
+		DrawImpostorTree(pimDst, sHotX, sHotY, ps3->m_psprHeadChild, pentry, plSprite, prcDstClip);
 		}
 	}
 
 
+////////////////////////////////////////////////////////////////////////////////
+// Draw a tree of 3D sprites from the impostor cache, rendering it into the
+// cache first if it isn't there.  It is rendered with its hotspot at 0, 0 and
+// a clip rect so big every sprite goes straight in, so each piece holds all
+// its sprite would draw.
+////////////////////////////////////////////////////////////////////////////////
+void CScene::RenderImpostor(
+	RImage*		pimDst,			// In:  Destination image.
+	int16_t		sDstX,			// In:  Destination 2D x coord.
+	int16_t		sDstY,			// In:  Destination 2D y coord.
+	CSprite*		pTree,			// In:  Tree of 3D sprites (see IsTree3D()).
+	CHood*		phood,			// In:  Da hood.
+	RRect*		prcDstClip)		// In:  Dst clip rect.
+	{
+	m_strImpostorKey.clear();
+	AppendImpostorKey(&m_strImpostorKey, g_GameSettings.m_s3dFog);
+	AppendImpostorKey(&m_strImpostorKey, gsGlobalLightingAdjustment);
+	AppendImpostorKey(&m_strImpostorKey, phood->m_pltSpot);
+	AppendImpostorKey(&m_strImpostorKey, phood->m_pltAmbient);
+	AppendImpostorTreeKey(&m_strImpostorKey, pTree, true);
+
+	CImpostorCache::Entry*	pentry	= m_pimpostors->Find(m_strImpostorKey);
+	if (pentry == nullptr)
+		{
+		RRect	rcAll(-(INT16_MAX / 2), -(INT16_MAX / 2), INT16_MAX, INT16_MAX);
+		m_jobCapture.pTree	= pTree;
+		m_jobCapture.aPieces.clear();
+		m_jobCapture.au8Pixels.clear();
+		m_jobCapture.au8Written.clear();
+		Render3DTree(&m_pipeline, &m_jobCapture, -pTree->m_sX2, -pTree->m_sY2, pTree, phood, &rcAll);
+
+		std::vector<CImpostorCache::SpriteInfo>	aSprites;
+		size_t	lPiece	= 0;
+		GatherImpostorSprites(pTree, &m_jobCapture, &lPiece, &aSprites);
+		pentry	= m_pimpostors->Add(m_strImpostorKey, &m_jobCapture, &aSprites);
+		}
+
+	size_t	lSprite	= 0;
+	DrawImpostorTree(pimDst, sDstX + pTree->m_sX2, sDstY + pTree->m_sY2, pTree, pentry, &lSprite, prcDstClip);
+	}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// Sort m_aCmds by key.  This is an LSD radix sort a byte at a time.  Keys
+// mostly differ in only a few of their bytes (few layers, small priorities,
+// recent sequence numbers), so bytes that are the same in every key are
+// skipped; all eight byte counts come from one pass over the keys.
+////////////////////////////////////////////////////////////////////////////////
+void CScene::SortRenderCmds(void)
+	{
+	size_t	sizeCmds	= m_aCmds.size();
+	if (sizeCmds < 2)
+		return;
+
+	uint32_t	aulCounts[sizeof(uint64_t)][256]	= { };
+	for (size_t i = 0; i < sizeCmds; i++)
+		{
+		uint64_t	u64Key	= m_aCmds[i].u64Key;
+		for (size_t sByte = 0; sByte < sizeof(uint64_t); sByte++)
+			aulCounts[sByte][(u64Key >> (sByte * 8)) & 0xFF]++;
+		}
+
+	m_aCmdsSorted.resize(sizeCmds);
+	RenderCmd*	pcmdSrc	= m_aCmds.data();
+	RenderCmd*	pcmdDst	= m_aCmdsSorted.data();
+	for (size_t sByte = 0; sByte < sizeof(uint64_t); sByte++)
+		{
+		uint32_t*	pulCounts	= aulCounts[sByte];
+		size_t		sShift		= sByte * 8;
+
+		// If every key has the same byte here, this pass wouldn't move anything.
+		if (pulCounts[(pcmdSrc[0].u64Key >> sShift) & 0xFF] == sizeCmds)
+			continue;
+
+		// Counts to starting positions.
+		uint32_t	ulPos	= 0;
+		for (size_t sDigit = 0; sDigit < 256; sDigit++)
+			{
+			uint32_t	ulCount	= pulCounts[sDigit];
+			pulCounts[sDigit]	= ulPos;
+			ulPos	+= ulCount;
+			}
+
+		for (size_t i = 0; i < sizeCmds; i++)
+			pcmdDst[pulCounts[(pcmdSrc[i].u64Key >> sShift) & 0xFF]++]	= pcmdSrc[i];
+
+		std::swap(pcmdSrc, pcmdDst);
+		}
+
+	// If the sorted commands ended up in the scratch array, trade arrays.
+	if (pcmdSrc != m_aCmds.data())
+		m_aCmds.swap(m_aCmdsSorted);
+	}
+
+
 ////////////////////////////////////////////////////////////////////////////////
 // Setup render pipeline.  Use this function to setup or alter the pipeline.
 // This function DOES a makeIdentity() and then multiplies by the supplied transform,
@@ -1741,6 +2789,9 @@ void CScene::SetupPipeline(						// Returns nothing.
 	// Strap onto the old methods:
 	m_dScale3d = dScale3d;
 
+	// Impostors were rendered for the old pipeline.
+	m_pimpostors->Reset();
+
 	// Use the built in adjustment features of the pipeline:
 	if (m_pipeline.Create(1000, SCREEN_DIAMETER_FOR_3D) != SUCCESS)
 		TRACE("SetupPipeline(): FONGOOL!  m_pipeline.Create() failed!  No 3D for you!\n");
@@ -2001,6 +3052,170 @@ void CScene::SetXRayAll(	// You see a door to the north.  Returns nothing.
 	m_bXRayAll	= bXRayAll;
 	}
 
+
+////////////////////////////////////////////////////////////////////////////////
+// Draw the layers of m_aCmds under the first sprite that isn't static from
+// m_bgcache.  Only the parts of the view that weren't in it last time are
+// drawn into it, unless something it was drawn with changed.
+////////////////////////////////////////////////////////////////////////////////
+size_t CScene::RenderBackground(	// Returns the number of m_aCmds drawn.
+	int16_t		sSrcX,			// In:  Source (scene) x coord
+	int16_t		sSrcY,			// In:  Source (scene) y coord
+	int16_t		sW,				// In:  Width
+	int16_t		sH,				// In:  Height
+	RImage*		pimDst,			// In:  Destination image.
+	int16_t		sDstX,			// In:  Destination (image) x coord
+	int16_t		sDstY,			// In:  Destination (image) y coord
+	RRect*		prcDstClip,		// In:  Dst clip rect.
+	managed_ptr<CHood> phood)	// In:  Da hood.
+	{
+	if (sW <= 0 || sH <= 0)
+		return 0;
+
+	// Anything drawn over the cache goes over all of the layers under it, so
+	// it can hold every layer under the first sprite that isn't static.
+	size_t	lNumCmds	= 0;
+	while (lNumCmds < m_aCmds.size())
+		{
+		CSprite*	pSprite	= m_aCmds[lNumCmds].pSprite;
+		if (!pSprite->flags.Static || pSprite->flags.DeleteOnRender || pSprite->flags.Xrayee)
+			break;
+		lNumCmds++;
+		}
+
+	int16_t	sLayers	= m_sNumLayers;
+	if (lNumCmds < m_aCmds.size())
+		{
+		sLayers	= int16_t(m_aCmds[lNumCmds].u64Key >> 48);
+		// Static sprites on that layer are drawn with it.
+		while (lNumCmds > 0 && int16_t(m_aCmds[lNumCmds - 1].u64Key >> 48) >= sLayers)
+			lNumCmds--;
+		}
+
+	if (sLayers == 0)
+		return 0;
+
+	uint64_t	u64Hidden	= 0;
+	for (int16_t sLayer = 0; sLayer < sLayers; sLayer++)
+		{
+		if (m_pLayers[sLayer].m_bHidden)
+			u64Hidden	|= uint64_t(1) << (sLayer & 63);
+		}
+
+	BackgroundCache*	pbg	= &m_bgcache;
+	if (pbg->im.m_sWidth != sW || pbg->im.m_sHeight != sH || pbg->im.m_pData == nullptr)
+		{
+		pbg->im.DestroyData();
+		if (pbg->im.CreateImage(sW, sH, RImage::BMP8) != SUCCESS)
+			{
+			TRACE("RenderBackground(): CreateImage() failed.\n");
+			pbg->sLayers	= 0;
+			return 0;
+			}
+		pbg->sLayers	= 0;
+		}
+
+	int32_t	lScrollX	= int32_t(sSrcX) - pbg->sX;
+	int32_t	lScrollY	= int32_t(sSrcY) - pbg->sY;
+	if (pbg->sLayers != sLayers ||
+		 pbg->phood != &(*phood) ||
+		 pbg->ulStaticChanges != m_ulStaticChanges ||
+		 pbg->u64Hidden != u64Hidden ||
+		 pbg->sAlphaBlend != g_GameSettings.m_sAlphaBlend ||
+		 ABS(lScrollX) >= sW || ABS(lScrollY) >= sH)
+		{
+		DrawBackgroundArea(sSrcX, sSrcY, sW, sH, lNumCmds, phood);
+		}
+	else
+		{
+		// Columns, then rows, that scrolled into view.
+		if (lScrollX > 0)
+			DrawBackgroundArea(sSrcX + sW - lScrollX, sSrcY, lScrollX, sH, lNumCmds, phood);
+		else if (lScrollX < 0)
+			DrawBackgroundArea(sSrcX, sSrcY, -lScrollX, sH, lNumCmds, phood);
+
+		if (lScrollY > 0)
+			DrawBackgroundArea(sSrcX, sSrcY + sH - lScrollY, sW, lScrollY, lNumCmds, phood);
+		else if (lScrollY < 0)
+			DrawBackgroundArea(sSrcX, sSrcY, sW, -lScrollY, lNumCmds, phood);
+		}
+
+	pbg->sLayers			= sLayers;
+	pbg->sX					= sSrcX;
+	pbg->sY					= sSrcY;
+	pbg->phood				= &(*phood);
+	pbg->ulStaticChanges	= m_ulStaticChanges;
+	pbg->u64Hidden			= u64Hidden;
+	pbg->sAlphaBlend		= g_GameSettings.m_sAlphaBlend;
+
+	// Copy the ring to the destination, in up to 4 pieces where it wraps.
+	int16_t	sRingX	= SceneRingPos(sSrcX, sW);
+	int16_t	sRingY	= SceneRingPos(sSrcY, sH);
+	int16_t	sW1		= sW - sRingX;
+	int16_t	sH1		= sH - sRingY;
+	rspBlit(&pbg->im, pimDst, sRingX, sRingY, sDstX, sDstY, sW1, sH1, prcDstClip);
+	if (sRingX > 0)
+		rspBlit(&pbg->im, pimDst, 0, sRingY, sDstX + sW1, sDstY, sRingX, sH1, prcDstClip);
+	if (sRingY > 0)
+		rspBlit(&pbg->im, pimDst, sRingX, 0, sDstX, sDstY + sH1, sW1, sRingY, prcDstClip);
+	if (sRingX > 0 && sRingY > 0)
+		rspBlit(&pbg->im, pimDst, 0, 0, sDstX + sW1, sDstY + sH1, sRingX, sRingY, prcDstClip);
+
+	return lNumCmds;
+	}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// Draw the first lNumCmds of m_aCmds into the part of m_bgcache's ring an area
+// of the scene goes in.  The area may wrap around the ring's edges, so it's
+// drawn in up to 4 pieces.
+////////////////////////////////////////////////////////////////////////////////
+void CScene::DrawBackgroundArea(
+	int16_t		sX,				// In:  Scene coords of the area.
+	int16_t		sY,
+	int16_t		sW,				// In:  Size of the area.
+	int16_t		sH,
+	size_t		lNumCmds,		// In:  Number of m_aCmds to draw.
+	managed_ptr<CHood> phood)	// In:  Da hood.
+	{
+	RImage*	pim	= &m_bgcache.im;
+	for (int16_t sPieceY = sY; sPieceY < sY + sH; )
+		{
+		int16_t	sRingY	= SceneRingPos(sPieceY, pim->m_sHeight);
+		int16_t	sPieceH	= MIN(int16_t(sY + sH - sPieceY), int16_t(pim->m_sHeight - sRingY));
+		for (int16_t sPieceX = sX; sPieceX < sX + sW; )
+			{
+			int16_t	sRingX	= SceneRingPos(sPieceX, pim->m_sWidth);
+			int16_t	sPieceW	= MIN(int16_t(sX + sW - sPieceX), int16_t(pim->m_sWidth - sRingX));
+
+			// What isn't covered shows black.
+			RRect	rcPiece(sRingX, sRingY, sPieceW, sPieceH);
+			rspRect(0, pim, sRingX, sRingY, sPieceW, sPieceH, &rcPiece);
+
+			for (size_t i = 0; i < lNumCmds; i++)
+				{
+				CSprite*	pSprite	= m_aCmds[i].pSprite;
+				if (pSprite->m_bBinned &&
+					 (pSprite->m_sBoundX0 >= sPieceX + sPieceW || pSprite->m_sBoundX1 <= sPieceX ||
+					  pSprite->m_sBoundY0 >= sPieceY + sPieceH || pSprite->m_sBoundY1 <= sPieceY))
+					continue;
+
+				Render(					// Returns nothing.
+					pim,					// Destination image.
+					sRingX - sPieceX,	// Destination 2D x coord.
+					sRingY - sPieceY,	// Destination 2D y coord.
+					pSprite,				// Tree of sprites to render.
+					phood,				// Da hood, homey.
+					&rcPiece,			// Dst clip rect.
+					nullptr);			// No XRayee under the first sprite that isn't static.
+				}
+
+			sPieceX	+= sPieceW;
+			}
+		sPieceY	+= sPieceH;
+		}
+	}
+
 ////////////////////////////////////////////////////////////////////////////////
 // EOF
 ////////////////////////////////////////////////////////////////////////////////
@@ -180,6 +180,30 @@
 #include "hood.h"
 #include "sprites.h"
 
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+class CImpostorCache;
+
+// For culling, each layer also sorts its sprites into square bins this many
+// bits of screen pixels wide (128).
+#define SCENE_BIN_SHIFT				7
+
+// Sprites covering more bins than this are never culled.
+#define SCENE_MAX_SPRITE_BINS		64
+
+// Most threads to rasterize 3D sprites on (see the RenderThreads setting).
+#define SCENE_MAX_RENDER_THREADS	16
+
+// Fewest 3D sprite trees in view worth starting threads for.
+#define SCENE_PARALLEL_MIN_TREES	8
+
 
 ////////////////////////////////////////////////////////////////////////////////
 // HERE ARE GLOBAL LIGHTING MACROS FOR YOUR ENJOYMENT!
@@ -202,9 +226,14 @@ extern	bool	g_bSceneDontBlit;
 class Layer
 	{
 	public:
-		msetSprites m_sprites;							// Sprites in this layer
+		vecSprites m_sprites;							// Sprites in this layer (unsorted)
 		bool m_bHidden;									// Whether this layer is hidden
 
+		// Sprites by the bins (see SCENE_BIN_SHIFT) their bounds cover, and the
+		// sprites that can't be binned, which are never culled.
+		std::unordered_map<uint32_t, std::vector<CSprite*>> m_bins;
+		std::vector<CSprite*> m_unbinned;
+
 	Layer()
 		{
 		m_bHidden = false;
@@ -224,6 +253,37 @@ class CScene
 	// Types, enums, etc.
 	//---------------------------------------------------------------------------
 	public:
+		// What rasterizing one 3D sprite ahead of time would have done to the
+		// destination image.
+		typedef struct
+			{
+			bool		bBlitT;				// true to blit like the clip buffer (0 is
+												// transparent), false to copy just the
+												// pixels that were written.
+			int16_t	sDstX;				// Where the area goes in the destination.
+			int16_t	sDstY;
+			int16_t	sW;					// Size of the area.
+			int16_t	sH;
+			size_t	lOffset;				// Start of the area in Render3DJob::au8Pixels
+												// (and au8Written, when not bBlitT).
+			CSprite3* ps3;					// Sprite rendered.
+			int16_t	sCenterX;			// Center of its bounding sphere.
+			int16_t	sCenterY;
+			int16_t	sDiameter;			// Diameter of its bounding sphere.
+			int16_t	sBlitW;				// Size of the area a clipped render blits.
+			int16_t	sBlitH;
+			} Render3DPiece;
+
+		// A tree of 3D sprites rasterized ahead of time, off the main thread,
+		// to be put in the destination image when its turn to draw comes.
+		typedef struct
+			{
+			CSprite*	pTree;						// Top-level sprite of the tree.
+			std::vector<Render3DPiece> aPieces;	// Its sprites, in drawing order.
+			std::vector<uint8_t> au8Pixels;		// Their pixels.
+			std::vector<uint8_t> au8Written;		// Non-zero for pixels written.
+			std::vector<int16_t> asZBefore;		// Scratch copy of the Z buffer's dirty area.
+			} Render3DJob;
 
 	//---------------------------------------------------------------------------
 	// Variables
@@ -258,6 +318,77 @@ class CScene
 		// can scale 3D objects differently on a per realm basis.
 		double		m_dScale3d;
 
+		// Top-level sprites drawn and culled by the last Render() of an area.
+		int32_t		m_lSpritesVisible;
+		int32_t		m_lSpritesCulled;
+
+	protected:
+		// A sprite to draw, keyed by layer, then priority, then CSprite::m_ulSceneSeq.
+		typedef struct
+			{
+			uint64_t	u64Key;
+			CSprite*	pSprite;
+			} RenderCmd;
+
+		uint32_t		m_ulNextSceneSeq;			// Next CSprite::m_ulSceneSeq.
+		uint32_t		m_ulCullStamp;				// Current CSprite::m_ulCullStamp.
+		std::vector<RenderCmd> m_aCmds;			// Sprites to draw this Render().
+		std::vector<RenderCmd> m_aCmdsSorted;	// Scratch for sorting m_aCmds.
+
+		// The layers under any but static sprites, drawn ahead into a ring the
+		// size of the view.  Scene point (x, y) is kept at (x mod width, y mod
+		// height), so scrolling only needs the strips that come into view drawn.
+		typedef struct
+			{
+			RImage	im;						// The ring.
+			int16_t	sLayers;					// Layers drawn into it (0 if none).
+			int16_t	sX;						// Scene coords of the area it holds.
+			int16_t	sY;
+			CHood*	phood;					// Hood it was drawn with.
+			uint32_t	ulStaticChanges;		// m_ulStaticChanges it was drawn at.
+			uint64_t	u64Hidden;				// Which of its layers were hidden.
+			int16_t	sAlphaBlend;			// Alpha blending setting it was drawn with.
+			} BackgroundCache;
+
+		BackgroundCache m_bgcache;
+		uint32_t		m_ulStaticChanges;		// Bumped whenever a static sprite is added,
+													// updated or removed.
+
+		// 3D trees rasterized ahead by Render3DJobs(), in drawing order, and the
+		// pipelines (each with its own scratch, Z and clip buffers) to do it with.
+		std::vector<Render3DJob> m_aJobs;
+		size_t		m_lNumJobs;
+		std::vector<std::unique_ptr<RPipeLine>> m_apipeWorkers;
+
+		// Helper threads for Render3DJobs(), parked on m_cvWork between batches.
+		// Each batch is numbered, and the first m_ulBatchThreads - 1 helpers take
+		// part in it along with the calling thread.
+		std::vector<std::thread> m_athreadWorkers;
+		std::mutex	m_mutexWorkers;
+		std::condition_variable m_cvWork;	// A batch was posted (or quit).
+		std::condition_variable m_cvDone;	// The helpers finished the batch.
+		uint32_t		m_ulBatch;
+		uint32_t		m_ulBatchThreads;
+		uint32_t		m_ulWorkersBusy;		// Helpers still on the batch.
+		bool			m_bWorkersQuit;
+		std::atomic<size_t> m_lNextJob;		// Next of m_aJobs to take.
+		CHood*		m_phoodBatch;			// What the batch is rendered with.
+		int16_t		m_sBatchDstX;
+		int16_t		m_sBatchDstY;
+		RRect*		m_prcBatchClip;
+
+		// Pre-rendered 3D trees (see impostor.h) and scratch for making them.
+		std::unique_ptr<CImpostorCache> m_pimpostors;
+		Render3DJob	m_jobCapture;
+		std::string	m_strImpostorKey;
+
+	public:
+		// 3D trees rasterized ahead, threads used and microseconds spent doing it
+		// in the last Render() of an area.
+		int32_t		m_lTrees3DAhead;
+		int32_t		m_lRenderThreads;
+		uint32_t		m_ul3DAheadMicroseconds;
+
 	//---------------------------------------------------------------------------
 	// Functions
 	//---------------------------------------------------------------------------
@@ -345,7 +476,10 @@ class CScene
 			int16_t			sDstY,			// Destination 2D y coord.
 			CSprite3*	ps3Cur,			// 3D sprite to render.
 			RAlpha*		plight,			// Light to render with.
-			RRect*		prcDstClip);	// Dst clip rect.
+			RRect*		prcDstClip,		// Dst clip rect.
+			RPipeLine*	ppipe = nullptr,	// Pipeline to use (m_pipeline if nullptr).
+			Render3DJob* pjob = nullptr);	// Job to record into instead of drawing
+												// into pimDst, if not nullptr.
 
 		inline
 		void									// Returns nothing.
@@ -402,6 +536,127 @@ class CScene
 		// Set all 'alpha' _and_ 'opaque' layers to xray.
 		void SetXRayAll(		// You see a door to the north.  Returns nothing.
 			bool bXRayAll);	// In:  true to X Ray all 'alpha' _and_ 'opaque' layers. 
+
+	protected:
+		// Get the scene area a sprite tree can draw to.
+		bool GetTreeBounds(		// Returns false if the area can't be known.
+			CSprite*	pSprite,			// In:  Tree of sprites.
+			int16_t	sOffX,			// In:  Position of the tree's parent.
+			int16_t	sOffY,
+			int16_t*	psX0,				// In/Out: Bounds to grow.
+			int16_t*	psY0,
+			int16_t*	psX1,
+			int16_t*	psY1);
+
+		// Put a sprite in the culling bins of its layer, moving it if its bounds
+		// or layer have changed.
+		void BinSprite(
+			CSprite*	pSprite,			// In:  Sprite in the scene.
+			int16_t	sOldLayer);		// In:  Layer it was binned in.
+
+		// Take a sprite out of its layer's culling bins.
+		void UnbinSprite(
+			CSprite*	pSprite,			// In:  Sprite in the scene.
+			int16_t	sLayer);			// In:  Layer it was binned in.
+
+		// Add a sprite to the end of a layer's container.
+		void AddToLayer(
+			CSprite*	pSprite,			// In:  Sprite to add.
+			int16_t	sLayer);			// In:  Layer to add it to.
+
+		// Take a sprite out of a layer's container.
+		void RemoveFromLayer(
+			CSprite*	pSprite,			// In:  Sprite to remove.
+			int16_t	sLayer);			// In:  Layer it's in.
+
+		// Add a sprite to m_aCmds.
+		void AddRenderCmd(
+			CSprite*	pSprite,			// In:  Sprite to draw.
+			int16_t	sLayer);			// In:  Layer it's in.
+
+		// Sort m_aCmds by key (a radix sort, skipping bytes all keys share).
+		void SortRenderCmds(void);
+
+		// true if a sprite tree is all 3D sprites (it can be rasterized ahead).
+		bool IsTree3D(
+			CSprite*	pSprite);		// In:  Tree of sprites.
+
+		// Rasterize the all-3D trees in m_aCmds ahead, on several threads, into
+		// m_aJobs.  Does nothing unless the RenderThreads setting asks for it and
+		// there are enough trees.  Work is split per sprite tree, not by screen
+		// tiles, and it has not been timed on more than one core yet, so it is
+		// groundwork and off by default.
+		void Render3DJobs(
+			CHood*	phood,			// In:  Da hood.
+			int16_t	sDstX,			// In:  Destination 2D x coord of trees.
+			int16_t	sDstY,			// In:  Destination 2D y coord of trees.
+			RRect*	prcDstClip);	// In:  Dst clip rect.
+
+		// Rasterize jobs of the current batch until there are none left.
+		void Render3DBatch(
+			RPipeLine*	ppipe);		// In:  Pipeline to use.
+
+		// Body of a helper thread of Render3DJobs().
+		void Render3DWorker(
+			uint32_t	ulIndex,			// In:  Which helper (1 and up).
+			uint32_t	ulBatch);		// In:  Last batch posted before it started.
+
+		// Stop the helper threads of Render3DJobs().
+		void StopRender3DWorkers(void);
+
+		// Rasterize a tree of 3D sprites into a job (see Render()).
+		void Render3DTree(
+			RPipeLine*	ppipe,		// In:  Pipeline to use.
+			Render3DJob* pjob,		// In:  Job to record into.
+			int16_t		sDstX,		// In:  Destination 2D x coord.
+			int16_t		sDstY,		// In:  Destination 2D y coord.
+			CSprite*		pSprite,		// In:  Tree of sprites.
+			CHood*		phood,		// In:  Da hood.
+			RRect*		prcDstClip);	// In:  Dst clip rect.
+
+		// Put a job's pieces in the destination image.
+		void DrawRender3DJob(
+			RImage*		pimDst,		// In:  Destination image.
+			Render3DJob* pjob,		// In:  Job to draw.
+			RRect*		prcDstClip);	// In:  Dst clip rect.
+
+		// Draw a tree of 3D sprites from the impostor cache, rendering it into
+		// the cache first if it isn't there.
+		void RenderImpostor(
+			RImage*		pimDst,		// In:  Destination image.
+			int16_t		sDstX,		// In:  Destination 2D x coord.
+			int16_t		sDstY,		// In:  Destination 2D y coord.
+			CSprite*		pTree,		// In:  Tree of 3D sprites (see IsTree3D()).
+			CHood*		phood,		// In:  Da hood.
+			RRect*		prcDstClip);	// In:  Dst clip rect.
+
+		// Draw the layers of m_aCmds under the first sprite that isn't static
+		// from m_bgcache, bringing it up to date first.
+		size_t RenderBackground(	// Returns the number of m_aCmds drawn.
+			int16_t		sSrcX,		// In:  Source (scene) x coord
+			int16_t		sSrcY,		// In:  Source (scene) y coord
+			int16_t		sW,			// In:  Width
+			int16_t		sH,			// In:  Height
+			RImage*		pimDst,		// In:  Destination image.
+			int16_t		sDstX,		// In:  Destination (image) x coord
+			int16_t		sDstY,		// In:  Destination (image) y coord
+			RRect*		prcDstClip,	// In:  Dst clip rect.
+			managed_ptr<CHood> phood);	// In:  Da hood.
+
+		// Draw the first lNumCmds of m_aCmds into the part of m_bgcache's ring
+		// an area of the scene goes in.
+		void DrawBackgroundArea(
+			int16_t		sX,			// In:  Scene coords of the area.
+			int16_t		sY,
+			int16_t		sW,			// In:  Size of the area.
+			int16_t		sH,
+			size_t		lNumCmds,	// In:  Number of m_aCmds to draw.
+			managed_ptr<CHood> phood);	// In:  Da hood.
+
+	public:
+		// Pre-rendered 3D trees, for their hit and miss counts.
+		CImpostorCache* GetImpostors(void)
+			{ return m_pimpostors.get(); }
 	};
 
 
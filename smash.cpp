@@ -21,6 +21,8 @@
 
 #include <newpix/sprite_base.h>
 
+#include <memory>
+
 //#define SMASH_DEBUG
 
 #ifdef	SMASH_DEBUG
@@ -207,7 +209,7 @@ int16_t	CSmashatorium::CollideCyl(CSmash* pSmashee,R3DLine* pLine) // sphere of
 ////////////////////////////////////////////////////////////////////////////////
 //  CSmashatorium::Alloc - create a grid of smash lists:
 ////////////////////////////////////////////////////////////////////////////////
-int16_t CSmashatorium::Alloc(int16_t sWorldW,int16_t sWorldH,int16_t sTileW,int16_t sTileH)
+int16_t CSmashatorium::Alloc(int32_t lWorldW,int32_t lWorldH,int32_t lTileW,int32_t lTileH)
 		{
 		//-------------------------------------------------------------
 		ASSERT(!m_psAccessX); // previous grid?
@@ -215,34 +217,34 @@ int16_t CSmashatorium::Alloc(int16_t sWorldW,int16_t sWorldH,int16_t sTileW,int1
 		ASSERT(!m_ppslAccessY);
 		ASSERT(!m_pGrid);
 		
-		ASSERT(sWorldW > 0); // bad input?
-		ASSERT(sWorldH > 0);
-		ASSERT(sTileW > 0);
-		ASSERT(sTileH > 0);
+		ASSERT(lWorldW > 0); // bad input?
+		ASSERT(lWorldH > 0);
+		ASSERT(lTileW > 0);
+		ASSERT(lTileH > 0);
 		//-------------------------------------------------------------
-		m_sWorldW = sWorldW;
-		m_sWorldH = sWorldH;
+		m_lWorldW = lWorldW;
+		m_lWorldH = lWorldH;
 
-		m_sClipW = m_sWorldW + (sTileW << 1);	// Add a one tile border
-		m_sClipH = m_sWorldH + (sTileH << 1);
+		m_lClipW = m_lWorldW + (lTileW << 1);	// Add a one tile border
+		m_lClipH = m_lWorldH + (lTileH << 1);
 
-		m_sTileW = sTileW;	// For debugging & clipping
-		m_sTileH = sTileH;	
+		m_lTileW = lTileW;	// For debugging & clipping
+		m_lTileH = lTileH;	
 
-		m_sGridW = (m_sClipW + sTileW - 1) / sTileW;
-		m_sGridH = (m_sClipH + sTileH - 1) / sTileH;
+		m_lGridW = (m_lClipW + lTileW - 1) / lTileW;
+		m_lGridH = (m_lClipH + lTileH - 1) / lTileH;
 
 		// For current logic convenience, do not allow partial tiles to exist:
-		m_sClipW = int32_t(m_sGridW) * sTileW;
-		m_sClipH = int32_t(m_sGridH) * sTileH;
+		m_lClipW = m_lGridW * lTileW;
+		m_lClipH = m_lGridH * lTileH;
 
 		// Note that we must add 2 tile lengths to each access line:
-		m_pGrid = new CSmashatoriumList[int32_t(m_sGridW) * m_sGridH];
-		m_psAccessX = (int16_t*) calloc(sizeof(int16_t),m_sClipW);
-		m_psAccessY = (int16_t*) calloc(sizeof(int16_t),m_sClipH);
-		m_ppslAccessY = (CSmashatoriumList**) calloc(sizeof (CSmashatoriumList*),m_sClipH);
+		m_pGrid = new CSmashatoriumList[size_t(m_lGridW) * m_lGridH];
+		m_psAccessX = (int16_t*) calloc(sizeof(int16_t),m_lClipW);
+		m_psAccessY = (int16_t*) calloc(sizeof(int16_t),m_lClipH);
+		m_ppslAccessY = (CSmashatoriumList**) calloc(sizeof (CSmashatoriumList*),m_lClipH);
 
-		if (!m_psAccessX || !m_psAccessX || !m_ppslAccessY || !m_pGrid)
+		if (!m_psAccessX || !m_psAccessY || !m_ppslAccessY || !m_pGrid)
 			{
 			TRACE("CSmashatorium::Ran out of memory!\n");
 			Destroy();
@@ -251,31 +253,31 @@ int16_t CSmashatorium::Alloc(int16_t sWorldW,int16_t sWorldH,int16_t sTileW,int1
 			}
 
 		// THE OFFICIAL RANGE HERE is from
-		// -m_sTileW to (m_sWorldW + m_sTileW)
-		// FULL CLIP is from 0 to (m_sWorldW - 1)
+		// -m_lTileW to (m_lWorldW + m_lTileW)
+		// FULL CLIP is from 0 to (m_lWorldW - 1)
 		//
-		m_psClipX = m_psAccessX + m_sTileW;	// Offset values
-		m_psClipY = m_psAccessY + m_sTileH;	// Offset values
-		m_ppslClipY = m_ppslAccessY + m_sTileH;	// Offset values
+		m_psClipX = m_psAccessX + m_lTileW;	// Offset values
+		m_psClipY = m_psAccessY + m_lTileH;	// Offset values
+		m_ppslClipY = m_ppslAccessY + m_lTileH;	// Offset values
 	
 		// Populate the access tables....
-		int16_t i,j,p,g;
+		int32_t i,j,p,g;
 
-		for (g=0, p = 0,i=0 ; i < m_sClipW; i += sTileW, g++)
+		for (g=0, p = 0,i=0 ; i < m_lClipW; i += lTileW, g++)
 			{
-			for (j=0; j < sTileW; j++, p++)
+			for (j=0; j < lTileW; j++, p++)
 				{
-				m_psAccessX[p] = g;
+				m_psAccessX[p] = int16_t(g);
 				}
 			}
 
-		for (g=0, p = 0,i=0 ; i < m_sClipH; i += sTileH, g++)
+		for (g=0, p = 0,i=0 ; i < m_lClipH; i += lTileH, g++)
 			{
-			for (j=0; j < sTileH; j++, p++)
+			for (j=0; j < lTileH; j++, p++)
 				{
-				m_psAccessY[p] = g;
+				m_psAccessY[p] = int16_t(g);
 				// Remember you are in pointer arithmetic mode!!!!
-				m_ppslAccessY[p] = m_pGrid + int32_t(m_sGridW) * g;
+				m_ppslAccessY[p] = m_pGrid + m_lGridW * g;
 				}
 			}
 
@@ -303,7 +305,7 @@ void	CSmashatorium::Reset()
 	//----------------------------------------------------------------
 	// Go down the list of CSmashatoriumList's:
 	int32_t lCur;
-	for (lCur = 0; lCur < int32_t(m_sGridW) * m_sGridH; lCur++)
+	for (lCur = 0; lCur < m_lGridW * m_lGridH; lCur++)
 		{
 		CSmashatoriumList	*pCur = m_pGrid + lCur;
 		pCur->m_sNum = 0;
@@ -352,8 +354,8 @@ void CSmashatorium::QuickCheckReset(// Returns true if collision detected, false
 	// and one that's not...
 	if (pSmasher->m_sInGrid) // we KNOW it's fully clipped and of legal size...
 		{
-		if ( (lX <= -m_sTileW) || (lY < -m_sTileH) || 
-			(lX >= m_sWorldW) || (lY >= m_sWorldH) )
+		if ( (lX <= -m_lTileW) || (lY < -m_lTileH) || 
+			(lX >= m_lWorldW) || (lY >= m_lWorldH) )
 			{
 			// We have FULL CLIP OUT!
 			m_pSmasher = nullptr; // this search has ended!
@@ -386,8 +388,8 @@ void CSmashatorium::QuickCheckReset(// Returns true if collision detected, false
 	if (lX < 0) lX = 0;
 	if (lY < 0) lY = 0;
 
-	if (lX2 >= m_sWorldW) lX2 = m_sWorldW - 1;
-	if (lY2 >= m_sWorldH) lY2 = m_sWorldH - 1;
+	if (lX2 >= m_lWorldW) lX2 = m_lWorldW - 1;
+	if (lY2 >= m_lWorldH) lY2 = m_lWorldH - 1;
 	
 	if ( (lX2 <= lX) || (lY2 <= lY) )
 		{
@@ -457,7 +459,7 @@ CSmash *CSmashatorium::GetNextSmash()
 				{
 				m_sCurrentListX = 0;
 				m_sCurrentListY++;
-				m_pCurrentList += m_sGridW - m_sSearchW;
+				m_pCurrentList += m_lGridW - m_sSearchW;
 
 				if (m_sCurrentListY >= m_sSearchH) // You're DONE
 					{
@@ -562,8 +564,8 @@ bool CSmashatorium::QuickCheck(						// Returns true if collision detected, fals
 	// and one that's not...
 	if (pSmasher->m_sInGrid) // we KNOW it's fully clipped and of legal size...
 		{
-		if ( (lX <= -m_sTileW) || (lY < -m_sTileH) || 
-			(lX >= m_sWorldW) || (lY >= m_sWorldH) )
+		if ( (lX <= -m_lTileW) || (lY < -m_lTileH) || 
+			(lX >= m_lWorldW) || (lY >= m_lWorldH) )
 			{
 			// We have FULL CLIP OUT!
 			*ppSmashee = nullptr;
@@ -587,8 +589,8 @@ bool CSmashatorium::QuickCheck(						// Returns true if collision detected, fals
 		if (lX < 0) lX = 0;
 		if (lY < 0) lY = 0;
 
-		if (lX2 >= m_sWorldW) lX2 = m_sWorldW - 1;
-		if (lY2 >= m_sWorldH) lY2 = m_sWorldH - 1;
+		if (lX2 >= m_lWorldW) lX2 = m_lWorldW - 1;
+		if (lY2 >= m_lWorldH) lY2 = m_lWorldH - 1;
 		
 		if ( (lX2 <= lX) || (lY2 <= lY) )
 			{
@@ -605,7 +607,7 @@ bool CSmashatorium::QuickCheck(						// Returns true if collision detected, fals
 		}
 
 	// Do the search
-	for (j=0; j < sH; j++, pCurrentList += m_sGridW - sW)
+	for (j=0; j < sH; j++, pCurrentList += m_lGridW - sW)
 		{
 		for (i=0; i < sW; i++,pCurrentList++)
 			{
@@ -702,8 +704,8 @@ bool CSmashatorium::QuickCheckClosest(				// Returns true if collision detected,
 	// and one that's not...
 	if (pSmasher->m_sInGrid) // we KNOW it's fully clipped and of legal size...
 		{
-		if ( (lX <= -m_sTileW) || (lY < -m_sTileH) || 
-			(lX >= m_sWorldW) || (lY >= m_sWorldH) )
+		if ( (lX <= -m_lTileW) || (lY < -m_lTileH) || 
+			(lX >= m_lWorldW) || (lY >= m_lWorldH) )
 			{
 			// We have FULL CLIP OUT!
 			*ppSmashee = nullptr;
@@ -727,8 +729,8 @@ bool CSmashatorium::QuickCheckClosest(				// Returns true if collision detected,
 		if (lX < 0) lX = 0;
 		if (lY < 0) lY = 0;
 
-		if (lX2 >= m_sWorldW) lX2 = m_sWorldW - 1;
-		if (lY2 >= m_sWorldH) lY2 = m_sWorldH - 1;
+		if (lX2 >= m_lWorldW) lX2 = m_lWorldW - 1;
+		if (lY2 >= m_lWorldH) lY2 = m_lWorldH - 1;
 		
 		if ( (lX2 <= lX) || (lY2 <= lY) )
 			{
@@ -745,7 +747,7 @@ bool CSmashatorium::QuickCheckClosest(				// Returns true if collision detected,
 		}
 
 	// Do the search
-	for (j=0; j < sH; j++, pCurrentList += m_sGridW - sW)
+	for (j=0; j < sH; j++, pCurrentList += m_lGridW - sW)
 		{
 		for (i=0; i < sW; i++,pCurrentList++)
 			{
@@ -824,16 +826,16 @@ void	CSmashatorium::Debug()
 	// PURE DEBUGGING HELL!
 		FILE* fp = fopen("smashout.txt","w");
 
-		fprintf(fp,"GridW = %hd\nGridH = %hd\n",m_sGridW,m_sGridH);
+		fprintf(fp,"GridW = %d\nGridH = %d\n",m_lGridW,m_lGridH);
 		fprintf(fp,"# in smash = %hd;  # in each list:\n\n",m_sNumInSmash);
 
-		int16_t di,dj;
+		int32_t di,dj;
 
 		// Try direct grid access:
-		int16_t p = 0;
-		for (dj = 0; dj < m_sGridH; dj++)
+		int32_t p = 0;
+		for (dj = 0; dj < m_lGridH; dj++)
 			{
-			for (di = 0; di < m_sGridW; di++)
+			for (di = 0; di < m_lGridW; di++)
 				{
 				fprintf(fp,"%2hd ",m_pGrid[p++].m_sNum);
 				}
@@ -842,9 +844,9 @@ void	CSmashatorium::Debug()
 
 		fprintf(fp,"\n\n***********\n");
 		// Try Indirect Access
-		for (dj = 0; dj < m_sWorldH; dj+=m_sTileH)
+		for (dj = 0; dj < m_lWorldH; dj+=m_lTileH)
 			{
-			for (di = 0; di < m_sWorldW;di+=m_sTileW)
+			for (di = 0; di < m_lWorldW;di+=m_lTileW)
 				{
 				fprintf(fp,"%2hd ",(m_ppslClipY[dj] + m_psClipX[di])->m_sNum);
 				}
@@ -917,7 +919,7 @@ bool CSmashatorium::QuickCheckClosest(	// Returns true if collision detected, fa
 
 	// Check for horizontal clipping (easy)
 	int32_t	lClipLeft = lLeft;// = MAX(0,lLeft);
-	int32_t	lClipRight = lRight;// = MIN(m_sWorldW - 1,lRight);
+	int32_t	lClipRight = lRight;// = MIN(m_lWorldW - 1,lRight);
 	int32_t	lClipLeftY = lLeftY;
 	int32_t	lClipRightY = lRightY;
 
@@ -934,19 +936,19 @@ bool CSmashatorium::QuickCheckClosest(	// Returns true if collision detected, fa
 			lClipLeftY = lDet / lDelX; // ********** CAREFUL
 			}
 
-		if (lRight >= m_sWorldW)
+		if (lRight >= m_lWorldW)
 			{
-			lClipRight = m_sWorldW - 1;
+			lClipRight = m_lWorldW - 1;
 			lClipRightY = (lClipRight * lDelY + lDet) / lDelX;	// ******** CAREFUL!
 			}
 		}
 	else	// certical strip case:
 		{
-		if ( (lLeft < 0) || (lRight >= m_sWorldW) ) return false;
+		if ( (lLeft < 0) || (lRight >= m_lWorldW) ) return false;
 		}
 
  	// Check for case of reverse clip out:
-	if ( (lLeft >= m_sWorldW) || (lRight < 0) ) return false;	// clipped out!
+	if ( (lLeft >= m_lWorldW) || (lRight < 0) ) return false;	// clipped out!
 
 	lGridLeft = (int32_t)m_psClipX[lClipLeft];	// These represent pts BETWEEN grid squares
 	lGridRight = 1 + (int32_t)m_psClipX[lClipRight];
@@ -966,9 +968,9 @@ bool CSmashatorium::QuickCheckClosest(	// Returns true if collision detected, fa
 		// Clip Vertically
 		lGridRight = lGridLeft + 1;	// for compatibility
 		if (lClipRightY < 0) lClipRightY = 0;
-		if (lClipRightY >= m_sWorldH) lClipRightY = m_sWorldH;
+		if (lClipRightY >= m_lWorldH) lClipRightY = m_lWorldH;
 		if (lClipLeftY < 0) lClipLeftY = 0;
-		if (lClipLeftY >= m_sWorldH) lClipLeftY = m_sWorldH;
+		if (lClipLeftY >= m_lWorldH) lClipLeftY = m_lWorldH;
 		}
 
 	// ************************************************************************************
@@ -989,18 +991,18 @@ bool CSmashatorium::QuickCheckClosest(	// Returns true if collision detected, fa
 				lClipLeftY = 0;
 				lClipLeft = lDetY / lDelY; // ********** CAREFUL
 
-				if ( (lClipLeft < 0) || (lClipLeft >= m_sWorldW) ) return false;
+				if ( (lClipLeft < 0) || (lClipLeft >= m_lWorldW) ) return false;
 
 				lGridLeft = (int32_t)m_psClipX[lClipLeft];
 				sClippingY = true;
 				}
 
-			if (lClipRightY >= m_sWorldH)
+			if (lClipRightY >= m_lWorldH)
 				{
-				lClipRightY = m_sWorldH - 1;
+				lClipRightY = m_lWorldH - 1;
 				lClipRight = (lClipRightY * lDelX + lDetY) / lDelY;	// ******** CAREFUL!
 
-				if ( (lClipRight < 0) || (lClipRight >= m_sWorldW) ) return false;
+				if ( (lClipRight < 0) || (lClipRight >= m_lWorldW) ) return false;
 
 				lGridRight = 1 + (int32_t)m_psClipX[lClipRight];
 				sClippingY = true;
@@ -1025,15 +1027,15 @@ bool CSmashatorium::QuickCheckClosest(	// Returns true if collision detected, fa
 				// I was thinking with that fancy smancy ASSERT above.
 				//ASSERT(lClipRight >= 0);
 
-				if ( (lClipRight < 0) || (lClipRight >= m_sWorldW) ) return false;
+				if ( (lClipRight < 0) || (lClipRight >= m_lWorldW) ) return false;
 
 				lGridRight = 1 + (int32_t)m_psClipX[lClipRight];
 				sClippingY = true;
 				}
 
-			if (lClipLeftY >= m_sWorldH)
+			if (lClipLeftY >= m_lWorldH)
 				{
-				lClipLeftY = m_sWorldH - 1;
+				lClipLeftY = m_lWorldH - 1;
 				lClipLeft = (lClipLeftY * lDelX + lDetY) / lDelY;	// ******** CAREFUL!
 
 				// Since lDelY must be negative for us to get here,
@@ -1045,7 +1047,7 @@ bool CSmashatorium::QuickCheckClosest(	// Returns true if collision detected, fa
 
 				//ASSERT(lClipLeft >= 0);
 
-				if ( (lClipLeft < 0) || (lClipLeft >= m_sWorldW) ) return false;
+				if ( (lClipLeft < 0) || (lClipLeft >= m_lWorldW) ) return false;
 
 				lGridLeft = (int32_t)m_psClipX[lClipLeft];
 				sClippingY = true;
@@ -1063,17 +1065,26 @@ bool CSmashatorium::QuickCheckClosest(	// Returns true if collision detected, fa
 		}
 	else	// horizontal strip case:
 		{
-		if ( (lClipLeftY < 0) || (lClipLeftY >= m_sWorldH) ) return false;
+		if ( (lClipLeftY < 0) || (lClipLeftY >= m_lWorldH) ) return false;
 		}
 
 	// ************************************************************************************
 	// Calculate grid points for the line: (later, switch to clipped values)
 
-	// allocate on the stack a local point chart:
-#define MAX_GRID_W 1024	// ************************************ NEED TO DEAL WITH THIS!
-
-	int32_t	alPointsY[MAX_GRID_W + 1];
-	int16_t i,x;
+	// The point chart needs one entry per grid column.  It lives on the stack
+	// for normal sized realms and only goes to the heap for very wide ones,
+	// so concurrent searches never share it.
+#define MAX_STACK_GRID_W 1024
+	ASSERT(lGridRight <= m_lGridW);
+	int32_t	alStackPointsY[MAX_STACK_GRID_W + 1];
+	std::unique_ptr<int32_t[]>	upHeapPointsY;
+	int32_t*	alPointsY = alStackPointsY;
+	if (m_lGridW > MAX_STACK_GRID_W)
+		{
+		upHeapPointsY.reset(new int32_t[m_lGridW + 1]);
+		alPointsY = upHeapPointsY.get();
+		}
+	int32_t i,x;
 
 	// Get end points:
 	alPointsY[lGridLeft] = (int32_t)m_psClipY[lClipLeftY];
@@ -1086,9 +1097,9 @@ bool CSmashatorium::QuickCheckClosest(	// Returns true if collision detected, fa
 		{	// not vertical strip:
 
 		// Populate the point array:
-		x = lGridLeft * m_sTileW; // now using clip instead of access, which is one over
+		x = lGridLeft * m_lTileW; // now using clip instead of access, which is one over
 
-		for (i = lGridLeft + 1; i < lGridRight; i++, x += m_sTileW)
+		for (i = lGridLeft + 1; i < lGridRight; i++, x += m_lTileW)
 			{
 			alPointsY[i] = (x * lDelY + lDet) / lDelX; // WARNING - watch for lDelX
 			alPointsY[i] = (int32_t)m_psClipY[alPointsY[i]]; // convert to grid coordinates
@@ -1097,7 +1108,7 @@ bool CSmashatorium::QuickCheckClosest(	// Returns true if collision detected, fa
 
 	// ************************************************************************************
 	//  Move acros all the grid points crossed by the line, and process each Smash List!
-	int16_t j;
+	int32_t j;
 
 	// SPLIT between positive and negative cases:
 	int16_t sSignY = 1;
@@ -1125,11 +1136,11 @@ bool CSmashatorium::QuickCheckClosest(	// Returns true if collision detected, fa
 
 #endif
 			// Get the list:
-			ASSERT(j * m_sTileH < m_sWorldH + 2 * m_sTileH);
-			ASSERT(i * m_sTileW < m_sWorldW + 2 * m_sTileW);
-			ASSERT(j * m_sTileH >= 0);
-			ASSERT(i * m_sTileW >= 0);
-			CSmashatoriumList* pCurrentList = m_ppslAccessY[j * m_sTileH] + m_psAccessX[i * m_sTileW];
+			ASSERT(j * m_lTileH < m_lWorldH + 2 * m_lTileH);
+			ASSERT(i * m_lTileW < m_lWorldW + 2 * m_lTileW);
+			ASSERT(j * m_lTileH >= 0);
+			ASSERT(i * m_lTileW >= 0);
+			CSmashatoriumList* pCurrentList = m_ppslAccessY[j * m_lTileH] + m_psAccessX[i * m_lTileW];
 
 			// ***************************************************************************
 			// Now, process this smash grid in a standard loop like any other.
@@ -1283,7 +1294,7 @@ void CSmashatorium::Update(CSmash* pSmash)	// In:  CSmash to be updated
 	lY = pSphere->Z - lR;
 	
 	// Hook in the special case of a FAT body in the smash!
-	if ( (lD > m_sTileW) || (lD > m_sTileH) )
+	if ( (lD > m_lTileW) || (lD > m_lTileH) )
 		{
 		//================================================================== FAT SMASH
 		// Create and insert a fat smash into the smashatorium.
@@ -1310,8 +1321,8 @@ void CSmashatorium::Update(CSmash* pSmash)	// In:  CSmash to be updated
 			pFat->m_lY = lY;
 
 			// Find dimensions of smash and allocate:
-			pFat->m_sW = m_psAccessX[lD + m_sTileW - 1] + 1;	// min tiles + 1
-			pFat->m_sH = m_psAccessY[lD + m_sTileH - 1] + 1;	// min tiles + 1
+			pFat->m_sW = m_psAccessX[lD + m_lTileW - 1] + 1;	// min tiles + 1
+			pFat->m_sH = m_psAccessY[lD + m_lTileH - 1] + 1;	// min tiles + 1
 
 			pFat->m_sNumGrids = pFat->m_sW * pFat->m_sH;
 			if (pFat->Alloc(pFat->m_sNumGrids) != SUCCESS)
@@ -1332,7 +1343,7 @@ void CSmashatorium::Update(CSmash* pSmash)	// In:  CSmash to be updated
 		///////////////////////////////////
 		// (2) Catch the case of FULL clipping:
 		if ( (lX <= -lD) || (lY <= -lD) || 
-			(lX >= m_sWorldW) || (lY >= m_sWorldH) )
+			(lX >= m_lWorldW) || (lY >= m_lWorldH) )
 			{
 			// We have FULL CLIP OUT!
 			if (pSmash->m_sInGrid)	RemoveFat(pFat); // set's InGrid to false
@@ -1364,12 +1375,12 @@ void CSmashatorium::Update(CSmash* pSmash)	// In:  CSmash to be updated
 			// Because a fat smash should NOT be moving, we shouldn't be doing this 
 			// more than once!
 
-			int16_t sClipX = MAX((int32_t)0,lX);
-			int16_t sClipY = MAX((int32_t)0,lY);
-			int16_t sClipX2 = MIN((int32_t)m_sWorldW-1,lX + lD);
-			int16_t sClipY2 = MIN((int32_t)m_sWorldH-1,lY + lD);
+			int32_t lClipX = MAX((int32_t)0,lX);
+			int32_t lClipY = MAX((int32_t)0,lY);
+			int32_t lClipX2 = MIN(m_lWorldW-1,lX + lD);
+			int32_t lClipY2 = MIN(m_lWorldH-1,lY + lD);
 
-			pFat->m_pClippedGrid = m_ppslClipY[sClipY] + m_psClipX[sClipX];
+			pFat->m_pClippedGrid = m_ppslClipY[lClipY] + m_psClipX[lClipX];
 
 			// We can't access grid locations if lX and lY are negative!
 			int16_t sGridX,sGridY;
@@ -1380,10 +1391,10 @@ void CSmashatorium::Update(CSmash* pSmash)	// In:  CSmash to be updated
 			else	sGridY = m_psAccessX[lY];
 
 			// Convert to grid coordinates:
-			sClipX = m_psAccessX[sClipX];
-			sClipY = m_psAccessY[sClipY];
-			sClipX2 = m_psAccessX[sClipX2];
-			sClipY2 = m_psAccessY[sClipY2];
+			int16_t sClipX = m_psAccessX[lClipX];
+			int16_t sClipY = m_psAccessY[lClipY];
+			int16_t sClipX2 = m_psAccessX[lClipX2];
+			int16_t sClipY2 = m_psAccessY[lClipY2];
 
 			// Map to local fat smash:
 			// These are relative grid positions:
@@ -1405,8 +1416,8 @@ void CSmashatorium::Update(CSmash* pSmash)	// In:  CSmash to be updated
 
 	///////////////////////////////////
 	// (2) Catch the case of FULL clipping:
-	if ( (lX <= -m_sTileW) || (lY < -m_sTileH) || 
-		(lX >= m_sWorldW) || (lY >= m_sWorldH) )
+	if ( (lX <= -m_lTileW) || (lY < -m_lTileH) || 
+		(lX >= m_lWorldW) || (lY >= m_lWorldH) )
 		{
 		// We have FULL CLIP OUT!
 		if (pSmash->m_sInGrid)	Remove(pSmash); // set's InGrid to false
@@ -1458,9 +1469,9 @@ void	CSmashatorium::Add(CSmash* pSmash,CSmashatoriumList *pList)
 	pSmash->m_sInGrid = TRUE;
 
 	AddLimb(pList,&pSmash->m_link1);
-	AddLimb(pList + m_sGridW,&pSmash->m_link3);
+	AddLimb(pList + m_lGridW,&pSmash->m_link3);
 	AddLimb(++pList,&pSmash->m_link2);
-	AddLimb(pList + m_sGridW,&pSmash->m_link4);
+	AddLimb(pList + m_lGridW,&pSmash->m_link4);
 
 	m_sNumInSmash++;
 	if (m_sNumInSmash > m_sMaxNumInSmash) m_sMaxNumInSmash = m_sNumInSmash;
@@ -1488,7 +1499,7 @@ void	CSmashatorium::AddFat(CFatSmash* pFatSmash)
 	CSmashatoriumList*	pList = pFatSmash->m_pClippedGrid;	// assume not clipped out!
 	CSmashLink*	pLink = pFatSmash->m_pFirstLink;
 	//-------------------------------------
-	for (j=0; j < pFatSmash->m_sClipH; j++,pList += m_sGridW - pFatSmash->m_sClipW, 
+	for (j=0; j < pFatSmash->m_sClipH; j++,pList += m_lGridW - pFatSmash->m_sClipW, 
 													pLink += pFatSmash->m_sW - pFatSmash->m_sClipW)
 		{
 		for (i=0; i < pFatSmash->m_sClipW; i++,pList++,pLink++)
@@ -316,25 +316,25 @@ class CSmashatorium
 	{
 public:
 	//---------------------------------------------------------------------------
-	int16_t	m_sWorldW;	// for general logic
-	int16_t m_sWorldH;
-	int16_t m_sClipW;	// For clipping border
-	int16_t	m_sClipH;
-	int16_t	m_sGridW;	// NOT TileW -> this is the NUMBER of nodes!
-	int16_t m_sGridH;
-	int16_t m_sTileW;	// For catching size errors
-	int16_t m_sTileH;
+	int32_t	m_lWorldW;	// for general logic
+	int32_t m_lWorldH;
+	int32_t m_lClipW;	// For clipping border
+	int32_t	m_lClipH;
+	int32_t	m_lGridW;	// NOT TileW -> this is the NUMBER of nodes!
+	int32_t m_lGridH;
+	int32_t m_lTileW;	// For catching size errors
+	int32_t m_lTileH;
 
 	CSmashatoriumList	*m_pGrid; // actually a 2d array
 
 	//------------------- ACCESS VARIABLES:
-	int16_t	*m_psAccessX;	// m_sWorldW in size
-	int16_t *m_psAccessY;	// m_sWorldH in size
-	CSmashatoriumList **m_ppslAccessY;	// m_sWorldH in size
+	int16_t	*m_psAccessX;	// m_lWorldW in size
+	int16_t *m_psAccessY;	// m_lWorldH in size
+	CSmashatoriumList **m_ppslAccessY;	// m_lWorldH in size
 
-	int16_t	*m_psClipX;	// m_sWorldW + 2 Tiles in size
-	int16_t *m_psClipY;	// m_sWorldH + 2 Tiles in size
-	CSmashatoriumList **m_ppslClipY;	// m_sWorldH + 2 Tiles in size
+	int16_t	*m_psClipX;	// m_lWorldW + 2 Tiles in size
+	int16_t *m_psClipY;	// m_lWorldH + 2 Tiles in size
+	CSmashatoriumList **m_ppslClipY;	// m_lWorldH + 2 Tiles in size
 
 	//------------------- SEARCHING STATE INFORMATION: (QuickCheck info)
 	// This must also handle large regions!
@@ -369,8 +369,8 @@ public:
 	//---------------------------------------------------------------------------
 	void	Erase()	// does NOT deallocate anything!
 		{
-		m_sWorldW = m_sWorldH = m_sGridW = m_sGridH = 
-			m_sClipW = m_sClipH = m_sTileW = m_sTileH = 0;
+		m_lWorldW = m_lWorldH = m_lGridW = m_lGridH = 
+			m_lClipW = m_lClipH = m_lTileW = m_lTileH = 0;
 
 		m_psAccessX = m_psAccessY = m_psClipX = m_psClipY = nullptr;
 		m_pGrid = nullptr;
@@ -390,7 +390,7 @@ public:
 		Erase();
 		}
 
-	int16_t Alloc(int16_t sWorldW,int16_t sWorldH,int16_t sTileW,int16_t sTileH);
+	int16_t Alloc(int32_t lWorldW,int32_t lWorldH,int32_t lTileW,int32_t lTileH);
 
 	// Lower Level Inline!
 	// These are done multiple times for a true remove
@@ -542,7 +542,7 @@ public:
 
 		///////////////////////////////////
 		// (2) Catch the case of clipping:
-		if ( (x1 < 0) || (y1 < 0) || (x2 >= m_sWorldW) || (y2 >= m_sWorldH) )
+		if ( (x1 < 0) || (y1 < 0) || (x2 >= m_lWorldW) || (y2 >= m_lWorldH) )
 			{
 			// Handle partial clipping
 			ASSERT(0);
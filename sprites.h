@@ -37,7 +37,7 @@
 #define SPRITES_H
 
 
-#include <set>
+#include <vector>
 
 #include <RSPiX.h>
 
@@ -49,27 +49,11 @@
 // NOTE: While I wanted this to be within the CScene namespace, putting it there
 // created a circular dependancy between CScene and CSprite since they both
 // needed to use this.  It's now at global scope, which I hate, but it works.
-// Define a container of sprites.  A multiset allows for duplicates keys, which
-// is necessary because our sorting function might think of two sprites as being
-// the "same" as far as sorting goes.
+// Define a container of sprites.  Layers keep their sprites unsorted; the
+// scene sorts what it draws by priority each time it renders.
 class CSprite;	// Forward declaration
 
-// This is the function object used to sort the set of sprites.
-// It is a template NOT because we want to use it with other types
-// (after all, how many types will have a m_sZ member?!) but because
-// making it a template causes it to be "evaluated" by the compiler
-// AFTER the CSprite class is fully defined!  In other words, it's a
-// trick!
-template <class T>
-  struct SpriteLess : std::binary_function<T*, T*, bool>
-		{
-		bool operator()(const T* a, const T* b) const
-			{
-			return a->m_sPriority < b->m_sPriority;
-			}
-		};
-
-  typedef std::multiset<CSprite*, SpriteLess<CSprite>> msetSprites;
+  typedef std::vector<CSprite*> vecSprites;
 
 
 // A CSprite is a base class for sprites designed to work with CScene.
@@ -107,6 +91,7 @@ class CSprite
         uint32_t HighIntensity  : 1; // Set to use higher light intensities when
         uint32_t DeleteOnRender : 1; // After rendering object, delete it.
         uint32_t BlitOpaque     : 1; // Blit sprite opaque (currently only supported for 2D uncompressed, non-alpha objects).
+        uint32_t Static         : 1; // Set if it never moves or changes while in the scene (its pixels can be cached).
 
         inline void clear(void) { *reinterpret_cast<uint32_t*>(this) = 0; }
       } flags;
@@ -124,13 +109,24 @@ class CSprite
       bool m_InScene;
 		int16_t m_sSavedLayer;										// Sprite's saved layer (used to detect changes)
 		int16_t m_sSavedPriority;									// Sprite's saved priority (used to detect changes)
-		msetSprites::iterator m_iter;							// Sprite's iterator into layer's container
+		uint32_t m_ulLayerIndex;									// Sprite's index into layer's container
+		uint32_t m_ulSceneSeq;										// Order of insertion at its priority
+		void* m_pvTyped;												// This, as the class m_type says it is
+		int16_t m_sBoundX0;											// Screen bounds of sprite tree when
+		int16_t m_sBoundY0;											// last updated (for culling).
+		int16_t m_sBoundX1;
+		int16_t m_sBoundY1;
+		bool m_bBinned;												// true, if in its layer's culling bins
+		uint32_t m_ulCullStamp;										// Last culled Render() that collected it
 
 	public:
 		CSprite()
 			{
         flags.clear();
         m_InScene = false;
+        m_bBinned = false;
+        m_ulCullStamp = 0;
+        m_pvTyped = nullptr;
 
 			m_sX2		= 0;		// Any sprite's 2D dest x coord.
 			m_sY2		= 0;		// Any sprite's 2D dest y coord.
@@ -233,6 +229,15 @@ class CSprite
 			return m_type;
 			}
 
+		// Get this sprite as the class its type says it is, without RTTI (the
+		// virtual CSprite base rules out a static_cast).  T must match the type.
+		template <class T>
+		T* GetTyped(void)
+			{
+			ASSERT(m_pvTyped != nullptr);
+			return static_cast<T*>(m_pvTyped);
+			}
+
 	};
 
 // A CSprite2 is a 2d sprite designed to work with CScene.
@@ -253,6 +258,7 @@ class CSprite2 : virtual public CSprite
 		m_pimAlpha		= nullptr;
       m_sAlphaLevel	= UINT8_MAX;
 		m_type			= Standard2d;
+		m_pvTyped		= this;
 		}
 
    virtual ~CSprite2(void) noexcept { }
@@ -270,6 +276,7 @@ class CSpriteLine2d : virtual public CSprite
    CSpriteLine2d(void) noexcept
 		{
 		m_type			= Line2d;
+		m_pvTyped		= this;
 		}
 
    virtual ~CSpriteLine2d(void) noexcept { }
@@ -286,6 +293,7 @@ class CSpriteCylinder3d : virtual public CSprite
    CSpriteCylinder3d(void) noexcept
 		{
 		m_type			= Cylinder3d;
+		m_pvTyped		= this;
 		}
 
     virtual ~CSpriteCylinder3d(void) noexcept { }
@@ -326,6 +334,7 @@ class CSprite3 : virtual public CSprite
 												// sphere.                                   
 										
 			m_type			= Standard3d;
+			m_pvTyped		= this;
 			}
 
 	public:
@@ -450,7 +450,7 @@ void CWarp::EditRender(void)
   m_sY2	-= m_pImage->m_sHeight;
 
   // Layer should be based on info we get from attribute map.
-  m_sLayer = CRealm::GetLayerViaAttrib(realm()->GetLayer((int16_t) position.x, (int16_t) position.z));
+  m_sLayer = CRealm::GetLayerViaAttrib(realm()->GetLayer((int32_t) position.x, (int32_t) position.z));
 
   // Update sprite in scene
   Object::enqueue(SpriteUpdate);
@@ -246,7 +246,7 @@ void CWeapon::Render(void)
    if (m_spriteShadow.m_pImage && !flags.Hidden)
 	{
 		// Get the height of the terrain from the attribute map
-      int16_t sY = realm()->GetHeight((int16_t) position.x, (int16_t) position.z);
+      int16_t sY = realm()->GetHeight((int32_t) position.x, (int32_t) position.z);
 		// Map from 3d to 2d coords
       realm()->Map3Dto2D(position.x, double(sY), position.z,
                          m_spriteShadow.m_sX2, m_spriteShadow.m_sY2);